@@ -0,0 +1,527 @@
+#include "secs2/secs2.h"
+#include "secs2/batch.h"
+#include "secs2/encoded.h"
+#include "secs2/hash.h"
+#include "secs2/lazy_list.h"
+#include "secs2/parallel.h"
+#include "secs2/schema.h"
+#include "secs2/template.h"
+#include "secs2/writer.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#ifdef SECS2_USE_PMR
+#include <memory_resource>
+#endif
+
+using namespace secs2;
+
+namespace {
+
+//! The number of allocations made through the global @p operator new.
+std::atomic<std::size_t> alloc_count {0};
+
+}  // namespace
+
+void* operator new(const std::size_t size) {
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if (const auto ptr {std::malloc(size != 0 ? size : 1)}) {
+        return ptr;
+    } else {
+        throw std::bad_alloc {};
+    }
+}
+
+void operator delete(void* const ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* const ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void* operator new(const std::size_t size, const std::align_val_t align) {
+    alloc_count.fetch_add(1, std::memory_order_relaxed);
+    const auto alignment {static_cast<std::size_t>(align)};
+    const auto aligned_size {(size + alignment - 1) / alignment * alignment};
+    if (const auto ptr {std::aligned_alloc(
+            alignment, aligned_size != 0 ? aligned_size : alignment)}) {
+        return ptr;
+    } else {
+        throw std::bad_alloc {};
+    }
+}
+
+void operator delete(void* const ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* const ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+namespace {
+
+//! A flat numeric item with 4096 elements.
+template <typename T>
+Message MakeNumericMsg() {
+    T nums(4096);
+    std::iota(nums.begin(), nums.end(), 0);
+    return Message {std::move(nums)};
+}
+
+//! Lists nested 64 levels deep, each with a small item.
+Message MakeNestedListMsg() {
+    List list;
+    list.push_back(U4 {0});
+    for (std::size_t i {1}; i != 64; ++i) {
+        List parent;
+        parent.push_back(U4 {static_cast<std::uint32_t>(i)});
+        parent.push_back(std::move(list));
+        list = std::move(parent);
+    }
+    return Message {std::move(list)};
+}
+
+//! A list of 1000 short ASCII items.
+Message MakeAsciiItemsMsg() {
+    List list;
+    for (std::size_t i {0}; i != 1000; ++i) {
+        list.push_back(ASCII {"SV" + std::to_string(100000 + i)});
+    }
+    return Message {std::move(list)};
+}
+
+/**
+ * @brief An event report send (S6F11) shaped message.
+ *
+ * ```
+ * <L [3]
+ *     <U4 DATAID>
+ *     <U4 CEID>
+ *     <L [10]
+ *         <L [2]
+ *             <U4 RPTID>
+ *             <L [20] <U4 SV> <F8 SV> <A SV> <Boolean SV> ...>
+ *         >
+ *         ...
+ *     >
+ * >
+ * ```
+ */
+Message MakeEventReportMsg() {
+    List reports;
+    for (std::uint32_t rpt_id {0}; rpt_id != 10; ++rpt_id) {
+        List vals;
+        for (std::size_t i {0}; i != 5; ++i) {
+            vals.push_back(U4 {static_cast<std::uint32_t>(rpt_id * 100 + i)});
+            vals.push_back(F8 {static_cast<double>(i) * 0.5});
+            vals.push_back(ASCII {"LOT-2026-" + std::to_string(i)});
+            vals.push_back(Boolean {i % 2 == 0});
+        }
+
+        List report;
+        report.push_back(U4 {rpt_id});
+        report.push_back(std::move(vals));
+        reports.push_back(std::move(report));
+    }
+
+    List msg;
+    msg.push_back(U4 {1});
+    msg.push_back(U4 {4001});
+    msg.push_back(std::move(reports));
+    return Message {std::move(msg)};
+}
+
+/**
+ * @brief A process program send (S7F3) shaped message.
+ *
+ * ```
+ * <L [2]
+ *     <A PPID>
+ *     <B PPBODY>
+ * >
+ * ```
+ */
+Message MakeProcessProgramMsg() {
+    Binary body(64 * 1024);
+    for (std::size_t i {0}; i != body.size(); ++i) {
+        body[i] = static_cast<std::byte>(i * 31);
+    }
+
+    List msg;
+    msg.push_back(ASCII {"RECIPE-ETCH-0042"});
+    msg.push_back(std::move(body));
+    return Message {std::move(msg)};
+}
+
+//! Small replies, such as S1F2, S2F42 and S6F12, sent in one scheduling tick.
+std::vector<Message> MakeReplyMsgs() {
+    std::vector<Message> msgs;
+    for (std::size_t i {0}; i != 256; ++i) {
+        switch (i % 3) {
+            case 0: {
+                List list;
+                list.push_back(ASCII {"MDLN-01"});
+                list.push_back(ASCII {"SOFTREV-1.0"});
+                msgs.emplace_back(std::move(list));
+                break;
+            }
+            case 1: {
+                List list;
+                list.push_back(Binary {std::byte {0}});
+                list.push_back(List {});
+                msgs.emplace_back(std::move(list));
+                break;
+            }
+            default: {
+                msgs.emplace_back(Binary {std::byte {0}});
+                break;
+            }
+        }
+    }
+    return msgs;
+}
+
+//! Report throughput and allocations per operation.
+void SetCounters(benchmark::State& state, const std::size_t byte_size,
+                 const std::size_t allocs) {
+    const auto iters {static_cast<std::int64_t>(state.iterations())};
+    state.SetBytesProcessed(iters * static_cast<std::int64_t>(byte_size));
+    state.counters["msgs/s"] = benchmark::Counter(
+        static_cast<double>(iters), benchmark::Counter::kIsRate);
+    state.counters["allocs/op"] = benchmark::Counter(
+        static_cast<double>(allocs), benchmark::Counter::kAvgIterations);
+}
+
+void BM_ToBytes(benchmark::State& state, const Message& msg) {
+    const auto byte_size {msg.GetEncodedSize().value_or(0)};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto bytes {msg.ToBytes()};
+        benchmark::DoNotOptimize(bytes);
+    }
+    SetCounters(state, byte_size, alloc_count.load() - init_alloc_count);
+}
+
+void BM_BuildMsgFromBytes(benchmark::State& state, const Message& msg) {
+    const auto bytes {msg.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto loaded {BuildMsgFromBytes(bytes)};
+        benchmark::DoNotOptimize(loaded);
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+
+void BM_LazyListNext(benchmark::State& state, const Message& msg) {
+    const auto bytes {msg.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto list {LazyList::BuildFromBytes(bytes)};
+        for (auto& elem : *list) {
+            benchmark::DoNotOptimize(elem);
+        }
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+
+void BM_Validate(benchmark::State& state, const Message& msg) {
+    const auto bytes {msg.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto byte_size {Message::Validate(bytes)};
+        benchmark::DoNotOptimize(byte_size);
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+
+#ifdef SECS2_USE_PMR
+void BM_BuildMsgFromBytesArena(benchmark::State& state, const Message& msg) {
+    const auto bytes {msg.ToBytes().value_or(std::vector<std::byte> {})};
+    std::pmr::monotonic_buffer_resource arena;
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        {
+            auto loaded {BuildMsgFromBytes(bytes, &arena)};
+            benchmark::DoNotOptimize(loaded);
+        }
+        arena.release();
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+#endif
+
+void BM_ToSml(benchmark::State& state, const Message& msg) {
+    const auto byte_size {msg.GetEncodedSize().value_or(0)};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto sml {msg.ToSml()};
+        benchmark::DoNotOptimize(sml);
+    }
+    SetCounters(state, byte_size, alloc_count.load() - init_alloc_count);
+}
+
+void BM_BuildSmlFromBytes(benchmark::State& state, const Message& msg) {
+    const auto bytes {msg.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto sml {BuildSmlFromBytes(bytes)};
+        benchmark::DoNotOptimize(sml);
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+
+void BM_ToBytesEach(benchmark::State& state) {
+    const auto msgs {MakeReplyMsgs()};
+    const auto batch {EncodeBatch(msgs).value_or(EncodedBatch {})};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        for (const auto& msg : msgs) {
+            auto bytes {msg.ToBytes()};
+            benchmark::DoNotOptimize(bytes);
+        }
+    }
+    SetCounters(state, batch.bytes.size(),
+                alloc_count.load() - init_alloc_count);
+}
+
+void BM_EncodeBatchInto(benchmark::State& state) {
+    const auto msgs {MakeReplyMsgs()};
+    EncodedBatch batch;
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto byte_size {EncodeBatchInto(msgs, batch)};
+        benchmark::DoNotOptimize(byte_size);
+    }
+    SetCounters(state, batch.bytes.size(),
+                alloc_count.load() - init_alloc_count);
+}
+
+void BM_DecodeBatchInto(benchmark::State& state) {
+    const auto batch {EncodeBatch(MakeReplyMsgs()).value_or(EncodedBatch {})};
+    std::vector<Message> msgs;
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        msgs.clear();
+        auto byte_size {DecodeBatchInto(batch.bytes, msgs)};
+        benchmark::DoNotOptimize(byte_size);
+    }
+    SetCounters(state, batch.bytes.size(),
+                alloc_count.load() - init_alloc_count);
+}
+
+//! A list of 4096 reports, each with a few items.
+Message MakeLargeListMsg() {
+    List list;
+    for (std::uint32_t i {0}; i != 4096; ++i) {
+        List report;
+        report.push_back(U4 {i});
+        report.push_back(F8(16, 0.5));
+        report.push_back(ASCII {"LOT-2026-" + std::to_string(i)});
+        list.push_back(std::move(report));
+    }
+    return Message {std::move(list)};
+}
+
+void BM_EncodeParallel(benchmark::State& state, const Message& msg) {
+    ThreadPool pool {static_cast<std::size_t>(state.range(0))};
+    const Executor exec {std::ref(pool)};
+    const auto byte_size {msg.GetEncodedSize().value_or(0)};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto bytes {EncodeParallel(msg, exec)};
+        benchmark::DoNotOptimize(bytes);
+    }
+    SetCounters(state, byte_size, alloc_count.load() - init_alloc_count);
+}
+
+void BM_DecodeParallel(benchmark::State& state, const Message& msg) {
+    ThreadPool pool {static_cast<std::size_t>(state.range(0))};
+    const Executor exec {std::ref(pool)};
+    const auto bytes {msg.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto loaded {DecodeParallel(bytes, exec)};
+        benchmark::DoNotOptimize(loaded);
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+
+//! Build the same message as @ref MakeLargeListMsg and serialize it.
+void BM_BuildAndToBytes(benchmark::State& state) {
+    const auto byte_size {MakeLargeListMsg().GetEncodedSize().value_or(0)};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto bytes {MakeLargeListMsg().ToBytes()};
+        benchmark::DoNotOptimize(bytes);
+    }
+    SetCounters(state, byte_size, alloc_count.load() - init_alloc_count);
+}
+
+//! Write the same bytes as @ref MakeLargeListMsg without building a message.
+void BM_MessageWriter(benchmark::State& state) {
+    const std::vector<double> vals(16, 0.5);
+    std::vector<std::byte> bytes;
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        bytes.clear();
+        MessageWriter writer {bytes};
+        writer.BeginList(4096);
+        for (std::uint32_t i {0}; i != 4096; ++i) {
+            writer.BeginList(3)
+                .WriteU4(i)
+                .WriteF8(vals)
+                .WriteAscii("LOT-2026-" + std::to_string(i))
+                .EndList();
+        }
+        auto byte_size {writer.EndList().Finish()};
+        benchmark::DoNotOptimize(byte_size);
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+
+//! The schema of @ref MakeLargeListMsg.
+using LargeListSchema = Schema<
+    schema::ListOf<schema::L<schema::Scalar<U4>, schema::Array<F8>, schema::A>>>;
+
+void BM_SchemaToBytes(benchmark::State& state) {
+    const auto bytes {
+        MakeLargeListMsg().ToBytes().value_or(std::vector<std::byte> {})};
+    const auto loaded {LargeListSchema::BuildFromBytes(bytes)};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto encoded {LargeListSchema::ToBytes(loaded->first)};
+        benchmark::DoNotOptimize(encoded);
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+
+void BM_SchemaBuildFromBytes(benchmark::State& state) {
+    const auto bytes {
+        MakeLargeListMsg().ToBytes().value_or(std::vector<std::byte> {})};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto loaded {LargeListSchema::BuildFromBytes(bytes)};
+        benchmark::DoNotOptimize(loaded);
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+
+//! Fill the IDs and a value of @ref MakeEventReportMsg and copy the bytes.
+void BM_TemplateFill(benchmark::State& state) {
+    auto tmpl {MessageTemplate::Build(MakeEventReportMsg())};
+    const auto data_id {tmpl->AddSlot({0})};
+    const auto ceid {tmpl->AddSlot({1})};
+    const auto val {tmpl->AddSlot({2, 0, 1, 0})};
+    std::vector<std::byte> bytes;
+    const auto init_alloc_count {alloc_count.load()};
+    std::uint32_t id {0};
+    for (auto _ : state) {
+        tmpl->Fill<U4>(*data_id, id++);
+        tmpl->Fill<U4>(*ceid, 4001);
+        tmpl->Fill<U4>(*val, id);
+        bytes.assign(tmpl->GetBytes().begin(), tmpl->GetBytes().end());
+        benchmark::DoNotOptimize(bytes);
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+
+void BM_EncodedMessageToBytes(benchmark::State& state, const Message& msg) {
+    const EncodedMessage encoded {msg};
+    const auto byte_size {encoded.GetEncodedSize().value_or(0)};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto bytes {encoded.ToBytes()};
+        benchmark::DoNotOptimize(bytes);
+    }
+    SetCounters(state, byte_size, alloc_count.load() - init_alloc_count);
+}
+
+void BM_HashMsg(benchmark::State& state, const Message& msg) {
+    const auto byte_size {msg.GetEncodedSize().value_or(0)};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto hash {HashMsg(msg)};
+        benchmark::DoNotOptimize(hash);
+    }
+    SetCounters(state, byte_size, alloc_count.load() - init_alloc_count);
+}
+
+void BM_HashMsgBytes(benchmark::State& state, const Message& msg) {
+    const auto bytes {msg.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto init_alloc_count {alloc_count.load()};
+    for (auto _ : state) {
+        auto hash {HashMsgBytes(bytes)};
+        benchmark::DoNotOptimize(hash);
+    }
+    SetCounters(state, bytes.size(), alloc_count.load() - init_alloc_count);
+}
+
+}  // namespace
+
+BENCHMARK(BM_TemplateFill);
+BENCHMARK_CAPTURE(BM_ToBytes, LargeList, MakeLargeListMsg());
+BENCHMARK_CAPTURE(BM_EncodedMessageToBytes, LargeList, MakeLargeListMsg());
+BENCHMARK_CAPTURE(BM_BuildMsgFromBytes, LargeList, MakeLargeListMsg());
+BENCHMARK_CAPTURE(BM_LazyListNext, LargeList, MakeLargeListMsg());
+BENCHMARK_CAPTURE(BM_HashMsg, LargeList, MakeLargeListMsg());
+BENCHMARK_CAPTURE(BM_HashMsgBytes, LargeList, MakeLargeListMsg());
+BENCHMARK(BM_SchemaToBytes);
+BENCHMARK(BM_SchemaBuildFromBytes);
+BENCHMARK(BM_BuildAndToBytes);
+BENCHMARK(BM_MessageWriter);
+
+BENCHMARK_CAPTURE(BM_EncodeParallel, LargeList, MakeLargeListMsg())
+    ->Arg(0)
+    ->Arg(3)
+    ->UseRealTime();
+BENCHMARK_CAPTURE(BM_DecodeParallel, LargeList, MakeLargeListMsg())
+    ->Arg(0)
+    ->Arg(3)
+    ->UseRealTime();
+
+BENCHMARK(BM_ToBytesEach);
+BENCHMARK(BM_EncodeBatchInto);
+BENCHMARK(BM_DecodeBatchInto);
+
+#ifdef SECS2_USE_PMR
+#define BENCHMARK_CORPUS_DECODE_ARENA(name, msg)                               \
+    BENCHMARK_CAPTURE(BM_BuildMsgFromBytesArena, name, msg);
+#else
+#define BENCHMARK_CORPUS_DECODE_ARENA(name, msg)
+#endif
+
+//! Benchmark every path over a corpus.
+#define BENCHMARK_CORPUS(name, msg)                                            \
+    BENCHMARK_CAPTURE(BM_ToBytes, name, msg);                                  \
+    BENCHMARK_CAPTURE(BM_BuildMsgFromBytes, name, msg);                        \
+    BENCHMARK_CORPUS_DECODE_ARENA(name, msg)                                   \
+    BENCHMARK_CAPTURE(BM_Validate, name, msg);                                 \
+    BENCHMARK_CAPTURE(BM_ToSml, name, msg);                                    \
+    BENCHMARK_CAPTURE(BM_BuildSmlFromBytes, name, msg);
+
+BENCHMARK_CORPUS(I1, MakeNumericMsg<I1>())
+BENCHMARK_CORPUS(I2, MakeNumericMsg<I2>())
+BENCHMARK_CORPUS(I4, MakeNumericMsg<I4>())
+BENCHMARK_CORPUS(I8, MakeNumericMsg<I8>())
+BENCHMARK_CORPUS(U1, MakeNumericMsg<U1>())
+BENCHMARK_CORPUS(U2, MakeNumericMsg<U2>())
+BENCHMARK_CORPUS(U4, MakeNumericMsg<U4>())
+BENCHMARK_CORPUS(U8, MakeNumericMsg<U8>())
+BENCHMARK_CORPUS(F4, MakeNumericMsg<F4>())
+BENCHMARK_CORPUS(F8, MakeNumericMsg<F8>())
+BENCHMARK_CORPUS(NestedList, MakeNestedListMsg())
+BENCHMARK_CORPUS(AsciiItems, MakeAsciiItemsMsg())
+BENCHMARK_CORPUS(S6F11, MakeEventReportMsg())
+BENCHMARK_CORPUS(S7F3, MakeProcessProgramMsg())
+
+BENCHMARK_MAIN();
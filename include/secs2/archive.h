@@ -0,0 +1,235 @@
+/**
+ * @file archive.h
+ * @brief Append-only files of SECS-II messages that are read through memory mapping.
+ *
+ * @details
+ * An archive starts with a file header, followed by records.
+ * All integers are big-endian.
+ *
+ * ```
+ * ┌──────────────────────────┐
+ * │ Magic "S2AR" (4 bytes)   │
+ * ├──────────────────────────┤
+ * │ Version (4 bytes)        │
+ * ├──────────────────────────┤
+ * │ Record 1                 │
+ * │ ┌──────────────────────┐ │
+ * │ │ Size (4 bytes)       │ │
+ * │ ├──────────────────────┤ │
+ * │ │ Tag (4 bytes)        │ │
+ * │ ├──────────────────────┤ │
+ * │ │ Timestamp (8 bytes)  │ │
+ * │ ├──────────────────────┤ │
+ * │ │ Message (Size bytes) │ │
+ * │ └──────────────────────┘ │
+ * ├──────────────────────────┤
+ * │ Record 2 ...             │
+ * └──────────────────────────┘
+ * ```
+ *
+ * @note It is only available on POSIX systems.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "secs2.h"
+#include "view.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace secs2 {
+
+//! Information stored with each message in an archive.
+struct RecordMetadata {
+    //! A user-defined tag, such as the stream and function of the message.
+    std::uint32_t tag {0};
+
+    //! A user-defined timestamp, such as the nanoseconds since the Unix epoch.
+    std::uint64_t timestamp {0};
+
+    //! Equality comparison between two metadata.
+    bool operator==(const RecordMetadata&) const noexcept = default;
+};
+
+//! A message stored in an archive.
+struct ArchiveRecord {
+    RecordMetadata meta;
+
+    //! The serialized message, which refers to the mapped archive.
+    std::span<const std::byte> bytes;
+};
+
+/**
+ * @brief A writer appending messages to the end of an archive.
+ *
+ * @details
+ * Records are collected in a buffer and written to the file in large chunks.
+ * They are only visible to readers after @ref Flush.
+ *
+ * ```c++
+ * auto writer {ArchiveWriter::Open("msgs.s2ar")};
+ * writer->Append(msg, {.tag = 0x0101});
+ * writer->Flush();
+ * ```
+ */
+class ArchiveWriter {
+public:
+    //! The size of the buffer after which records are written to the file.
+    static constexpr std::size_t flush_size {1 << 16};
+
+    /**
+     * @brief Open an archive for appending, or create it if it does not exist.
+     *
+     * @return
+     * The writer if successful, otherwise a pair with an error code and a descriptive error message.
+     * - A system error if the file cannot be opened, read or truncated.
+     * - @p std::errc::argument_out_of_domain: The file is not an archive.
+     *
+     * @note
+     * A record torn by an interrupted write, such as a crash during @ref Flush,
+     * is truncated from the end of the file, so new records can be framed.
+     * A file holding only part of the file header is treated as empty.
+     */
+    static std::expected<ArchiveWriter, Error> Open(
+        const std::filesystem::path& path) noexcept;
+
+    ArchiveWriter(ArchiveWriter&&) noexcept;
+
+    ArchiveWriter& operator=(ArchiveWriter&&) noexcept;
+
+    ArchiveWriter(const ArchiveWriter&) = delete;
+
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    //! Flush buffered records and close the file.
+    ~ArchiveWriter() noexcept;
+
+    /**
+     * @brief Serialize a message and append it to the archive.
+     *
+     * @return
+     * Nothing if successful. Otherwise a pair with an error code and a descriptive error message.
+     * - @p std::errc::value_too_large: The length exceeds @ref Message::max_length.
+     * - A system error if buffered records cannot be written.
+     */
+    std::expected<void, Error> Append(const Message& msg,
+                                      const RecordMetadata& meta = {}) noexcept;
+
+    /**
+     * @brief Append a serialized message to the archive.
+     *
+     * @param bytes A buffer starting from a message.
+     * @return The same errors as @ref Message::Validate or a system error.
+     */
+    std::expected<void, Error> Append(std::span<const std::byte> bytes,
+                                      const RecordMetadata& meta = {}) noexcept;
+
+    /**
+     * @brief Write buffered records to the file.
+     *
+     * @return Nothing if successful, otherwise a system error.
+     */
+    std::expected<void, Error> Flush() noexcept;
+
+private:
+    explicit ArchiveWriter(int fd) noexcept;
+
+    //! Reserve a record in the buffer and return the space for the message.
+    std::span<std::byte> AddRecord(std::size_t size,
+                                   const RecordMetadata& meta) noexcept;
+
+    //! Close the file if it is open.
+    void Close() noexcept;
+
+    int fd_ {-1};
+    std::vector<std::byte> buf_;
+};
+
+/**
+ * @brief A read-only archive mapped into memory.
+ *
+ * @details
+ * The offsets of records are indexed when the archive is opened by reading their headers only.
+ * Records can then be accessed randomly without copying,
+ * and concurrently from multiple threads, such as with an @ref Executor.
+ *
+ * ```c++
+ * const auto archive {MessageArchive::Open("msgs.s2ar")};
+ * for (std::size_t i {0}; i != archive->GetCount(); ++i) {
+ *     const auto view {archive->GetView(i)};
+ * }
+ * ```
+ */
+class MessageArchive {
+public:
+    /**
+     * @brief Map an archive into memory and index its records.
+     *
+     * @return
+     * The archive if successful, otherwise a pair with an error code and a descriptive error message.
+     * - A system error if the file cannot be opened or mapped.
+     * - @p std::errc::argument_out_of_domain: The file is not an archive.
+     *
+     * @note
+     * Records are indexed up to the last complete one.
+     * An incomplete record at the end is reported by @ref GetTornSize,
+     * as is a file holding only part of the file header.
+     */
+    static std::expected<MessageArchive, Error> Open(
+        const std::filesystem::path& path) noexcept;
+
+    MessageArchive(MessageArchive&&) noexcept;
+
+    MessageArchive& operator=(MessageArchive&&) noexcept;
+
+    MessageArchive(const MessageArchive&) = delete;
+
+    MessageArchive& operator=(const MessageArchive&) = delete;
+
+    //! Unmap the archive, after which no record can be used.
+    ~MessageArchive() noexcept;
+
+    //! Get the number of records.
+    std::size_t GetCount() const noexcept;
+
+    //! Get the size of the incomplete record after the last complete one.
+    std::size_t GetTornSize() const noexcept;
+
+    //! Get a record without checking its message.
+    ArchiveRecord GetRecord(std::size_t idx) const noexcept;
+
+    /**
+     * @brief Get a view of the message of a record without decoding it.
+     *
+     * @return The same as @ref MessageView::BuildFromBytes.
+     */
+    std::expected<MessageView, Error> GetView(std::size_t idx) const noexcept;
+
+private:
+    MessageArchive(const std::byte* data, std::size_t size,
+                   std::vector<std::size_t> offsets) noexcept;
+
+    //! Unmap the archive if it is mapped.
+    void Unmap() noexcept;
+
+    const std::byte* data_ {nullptr};
+    std::size_t size_ {0};
+    //! The offset of each record from the beginning of the archive.
+    std::vector<std::size_t> offsets_;
+    //! The size of the incomplete bytes at the end of the archive.
+    std::size_t torn_size_ {0};
+};
+
+}  // namespace secs2
@@ -0,0 +1,110 @@
+/**
+ * @file batch.h
+ * @brief Serialization and deserialization of many SECS-II messages at once.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <vector>
+
+#ifdef SECS2_USE_PMR
+#include <memory_resource>
+#endif
+
+namespace secs2 {
+
+//! Serialized messages stored back-to-back in a single buffer.
+struct EncodedBatch {
+    //! Get the number of messages.
+    std::size_t GetCount() const noexcept;
+
+    //! Get the bytes of a message.
+    std::span<const std::byte> GetMsgBytes(std::size_t idx) const noexcept;
+
+    //! The bytes of all messages.
+    std::vector<std::byte> bytes;
+
+    //! The offset of each message in @ref bytes.
+    std::vector<std::size_t> offsets;
+};
+
+/**
+ * @brief Serialize messages into a single buffer.
+ *
+ * @details
+ * The encoded sizes of all messages are calculated first,
+ * so the buffer and the offset table are allocated only once.
+ *
+ * @return
+ * The serialized messages if successful.
+ * Otherwise @p std::errc::value_too_large if the length of any message exceeds @ref Message::max_length.
+ */
+std::expected<EncodedBatch, Error> EncodeBatch(
+    std::span<const Message> msgs) noexcept;
+
+/**
+ * @brief Serialize messages into an existing batch.
+ *
+ * @details
+ * The previous content of the batch is replaced while its memory is reused,
+ * so encoding batches of similar sizes repeatedly does not allocate memory.
+ *
+ * @return
+ * The number of bytes written if successful, otherwise the same errors as @ref EncodeBatch.
+ * The batch is left empty if failed.
+ */
+std::expected<std::size_t, Error> EncodeBatchInto(std::span<const Message> msgs,
+                                                  EncodedBatch& batch) noexcept;
+
+/**
+ * @brief Deserialize back-to-back messages until the end of a buffer.
+ *
+ * @param opts Limits applied to each message.
+ * @return
+ * The deserialized messages if successful.
+ * Otherwise the same errors as @ref Message::BuildFromBytes for the first invalid message,
+ * including @p std::errc::message_size if the buffer ends in the middle of a message.
+ */
+std::expected<std::vector<Message>, Error> DecodeBatch(
+    std::span<const std::byte> bytes, const DecodeOptions& opts = {}) noexcept;
+
+/**
+ * @brief Deserialize back-to-back messages and append them to an existing vector.
+ *
+ * @return
+ * The number of bytes consumed if successful, otherwise the same errors as @ref DecodeBatch.
+ * The vector is left unchanged if failed.
+ */
+std::expected<std::size_t, Error> DecodeBatchInto(
+    std::span<const std::byte> bytes, std::vector<Message>& msgs,
+    const DecodeOptions& opts = {}) noexcept;
+
+#ifdef SECS2_USE_PMR
+/**
+ * @brief Deserialize back-to-back messages into a memory resource.
+ *
+ * @details
+ * All containers of the messages are allocated from @p resource,
+ * which must outlive the messages.
+ *
+ * @return The same as the overload without a memory resource.
+ */
+std::expected<std::size_t, Error> DecodeBatchInto(
+    std::span<const std::byte> bytes, std::vector<Message>& msgs,
+    std::pmr::memory_resource* resource,
+    const DecodeOptions& opts = {}) noexcept;
+#endif
+
+}  // namespace secs2
@@ -0,0 +1,164 @@
+/**
+ * @file codec.h
+ * @brief Constant-evaluated primitives of the SECS-II byte format shared by all encoders and decoders.
+ *
+ * @details
+ * The library, compile-time schemas and templates use these helpers,
+ * so the layout of headers and big-endian values is defined in one place.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <type_traits>
+
+namespace secs2::codec {
+
+//! The header of a serialized item or list.
+struct Header {
+    //! The format code.
+    Type type {Type::Unknown};
+
+    /**
+     * @brief The length.
+     *
+     * @details
+     * - For an item, it is the number of bytes.
+     * - For an list, it is the number of direct elements.
+     */
+    std::size_t len {0};
+
+    //! The size of the format byte and length bytes.
+    std::size_t size {0};
+};
+
+/**
+ * @brief Calculate the size of a header, including the format byte and length bytes.
+ *
+ * @return The size of the header, or @p std::nullopt if the length exceeds @ref Message::max_length.
+ */
+constexpr std::optional<std::size_t> CalcHeaderSize(
+    const std::size_t len) noexcept {
+    if (len <= 0xFF) [[likely]] {
+        return 2;
+    } else if (len <= 0xFFFF) {
+        return 3;
+    } else if (len <= Message::max_length) {
+        return 4;
+    } else [[unlikely]] {
+        return std::nullopt;
+    }
+}
+
+//! The minimum size of an element, which has a format byte and at least one length byte.
+inline constexpr std::size_t min_elem_size {*CalcHeaderSize(0)};
+
+/**
+ * @brief Calculate the capacity to reserve for the elements of a list being deserialized.
+ *
+ * @details
+ * The declared length comes from the input, so the capacity is limited
+ * to the number of elements that the remaining bytes can hold.
+ *
+ * @param len The number of elements declared by the header.
+ * @param remaining The number of bytes after the header.
+ * @param min_size The minimum size of an element.
+ */
+constexpr std::size_t CapListCapacity(
+    const std::size_t len, const std::size_t remaining,
+    const std::size_t min_size = min_elem_size) noexcept {
+    return std::min(len, remaining / min_size);
+}
+
+//! The maximum size of a header.
+inline constexpr std::size_t max_header_size {
+    *CalcHeaderSize(Message::max_length)};
+
+/**
+ * @brief Write a header to a buffer.
+ *
+ * @param len The length, which must not exceed @ref Message::max_length.
+ * @param buf A buffer that is large enough to hold the header.
+ * @return The number of bytes written.
+ */
+constexpr std::size_t WriteHeader(const Type type, const std::size_t len,
+                                  const std::span<std::byte> buf) noexcept {
+    const auto size {CalcHeaderSize(len).value_or(0)};
+    const auto len_byte_count {size - 1};
+    buf[0] = static_cast<std::byte>((static_cast<std::size_t>(type) << 2)
+                                    | len_byte_count);
+    for (std::size_t i {0}; i != len_byte_count; ++i) {
+        buf[size - 1 - i] = static_cast<std::byte>(len >> (i * 8));
+    }
+    return size;
+}
+
+//! The unsigned integer with the same size as a type.
+template <typename T>
+using Bits = std::conditional_t<
+    sizeof(T) == 1, std::uint8_t,
+    std::conditional_t<sizeof(T) == 2, std::uint16_t,
+                       std::conditional_t<sizeof(T) == 4, std::uint32_t,
+                                          std::uint64_t>>>;
+
+//! Write a single value of an item in big-endian to the beginning of a buffer.
+template <typename T>
+constexpr void StoreScalar(const T val,
+                           const std::span<std::byte> buf) noexcept {
+    if constexpr (std::same_as<T, std::byte>) {
+        buf[0] = val;
+    } else if constexpr (std::same_as<T, bool>) {
+        buf[0] = static_cast<std::byte>(val);
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        auto bits {std::bit_cast<Bits<T>>(val)};
+        if constexpr (std::endian::native == std::endian::little
+                      && sizeof(T) > 1) {
+            bits = std::byteswap(bits);
+        }
+
+        const auto bytes {
+            std::bit_cast<std::array<std::byte, sizeof(T)>>(bits)};
+        std::ranges::copy(bytes, buf.begin());
+    } else {
+        // Proxy references, such as those of `std::vector<bool>`.
+        buf[0] = static_cast<std::byte>(static_cast<bool>(val));
+    }
+}
+
+//! Read a single big-endian value of an item from the beginning of a buffer.
+template <typename T>
+constexpr T LoadScalar(const std::span<const std::byte> bytes) noexcept {
+    if constexpr (std::same_as<T, std::byte>) {
+        return bytes[0];
+    } else if constexpr (std::same_as<T, bool>) {
+        return bytes[0] != std::byte {0};
+    } else if constexpr (std::is_arithmetic_v<T>) {
+        std::array<std::byte, sizeof(T)> raw;
+        std::ranges::copy_n(bytes.begin(), raw.size(), raw.begin());
+        auto bits {std::bit_cast<Bits<T>>(raw)};
+        if constexpr (std::endian::native == std::endian::little
+                      && sizeof(T) > 1) {
+            bits = std::byteswap(bits);
+        }
+
+        return std::bit_cast<T>(bits);
+    } else {
+        return T {bytes[0] != std::byte {0}};
+    }
+}
+
+}  // namespace secs2::codec
@@ -0,0 +1,166 @@
+/**
+ * @file decoder.h
+ * @brief Incremental deserialization of SECS-II messages from fragmented input.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "codec.h"
+#include "secs2.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <span>
+#include <vector>
+
+#ifdef SECS2_USE_PMR
+#include <memory_resource>
+#endif
+
+namespace secs2 {
+
+namespace byte::r {
+struct LoadContext;
+}
+
+/**
+ * @brief A resumable decoder that deserializes a message from chunks of bytes as they arrive.
+ *
+ * @details
+ * Partially decoded lists are kept on an explicit stack instead of the call stack,
+ * so the nesting depth of a message does not affect the stack usage.
+ *
+ * ```c++
+ * MessageDecoder decoder;
+ * while (!decoder.HasMessage()) {
+ *     const auto chunk {Receive()};
+ *     if (!decoder.Feed(chunk).has_value()) {
+ *         // Handle the error.
+ *     }
+ * }
+ *
+ * const auto msg {decoder.TakeMessage()};
+ * ```
+ */
+class MessageDecoder {
+public:
+    MessageDecoder() noexcept = default;
+
+    /**
+     * @brief Construct a decoder with limits on the resources used.
+     *
+     * @param opts Limits applied to each message.
+     */
+    explicit MessageDecoder(const DecodeOptions& opts) noexcept;
+
+#ifdef SECS2_USE_PMR
+    /**
+     * @brief Construct a decoder that allocates decoded messages from a memory resource.
+     *
+     * @param resource A memory resource, which must outlive the decoder and its messages.
+     * @param opts Limits applied to each message.
+     */
+    explicit MessageDecoder(std::pmr::memory_resource* resource,
+                            const DecodeOptions& opts = {}) noexcept;
+#endif
+
+    /**
+     * @brief Feed a chunk of bytes to the decoder.
+     *
+     * @details
+     * Bytes are consumed until the end of the current message.
+     * Once a message is complete, no more bytes are consumed until it is taken by @ref TakeMessage.
+     *
+     * @return
+     * The number of bytes consumed from the chunk if successful.
+     * Otherwise the same errors as @ref Message::BuildFromBytes except incomplete data,
+     * and the decoder keeps failing until it is reset by @ref Reset.
+     */
+    std::expected<std::size_t, Error> Feed(
+        std::span<const std::byte> bytes) noexcept;
+
+    //! Check whether a complete message has been decoded.
+    bool HasMessage() const noexcept;
+
+    //! Check whether the decoder has failed.
+    bool HasError() const noexcept;
+
+    //! Get the number of bytes of the current message consumed so far.
+    std::size_t GetByteSize() const noexcept;
+
+    /**
+     * @brief Take the decoded message and reset the decoder for the next message.
+     *
+     * @return
+     * A pair consisting of the decoded message and the number of bytes it consumed,
+     * or @p std::nullopt if no complete message has been decoded.
+     */
+    std::optional<DeserializedMessage> TakeMessage() noexcept;
+
+    //! Discard any partial message or error.
+    void Reset() noexcept;
+
+private:
+    //! A partially decoded list.
+    struct Frame {
+        List list;
+        //! The number of elements that have not been decoded yet.
+        std::size_t remaining_count {0};
+    };
+
+    enum class State : std::uint8_t { Header, Body, Done, Failed };
+
+    //! Feed bytes to the header of the current item or list.
+    std::expected<std::size_t, Error> FeedHeader(
+        std::span<const std::byte> bytes) noexcept;
+
+    //! Feed bytes to the value of the current item.
+    std::expected<std::size_t, Error> FeedBody(
+        std::span<const std::byte> bytes) noexcept;
+
+    //! Complete an item or list and attach it to its parent list.
+    void Complete(Message::Value val) noexcept;
+
+    std::expected<std::size_t, Error> Fail(Error err) noexcept;
+
+    //! Get the context for deserializing values, which carries the counters of the current message.
+    byte::r::LoadContext GetLoadContext() const noexcept;
+
+    //! Deserialize the value of the current item and record the memory reserved.
+    std::expected<Message::Value, Error> LoadVal(
+        std::span<const std::byte> bytes) noexcept;
+
+    State state_ {State::Header};
+    std::array<std::byte, codec::max_header_size> header_ {};
+    std::size_t header_size_ {0};
+    std::size_t len_byte_count_ {0};
+    Type type_ {Type::Unknown};
+    std::size_t len_ {0};
+    std::vector<std::byte> body_;
+    std::vector<Frame> frames_;
+    std::optional<Message::Value> val_;
+    std::optional<Error> err_;
+    std::size_t byte_size_ {0};
+
+    DecodeOptions opts_;
+    //! The number of elements of the current message.
+    std::size_t elem_count_ {0};
+    //! The number of bytes reserved for values of the current message.
+    std::size_t alloc_size_ {0};
+
+#ifdef SECS2_USE_PMR
+    std::pmr::memory_resource* resource_ {std::pmr::get_default_resource()};
+#endif
+};
+
+}  // namespace secs2
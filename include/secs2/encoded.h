@@ -0,0 +1,96 @@
+/**
+ * @file encoded.h
+ * @brief SECS-II messages that memoize their serialized bytes.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace secs2 {
+
+/**
+ * @brief A message that is serialized at most once.
+ *
+ * @details
+ * The bytes are calculated when it is constructed and reused by later calls,
+ * which suits messages sent several times, such as retransmissions.
+ * A message is immutable after construction, so the bytes are only replaced by @ref swap.
+ * As @p const methods do not modify the object, they can be called concurrently.
+ *
+ * ```c++
+ * const EncodedMessage msg {Message {U1 {0}}};
+ * const auto bytes {msg.ToBytes()};
+ * const auto again {msg.ToBytes()};
+ * ```
+ */
+class EncodedMessage {
+public:
+    //! Construct an encoded message from a message and serialize it.
+    explicit EncodedMessage(Message msg) noexcept;
+
+    //! Get the message.
+    const Message& GetMessage() const noexcept;
+
+    /**
+     * @brief Get the number of bytes of the message after serialization.
+     *
+     * @return The same as @ref Message::GetEncodedSize.
+     */
+    std::optional<std::size_t> GetEncodedSize() const noexcept;
+
+    /**
+     * @brief Get the serialized message.
+     *
+     * @return
+     * A view of the cached bytes if the length does not exceed @ref Message::max_length,
+     * otherwise @p std::nullopt. The view is valid until the object is swapped or destroyed.
+     */
+    std::optional<std::span<const std::byte>> ToBytes() const noexcept;
+
+    /**
+     * @brief Copy the serialized message into a caller-provided buffer.
+     *
+     * @return The same as @ref Message::SerializeInto with a buffer.
+     */
+    std::expected<std::size_t, Error> SerializeInto(
+        std::span<std::byte> buf) const noexcept;
+
+    /**
+     * @brief Pass the serialized message to a sink in a single chunk.
+     *
+     * @return The same as @ref Message::SerializeInto with a sink.
+     */
+    std::expected<std::size_t, Error> SerializeInto(
+        const ByteSink& sink) const noexcept;
+
+    //! Swaps this message and its cache with another.
+    void swap(EncodedMessage&) noexcept;
+
+    //! Swaps the message with another and serializes the new one.
+    void swap(Message&) noexcept;
+
+private:
+    Message msg_;
+
+    //! The serialized message, or @p std::nullopt if the length exceeds @ref Message::max_length.
+    std::optional<std::vector<std::byte>> bytes_;
+};
+
+//! Same as @ref EncodedMessage::swap.
+void swap(EncodedMessage&, EncodedMessage&) noexcept;
+
+}  // namespace secs2
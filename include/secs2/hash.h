@@ -0,0 +1,75 @@
+/**
+ * @file hash.h
+ * @brief Content hashing and byte-level equality of SECS-II messages.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+
+namespace secs2 {
+
+/**
+ * @brief Calculate a non-cryptographic hash of the content of a value without serializing it.
+ *
+ * @details
+ * The hash is consistent with the equality of values:
+ * equal values have the same hash, regardless of how they were serialized.
+ * Big-endian values are hashed with @p -0.0 as @p 0.0 and booleans as @p 0 or @p 1.
+ *
+ * @note The hash is not stable across platforms with different byte orders.
+ */
+std::uint64_t HashValue(const Message::Value& val) noexcept;
+
+//! Same as @ref HashValue for the value of a message.
+std::uint64_t HashMsg(const Message& msg) noexcept;
+
+/**
+ * @brief Calculate the hash of a serialized message without deserializing it.
+ *
+ * @param bytes A buffer starting from a message.
+ * @return
+ * The same hash as @ref HashMsg for the deserialized message if successful,
+ * otherwise the same errors as @ref Message::Validate.
+ */
+std::expected<std::uint64_t, Error> HashMsgBytes(
+    std::span<const std::byte> bytes) noexcept;
+
+/**
+ * @brief Check whether two serialized messages are equal without deserializing them.
+ *
+ * @details
+ * It gives the same result as comparing the deserialized messages.
+ * Headers are compared before values, and the comparison stops at the first difference.
+ * Length bytes may differ, since a length can be encoded with more bytes than required.
+ *
+ * @return
+ * Whether the messages at the beginning of the buffers are equal if successful.
+ * Otherwise the same errors as @ref Message::Validate,
+ * which are only reported for bytes before the first difference.
+ */
+std::expected<bool, Error> EqualMsgBytes(std::span<const std::byte> lhs,
+                                         std::span<const std::byte> rhs) noexcept;
+
+}  // namespace secs2
+
+//! Same as @ref secs2::HashMsg.
+template <>
+struct std::hash<secs2::Message> {
+    std::size_t operator()(const secs2::Message& msg) const noexcept {
+        return static_cast<std::size_t>(secs2::HashMsg(msg));
+    }
+};
@@ -0,0 +1,159 @@
+/**
+ * @file index.h
+ * @brief Structural scanning and indexing of serialized SECS-II data without decoding values.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "codec.h"
+#include "secs2.h"
+
+#include <cstddef>
+#include <expected>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace secs2 {
+
+//! The header of a serialized item or list.
+using MsgHeader = codec::Header;
+
+/**
+ * @brief Read the header of an item or list.
+ *
+ * @return
+ * The header if successful, otherwise the same errors as @ref Message::BuildFromBytes
+ * for the format byte and length bytes.
+ */
+std::expected<MsgHeader, Error> ReadMsgHeader(
+    std::span<const std::byte> bytes) noexcept;
+
+/**
+ * @brief Find the bytes of a nested element in a serialized message by its path.
+ *
+ * @details
+ * Only the headers along the path and of the elements before it are read.
+ * The found element itself is not checked.
+ *
+ * @param bytes A buffer starting from a message.
+ * @param path The indices of elements from the root. An empty path refers to the root.
+ * @return
+ * The bytes starting from the element if successful. Otherwise:
+ * - The same errors as @ref Message::BuildFromBytes for the headers read.
+ * - @p std::errc::result_out_of_range: An element on the path is not a list or has too few elements.
+ */
+std::expected<std::span<const std::byte>, Error> FindElemBytes(
+    std::span<const std::byte> bytes,
+    std::span<const std::size_t> path) noexcept;
+
+/**
+ * @brief Decode a nested element of a serialized message by its path.
+ *
+ * @details
+ * Only the headers along the path are read, and only the found element is decoded.
+ *
+ * ```c++
+ * const auto ceid {Extract<U4>(bytes, {1})};
+ * ```
+ *
+ * @tparam T The type of the element, such as @ref U4 or @ref List.
+ * @return
+ * The value of the element if successful. Otherwise the same errors as @ref FindElemBytes or:
+ * - @p std::errc::invalid_argument: The element is not of type @p T.
+ */
+template <typename T>
+std::expected<T, Error> Extract(std::span<const std::byte> bytes,
+                                std::span<const std::size_t> path) noexcept;
+
+//! @overload
+template <typename T>
+std::expected<T, Error> Extract(
+    const std::span<const std::byte> bytes,
+    const std::initializer_list<std::size_t> path) noexcept {
+    return Extract<T>(bytes, std::span {path.begin(), path.size()});
+}
+
+//! The location of an item or list in a serialized message.
+struct IndexNode {
+    //! The format code.
+    Type type {Type::Unknown};
+
+    //! The offset of the header from the beginning of the message.
+    std::size_t offset {0};
+
+    //! The size of the format byte and length bytes.
+    std::size_t header_size {0};
+
+    //! The length from the header, which is the same as @ref MsgHeader::len.
+    std::size_t len {0};
+
+    //! The number of bytes, including the header and all nested elements.
+    std::size_t byte_size {0};
+
+    //! The index of the node after all nested elements, which is the next sibling if there is one.
+    std::size_t end {0};
+};
+
+/**
+ * @brief A flat index of the items and lists in a serialized message.
+ *
+ * @details
+ * Nodes are stored in pre-order, the same order as the bytes.
+ * The first element of a list follows it, and later elements follow @ref IndexNode::end of the previous ones,
+ * so the structure can be walked without reading the bytes again.
+ */
+class MessageIndex {
+public:
+    /**
+     * @brief Index a serialized message by reading its headers.
+     *
+     * @return
+     * The index if successful, otherwise the same errors as @ref Message::BuildFromBytes.
+     */
+    static std::expected<MessageIndex, Error> Build(
+        std::span<const std::byte> bytes) noexcept;
+
+    //! Get all nodes in pre-order. The first one is the root.
+    std::span<const IndexNode> GetNodes() const noexcept;
+
+    //! Get the number of bytes of the message.
+    std::size_t GetByteSize() const noexcept;
+
+    /**
+     * @brief Get a direct element of a list.
+     *
+     * @param node The index of a node.
+     * @param idx The index of the element.
+     * @return
+     * The index of the element node,
+     * or @p std::nullopt if the node is not a list or the element index is out of range.
+     */
+    std::optional<std::size_t> GetElem(std::size_t node,
+                                       std::size_t idx) const noexcept;
+
+    /**
+     * @brief Find a nested element by the indices of elements from the root.
+     *
+     * @return
+     * The index of the node, or @p std::nullopt if the path does not exist.
+     * An empty path refers to the root.
+     */
+    std::optional<std::size_t> Find(
+        std::span<const std::size_t> path) const noexcept;
+
+private:
+    explicit MessageIndex(std::vector<IndexNode> nodes) noexcept;
+
+    std::vector<IndexNode> nodes_;
+};
+
+}  // namespace secs2
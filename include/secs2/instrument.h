@@ -0,0 +1,260 @@
+/**
+ * @file instrument.h
+ * @brief Hooks and metrics for observing serialization and deserialization.
+ *
+ * @details
+ * Hooks are only called if the library is built with @p SECS2_INSTRUMENTATION.
+ * Otherwise they are compiled out and this header only declares @ref secs2::instrument::Operation.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <cstdint>
+
+#ifdef SECS2_INSTRUMENTATION
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <system_error>
+#endif
+
+namespace secs2::instrument {
+
+//! Operations whose latencies are recorded.
+enum class Operation : std::uint8_t {
+    //! @ref Message::ToBytes.
+    ToBytes,
+    //! @ref Message::BuildFromBytes and @ref BuildMsgFromBytes.
+    BuildFromBytes,
+    //! @ref Message::ToSml.
+    ToSml
+};
+
+//! Specific kinds of errors, which can share the same error code.
+enum class ErrorKind : std::uint8_t {
+    //! No error.
+    None,
+    //! The data end before an item or list.
+    IncompleteData,
+    //! The length of an item is not a multiple of its value size.
+    UnalignedLength,
+    //! A format code is unknown.
+    UnknownType,
+    //! The number of length bytes is invalid.
+    InvalidLengthByteCount,
+    //! A length exceeds @ref Message::max_length.
+    ExceededLength,
+    //! A buffer is too small for a message.
+    InsufficientBuffer,
+    //! Lists exceed @ref DecodeOptions::max_depth.
+    ExceededDepth,
+    //! Elements exceed @ref DecodeOptions::max_elem_count.
+    ExceededElemCount,
+    //! Values exceed @ref DecodeOptions::max_alloc_size.
+    ExceededAllocSize,
+    //! An error of another kind.
+    Other
+};
+
+#ifdef SECS2_INSTRUMENTATION
+
+//! The number of operations.
+constexpr std::size_t operation_count {3};
+
+//! The number of error kinds.
+constexpr std::size_t error_kind_count {11};
+
+//! Convert an operation to a string.
+std::string to_string(Operation) noexcept;
+
+//! Convert an error kind to a string.
+std::string to_string(ErrorKind) noexcept;
+
+/**
+ * @brief Callbacks from the library, which do nothing by default.
+ *
+ * @details
+ * They can be called concurrently from any thread that uses the library,
+ * and must not use the library.
+ */
+class Hooks {
+public:
+    virtual ~Hooks() noexcept = default;
+
+    /**
+     * @brief Called after an item or list is serialized into a buffer.
+     *
+     * @param byte_size The number of bytes of the element, including nested elements.
+     * @param depth The number of lists enclosing the element.
+     */
+    virtual void OnEncodeElem([[maybe_unused]] Type type,
+                              [[maybe_unused]] std::size_t byte_size,
+                              [[maybe_unused]] std::size_t depth) noexcept {}
+
+    //! Called after an item or list is deserialized, with the same parameters as @ref OnEncodeElem.
+    virtual void OnDecodeElem([[maybe_unused]] Type type,
+                              [[maybe_unused]] std::size_t byte_size,
+                              [[maybe_unused]] std::size_t depth) noexcept {}
+
+    /**
+     * @brief Called when memory is reserved for the value of an item or list during deserialization.
+     *
+     * @param size The number of bytes reserved.
+     */
+    virtual void OnDecodeAlloc([[maybe_unused]] Type type,
+                               [[maybe_unused]] std::size_t size) noexcept {}
+
+    /**
+     * @brief Called after an operation completes.
+     *
+     * @param latency The time spent on the operation.
+     * @param err An empty error code if the operation succeeded, otherwise the code of its error.
+     * @param kind The kind of the error, which tells apart errors with the same code.
+     */
+    virtual void OnOperation(
+        [[maybe_unused]] Operation op,
+        [[maybe_unused]] std::chrono::nanoseconds latency,
+        [[maybe_unused]] const std::error_code& err,
+        [[maybe_unused]] ErrorKind kind) noexcept {}
+};
+
+/**
+ * @brief Install hooks for all threads.
+ *
+ * @param hooks Hooks that must outlive their use, or @p nullptr to remove the current hooks.
+ * @return The previous hooks.
+ */
+Hooks* SetHooks(Hooks* hooks) noexcept;
+
+//! Get the installed hooks, or @p nullptr if there are none.
+Hooks* GetHooks() noexcept;
+
+/**
+ * @brief Hooks collecting counters, sizes and latency histograms.
+ *
+ * @details
+ * Counters are updated with relaxed atomic operations and can be read at any time.
+ *
+ * ```c++
+ * instrument::Metrics metrics;
+ * instrument::SetHooks(&metrics);
+ * const auto text {metrics.ToPrometheus()};
+ * ```
+ */
+class Metrics final : public Hooks {
+public:
+    //! The upper bounds of latency buckets in nanoseconds. Longer latencies fall into the last bucket.
+    static constexpr std::array<std::uint64_t, 10> latency_bounds {
+        1'000,   2'500,   10'000,    25'000,     100'000,
+        250'000, 1'000'000, 2'500'000, 10'000'000, 100'000'000};
+
+    //! Counters of elements of a type.
+    struct ElemStats {
+        //! The number of elements.
+        std::uint64_t count {0};
+        //! The number of bytes of elements.
+        std::uint64_t byte_size {0};
+    };
+
+    //! A histogram of latencies.
+    struct LatencyStats {
+        //! The number of operations in each bucket, not accumulated.
+        std::array<std::uint64_t, latency_bounds.size() + 1> buckets {};
+        //! The total latency in nanoseconds.
+        std::uint64_t sum {0};
+        //! The number of operations.
+        std::uint64_t count {0};
+    };
+
+    void OnEncodeElem(Type type, std::size_t byte_size,
+                      std::size_t depth) noexcept override;
+
+    void OnDecodeElem(Type type, std::size_t byte_size,
+                      std::size_t depth) noexcept override;
+
+    void OnDecodeAlloc(Type type, std::size_t size) noexcept override;
+
+    void OnOperation(Operation op, std::chrono::nanoseconds latency,
+                     const std::error_code& err,
+                     ErrorKind kind) noexcept override;
+
+    //! Get the counters of serialized elements of a type.
+    ElemStats GetEncoded(Type type) const noexcept;
+
+    //! Get the counters of deserialized elements of a type.
+    ElemStats GetDecoded(Type type) const noexcept;
+
+    //! Get the number of reservations and reserved bytes for deserialized elements of a type.
+    ElemStats GetDecodeAllocs(Type type) const noexcept;
+
+    //! Get the maximum number of lists enclosing a serialized element.
+    std::size_t GetMaxEncodeDepth() const noexcept;
+
+    //! Get the maximum number of lists enclosing a deserialized element.
+    std::size_t GetMaxDecodeDepth() const noexcept;
+
+    //! Get the latency histogram of an operation.
+    LatencyStats GetLatency(Operation op) const noexcept;
+
+    //! Get the number of failures of an operation with an error kind.
+    std::uint64_t GetErrorCount(Operation op, ErrorKind kind) const noexcept;
+
+    /**
+     * @brief Format all metrics in the Prometheus text exposition format.
+     *
+     * @details
+     * Types without any element are omitted.
+     * Element metrics are labeled by @p type, and operation metrics are labeled by @p op.
+     * Errors are also labeled by @p kind.
+     */
+    std::string ToPrometheus() const noexcept;
+
+    //! Reset all metrics to zero.
+    void Reset() noexcept;
+
+private:
+    //! The number of distinct values of a 6-bit format code.
+    static constexpr std::size_t type_count {1 << 6};
+
+    struct AtomicElemStats {
+        std::atomic<std::uint64_t> count {0};
+        std::atomic<std::uint64_t> byte_size {0};
+    };
+
+    struct AtomicLatencyStats {
+        std::array<std::atomic<std::uint64_t>, latency_bounds.size() + 1>
+            buckets {};
+        std::atomic<std::uint64_t> sum {0};
+        std::atomic<std::uint64_t> count {0};
+    };
+
+    static void Add(AtomicElemStats& stats, std::size_t byte_size) noexcept;
+
+    static ElemStats Load(const AtomicElemStats& stats) noexcept;
+
+    std::array<AtomicElemStats, type_count> encoded_ {};
+    std::array<AtomicElemStats, type_count> decoded_ {};
+    std::array<AtomicElemStats, type_count> decode_allocs_ {};
+    std::atomic<std::size_t> max_encode_depth_ {0};
+    std::atomic<std::size_t> max_decode_depth_ {0};
+    std::array<AtomicLatencyStats, operation_count> latencies_ {};
+    //! The number of failures of each operation with each error kind.
+    std::array<std::array<std::atomic<std::uint64_t>, error_kind_count>,
+               operation_count>
+        errs_ {};
+};
+
+#endif
+
+}  // namespace secs2::instrument
@@ -0,0 +1,141 @@
+/**
+ * @file lazy_list.h
+ * @brief Lists whose elements are deserialized one by one while being iterated.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <cstddef>
+#include <expected>
+#include <iterator>
+#include <optional>
+#include <span>
+#include <version>
+
+#ifdef __cpp_lib_generator
+#include <generator>
+#endif
+
+namespace secs2 {
+
+/**
+ * @brief A serialized top-level list whose direct elements are deserialized on demand.
+ *
+ * @details
+ * Only the element being read is held in memory, so a huge list can be processed element by element,
+ * and iteration can stop early without reading the remaining bytes.
+ * The underlying bytes must outlive the list.
+ *
+ * ```c++
+ * auto list {LazyList::BuildFromBytes(bytes)};
+ * for (auto& elem : *list) {
+ *     if (!elem.has_value()) {
+ *         // Handle the error.
+ *         break;
+ *     }
+ * }
+ * ```
+ */
+class LazyList {
+public:
+    class Iterator;
+
+    //! An element if successful, otherwise an error.
+    using Elem = std::expected<ListElem, Error>;
+
+    /**
+     * @brief Read the header of a top-level list without deserializing its elements.
+     *
+     * @param bytes A buffer starting from a list.
+     * @param opts Limits applied to each element.
+     * @return
+     * The list if successful. Otherwise the same errors as @ref Message::BuildFromBytes or:
+     * - @p std::errc::invalid_argument: The message is not a list.
+     */
+    static std::expected<LazyList, Error> BuildFromBytes(
+        std::span<const std::byte> bytes,
+        const DecodeOptions& opts = {}) noexcept;
+
+    //! Get the number of direct elements declared by the header.
+    std::size_t GetSize() const noexcept;
+
+    //! Get the number of bytes read so far, including the header.
+    std::size_t GetByteSize() const noexcept;
+
+    /**
+     * @brief Deserialize the next element.
+     *
+     * @return
+     * The element, or an error with the same codes as @ref Message::BuildFromBytes.
+     * @p std::nullopt after the last element or an error.
+     */
+    std::optional<Elem> Next() noexcept;
+
+    //! Get an iterator deserializing the remaining elements.
+    Iterator begin() noexcept;
+
+    std::default_sentinel_t end() const noexcept;
+
+private:
+    LazyList(std::span<const std::byte> bytes, std::size_t count,
+             std::size_t header_size, const DecodeOptions& opts) noexcept;
+
+    std::span<const std::byte> bytes_;
+    //! The number of elements that have not been read.
+    std::size_t remaining_count_ {0};
+    std::size_t count_ {0};
+    std::size_t byte_size_ {0};
+    DecodeOptions opts_;
+};
+
+//! A single-pass iterator over the remaining elements of a lazy list.
+class LazyList::Iterator {
+public:
+    using value_type = Elem;
+    using difference_type = std::ptrdiff_t;
+
+    Iterator() noexcept = default;
+
+    Elem& operator*() const noexcept;
+
+    Elem* operator->() const noexcept;
+
+    Iterator& operator++() noexcept;
+
+    void operator++(int) noexcept;
+
+    bool operator==(std::default_sentinel_t) const noexcept;
+
+private:
+    friend class LazyList;
+
+    explicit Iterator(LazyList& list) noexcept;
+
+    LazyList* list_ {nullptr};
+    mutable std::optional<Elem> curr_;
+};
+
+static_assert(std::input_iterator<LazyList::Iterator>);
+
+#ifdef __cpp_lib_generator
+/**
+ * @brief Yield the direct elements of a serialized top-level list one by one.
+ *
+ * @details
+ * It is a coroutine over @ref LazyList.
+ * An error is yielded once and ends the sequence.
+ */
+std::generator<LazyList::Elem> GenerateListElems(
+    std::span<const std::byte> bytes, DecodeOptions opts = {});
+#endif
+
+}  // namespace secs2
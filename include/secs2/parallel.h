@@ -0,0 +1,150 @@
+/**
+ * @file parallel.h
+ * @brief Parallel serialization and deserialization of SECS-II messages with large lists.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <expected>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace secs2 {
+
+/**
+ * @brief A callable running a task for each index from zero to a count.
+ *
+ * @details
+ * Tasks for different indices are independent and can run concurrently.
+ * The executor must not return until all tasks have completed.
+ * Any thread pool or scheduler can be plugged in, such as @ref ThreadPool.
+ */
+using Executor = std::function<void(std::size_t count,
+                                    const std::function<void(std::size_t)>&)>;
+
+/**
+ * @brief A fixed-size pool of threads that can be used as an @ref Executor.
+ *
+ * @details
+ * The calling thread also runs tasks while waiting for them,
+ * and indices are handed out one by one so uneven tasks are balanced.
+ *
+ * ```c++
+ * ThreadPool pool;
+ * const auto bytes {EncodeParallel(msg, std::ref(pool))};
+ * ```
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Start a pool of threads.
+     *
+     * @param thread_count The number of worker threads besides the calling thread.
+     * @exception std::system_error A thread cannot be started. The threads already started are stopped.
+     */
+    explicit ThreadPool(
+        std::size_t thread_count = std::thread::hardware_concurrency());
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    //! Stop all threads after their current tasks.
+    ~ThreadPool() noexcept;
+
+    //! Get the number of worker threads.
+    std::size_t GetThreadCount() const noexcept;
+
+    /**
+     * @brief Run a task for each index from zero to a count and wait for all of them.
+     *
+     * @details
+     * Concurrent calls from different threads are run one after another.
+     * A call from inside a task of the same pool, such as a nested @ref EncodeParallel,
+     * runs all of its tasks on the calling thread instead of waiting for the busy pool.
+     */
+    void operator()(std::size_t count,
+                    const std::function<void(std::size_t)>& task) noexcept;
+
+private:
+    //! Tasks being run.
+    struct Job {
+        const std::function<void(std::size_t)>* task {nullptr};
+        std::size_t count {0};
+        //! The next index to be run.
+        std::atomic<std::size_t> next {0};
+    };
+
+    //! Run tasks of a job until all indices have been taken.
+    void RunJob(Job& job) noexcept;
+
+    void Work() noexcept;
+
+    //! Stop and join all started threads.
+    void Stop() noexcept;
+
+    std::mutex run_mtx_;
+    std::mutex mtx_;
+    std::condition_variable job_cv_;
+    std::condition_variable done_cv_;
+    Job* job_ {nullptr};
+    //! Incremented for each job so workers join it only once.
+    std::size_t generation_ {0};
+    //! The number of workers running tasks of the current job.
+    std::size_t active_count_ {0};
+    bool stopped_ {false};
+    std::vector<std::thread> workers_;
+};
+
+/**
+ * @brief Serialize a message whose top-level list is encoded in parallel.
+ *
+ * @details
+ * The encoded sizes of the top-level elements are calculated concurrently first,
+ * then each element is written concurrently to its own region of a single buffer.
+ * Items and nested lists are encoded the same as @ref Message::ToBytes.
+ *
+ * @param msg A message.
+ * @param exec An executor running tasks for the top-level elements.
+ * @return The same as @ref Message::ToBytes.
+ */
+std::optional<std::vector<std::byte>> EncodeParallel(
+    const Message& msg, const Executor& exec) noexcept;
+
+/**
+ * @brief Deserialize a message whose top-level list is decoded in parallel.
+ *
+ * @details
+ * The boundaries of the top-level elements are found by a pass over headers only,
+ * then the elements are decoded concurrently.
+ * Elements share the counters of the whole message, which are checked before each element is counted or memory is reserved,
+ * so the limits hold while elements are decoded.
+ * Once an element fails, the others stop decoding.
+ * If several elements fail, the error of whichever fails first is returned.
+ *
+ * @param bytes A buffer starting from a message.
+ * @param exec An executor running tasks for the top-level elements.
+ * @param opts Limits on the resources used.
+ * @return The same as @ref Message::BuildFromBytes.
+ */
+std::expected<DeserializedMessage, Error> DecodeParallel(
+    std::span<const std::byte> bytes, const Executor& exec,
+    const DecodeOptions& opts = {}) noexcept;
+
+}  // namespace secs2
@@ -0,0 +1,634 @@
+/**
+ * @file schema.h
+ * @brief Compile-time schemas of SECS-II messages with specialized serialization and deserialization.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "codec.h"
+#include "index.h"
+#include "secs2.h"
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace secs2::schema {
+
+namespace detail {
+
+//! The bytes of a header with a fixed length.
+template <Type type, std::size_t len>
+inline constexpr auto header_bytes {[] {
+    std::array<std::byte, codec::CalcHeaderSize(len).value()> bytes {};
+    codec::WriteHeader(type, len, bytes);
+    return bytes;
+}()};
+
+/**
+ * @brief Read a header and check its type.
+ *
+ * @details For an item, its bytes must follow the header and its length must be aligned to its elements.
+ *
+ * @return
+ * The header if successful. Otherwise the same errors as @ref ReadMsgHeader or:
+ * - @p std::errc::message_size: The bytes of an item are incomplete,
+ *   or its length is not a multiple of the size of its elements.
+ * - @p std::errc::invalid_argument: The element is not of the expected type.
+ */
+std::expected<MsgHeader, Error> ReadHeader(std::span<const std::byte> bytes,
+                                           Type type) noexcept;
+
+//! Make an error indicating that the length of an element does not match the schema.
+Error MakeMismatchedLengthError(Type type, std::size_t expected,
+                                std::size_t actual) noexcept;
+
+//! Make an error indicating that a length exceeds the maximum allowed length.
+Error MakeExceededLengthError() noexcept;
+
+//! Make an error indicating that a buffer is too small.
+Error MakeInsufficientBufferError(std::size_t required,
+                                  std::size_t provided) noexcept;
+
+//! Convert native values to big-endian bytes.
+template <typename T>
+    requires std::is_arithmetic_v<T>
+void StoreBigEndian(std::span<const T> src, std::span<std::byte> dst) noexcept;
+
+//! Convert big-endian bytes to native values.
+template <typename T>
+    requires std::is_arithmetic_v<T>
+void LoadBigEndian(std::span<const std::byte> src, std::span<T> dst) noexcept;
+
+//! Calculate the encoded size of a dynamic value.
+std::optional<std::size_t> CalcEncodedSize(const Message::Value& val) noexcept;
+
+//! Write a dynamic value, whose lengths must not exceed the maximum allowed length.
+std::size_t WriteMsgBytes(const Message::Value& val,
+                          std::span<std::byte> buf) noexcept;
+
+//! The limits and counters shared by all elements while reading a message.
+struct ReadContext {
+    //! Limits on the resources used.
+    DecodeOptions opts {};
+
+    //! The number of lists enclosing the element being read.
+    std::size_t depth {0};
+
+    //! The number of elements read so far.
+    std::size_t elem_count {0};
+
+    //! The number of bytes reserved for values so far.
+    std::size_t alloc_size {0};
+};
+
+/**
+ * @brief Count an element.
+ *
+ * @return Nothing if the total does not exceed @ref DecodeOptions::max_elem_count, otherwise an error.
+ */
+std::expected<void, Error> AddElem(ReadContext& ctx) noexcept;
+
+/**
+ * @brief Record the memory reserved for values.
+ *
+ * @return Nothing if the total does not exceed @ref DecodeOptions::max_alloc_size, otherwise an error.
+ */
+std::expected<void, Error> AddAllocSize(ReadContext& ctx, Type type,
+                                        std::size_t size) noexcept;
+
+/**
+ * @brief Enter a list.
+ *
+ * @return Nothing if the depth does not exceed @ref DecodeOptions::max_depth, otherwise an error.
+ */
+std::expected<void, Error> EnterList(ReadContext& ctx) noexcept;
+
+//! Read a dynamic value and its size in bytes within the limits of a context.
+std::expected<std::pair<Message::Value, std::size_t>, Error> LoadMsgBytes(
+    std::span<const std::byte> bytes, ReadContext& ctx) noexcept;
+
+//! A decoded value and its size in bytes.
+template <typename T>
+using Decoded = std::expected<std::pair<T, std::size_t>, Error>;
+
+}  // namespace detail
+
+/**
+ * @brief An item with any number of values, decoded as its container such as @ref U4 or @ref ASCII.
+ *
+ * @details
+ * It can be serialized from any sized range of values convertible to the elements,
+ * and an @ref ASCII item also from a string view.
+ */
+template <typename T>
+    requires(!std::same_as<T, List> && format_code<T> != Type::Unknown)
+struct Array {
+    using Value = T;
+
+    using Elem = std::ranges::range_value_t<T>;
+
+    static constexpr std::size_t min_size {codec::min_elem_size};
+
+    static constexpr std::optional<std::size_t> fixed_size {std::nullopt};
+
+    template <typename V>
+    static std::optional<std::size_t> CalcSize(const V& val) noexcept {
+        const auto len {std::ranges::size(ToRange(val)) * sizeof(Elem)};
+        return codec::CalcHeaderSize(len).transform(
+            [len](const std::size_t header_size) noexcept {
+                return header_size + len;
+            });
+    }
+
+    template <typename V>
+    static std::size_t Write(const V& val,
+                             const std::span<std::byte> buf) noexcept {
+        const auto& range {ToRange(val)};
+        using Range = std::remove_cvref_t<decltype(range)>;
+        using RangeElem = std::ranges::range_value_t<Range>;
+        const auto len {std::ranges::size(range) * sizeof(Elem)};
+        const auto header_size {codec::WriteHeader(format_code<T>, len, buf)};
+        const auto body {buf.subspan(header_size, len)};
+        if constexpr (std::ranges::contiguous_range<Range>
+                      && std::same_as<RangeElem, Elem>) {
+            if constexpr (sizeof(Elem) == sizeof(std::byte)
+                          || std::endian::native == std::endian::big) {
+                if (len != 0) {
+                    std::memcpy(body.data(), std::ranges::data(range), len);
+                }
+            } else {
+                detail::StoreBigEndian(std::span<const Elem> {range}, body);
+            }
+        } else {
+            std::size_t offset {0};
+            for (const auto& elem : range) {
+                codec::StoreScalar(static_cast<Elem>(elem),
+                                    body.subspan(offset));
+                offset += sizeof(Elem);
+            }
+        }
+        return header_size + len;
+    }
+
+    static detail::Decoded<Value> Read(const std::span<const std::byte> bytes,
+                                       detail::ReadContext& ctx) noexcept {
+        const auto header {detail::ReadHeader(bytes, format_code<T>)};
+        if (!header.has_value()) [[unlikely]] {
+            return std::unexpected {header.error()};
+        }
+
+        const auto body {bytes.subspan(header->size, header->len)};
+        const auto count {header->len / sizeof(Elem)};
+        if (const auto added {detail::AddElem(ctx)}; !added.has_value())
+            [[unlikely]] {
+            return std::unexpected {added.error()};
+        } else if (const auto reserved {detail::AddAllocSize(
+                       ctx, format_code<T>, count * sizeof(Elem))};
+                   !reserved.has_value()) [[unlikely]] {
+            return std::unexpected {reserved.error()};
+        }
+
+        T vals;
+        if constexpr (std::same_as<T, ASCII>) {
+            vals.assign(reinterpret_cast<const char*>(body.data()), count);
+        } else if constexpr (std::same_as<Elem, std::byte>) {
+            vals.assign(body.begin(), body.end());
+        } else if constexpr (std::ranges::contiguous_range<T>
+                             && std::is_arithmetic_v<Elem>) {
+            vals.resize(count);
+            detail::LoadBigEndian(body, std::span {vals});
+        } else {
+            for (std::size_t i {0}; i != count; ++i) {
+                vals.push_back(codec::LoadScalar<Elem>(
+                    body.subspan(i * sizeof(Elem))));
+            }
+        }
+        return std::pair {std::move(vals), header->size + header->len};
+    }
+
+private:
+    template <typename V>
+    static decltype(auto) ToRange(const V& val) noexcept {
+        if constexpr (std::same_as<T, ASCII>
+                      && std::convertible_to<const V&, std::string_view>) {
+            return std::string_view {val};
+        } else {
+            return (val);
+        }
+    }
+};
+
+/**
+ * @brief An item with exactly one value, decoded as the value itself such as @p std::uint32_t.
+ *
+ * @details Its header is built at compile time.
+ */
+template <typename T>
+    requires(!std::same_as<T, List> && !std::same_as<T, ASCII>
+             && format_code<T> != Type::Unknown)
+struct Scalar {
+    using Value = std::ranges::range_value_t<T>;
+
+    static constexpr auto header {
+        detail::header_bytes<format_code<T>, sizeof(Value)>};
+
+    static constexpr std::size_t min_size {header.size() + sizeof(Value)};
+
+    static constexpr std::optional<std::size_t> fixed_size {min_size};
+
+    template <typename V>
+    static std::optional<std::size_t> CalcSize(const V&) noexcept {
+        return fixed_size;
+    }
+
+    template <typename V>
+    static std::size_t Write(const V& val,
+                             const std::span<std::byte> buf) noexcept {
+        std::memcpy(buf.data(), header.data(), header.size());
+        codec::StoreScalar(static_cast<Value>(val),
+                            buf.subspan(header.size()));
+        return *fixed_size;
+    }
+
+    static detail::Decoded<Value> Read(const std::span<const std::byte> bytes,
+                                       detail::ReadContext& ctx) noexcept {
+        if (const auto added {detail::AddElem(ctx)}; !added.has_value())
+            [[unlikely]] {
+            return std::unexpected {added.error()};
+        }
+
+        if (bytes.size() >= *fixed_size
+            && std::memcmp(bytes.data(), header.data(), header.size()) == 0)
+            [[likely]] {
+            return std::pair {
+                codec::LoadScalar<Value>(bytes.subspan(header.size())),
+                *fixed_size};
+        }
+
+        // Headers with more length bytes than required are also valid.
+        const auto read {detail::ReadHeader(bytes, format_code<T>)};
+        if (!read.has_value()) [[unlikely]] {
+            return std::unexpected {read.error()};
+        } else if (read->len != sizeof(Value)) [[unlikely]] {
+            return std::unexpected {detail::MakeMismatchedLengthError(
+                format_code<T>, sizeof(Value), read->len)};
+        }
+
+        return std::pair {codec::LoadScalar<Value>(bytes.subspan(read->size)),
+                          read->size + read->len};
+    }
+};
+
+/**
+ * @brief A list with a fixed number of elements of fixed schemas, decoded as a @p std::tuple.
+ *
+ * @details
+ * It can be serialized from any tuple-like value with the same number of elements,
+ * such as the result of @p std::tie over the fields of a structure.
+ * Its header is built at compile time.
+ */
+template <typename... Es>
+struct L {
+    using Value = std::tuple<typename Es::Value...>;
+
+    static constexpr auto header {
+        detail::header_bytes<Type::List, sizeof...(Es)>};
+
+    static constexpr std::size_t min_size {
+        (header.size() + ... + Es::min_size)};
+
+    static constexpr std::optional<std::size_t> fixed_size {[] {
+        std::optional<std::size_t> size {header.size()};
+        ((size = size.has_value() && Es::fixed_size.has_value()
+                     ? std::make_optional(*size + *Es::fixed_size)
+                     : std::nullopt),
+         ...);
+        return size;
+    }()};
+
+    template <typename V>
+    static std::optional<std::size_t> CalcSize(const V& val) noexcept {
+        if constexpr (fixed_size.has_value()) {
+            return fixed_size;
+        } else {
+            CheckArity<V>();
+            return [&val]<std::size_t... Is>(std::index_sequence<Is...>)
+                       -> std::optional<std::size_t> {
+                std::optional<std::size_t> size {header.size()};
+                ((size = size.and_then([&val](const std::size_t prev) noexcept {
+                      return Es::CalcSize(std::get<Is>(val))
+                          .transform([prev](const std::size_t elem) noexcept {
+                              return prev + elem;
+                          });
+                  })),
+                 ...);
+                return size;
+            }(std::index_sequence_for<Es...> {});
+        }
+    }
+
+    template <typename V>
+    static std::size_t Write(const V& val,
+                             const std::span<std::byte> buf) noexcept {
+        CheckArity<V>();
+        std::memcpy(buf.data(), header.data(), header.size());
+        auto size {header.size()};
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) noexcept {
+            ((size += Es::Write(std::get<Is>(val), buf.subspan(size))), ...);
+        }(std::index_sequence_for<Es...> {});
+        return size;
+    }
+
+    static detail::Decoded<Value> Read(const std::span<const std::byte> bytes,
+                                       detail::ReadContext& ctx) noexcept {
+        auto size {header.size()};
+        if (bytes.size() < header.size()
+            || std::memcmp(bytes.data(), header.data(), header.size()) != 0)
+            [[unlikely]] {
+            const auto read {detail::ReadHeader(bytes, Type::List)};
+            if (!read.has_value()) [[unlikely]] {
+                return std::unexpected {read.error()};
+            } else if (read->len != sizeof...(Es)) [[unlikely]] {
+                return std::unexpected {detail::MakeMismatchedLengthError(
+                    Type::List, sizeof...(Es), read->len)};
+            }
+
+            size = read->size;
+        }
+
+        if (const auto added {detail::AddElem(ctx)}; !added.has_value())
+            [[unlikely]] {
+            return std::unexpected {added.error()};
+        } else if (const auto entered {detail::EnterList(ctx)};
+                   !entered.has_value()) [[unlikely]] {
+            return std::unexpected {entered.error()};
+        }
+
+        Value val;
+        std::optional<Error> err;
+        [&]<std::size_t... Is>(std::index_sequence<Is...>) noexcept {
+            // Elements are read in order and reading stops at the first error.
+            (... && [&] {
+                auto elem {Es::Read(bytes.subspan(size), ctx)};
+                if (!elem.has_value()) [[unlikely]] {
+                    err = std::move(elem).error();
+                    return false;
+                }
+
+                std::get<Is>(val) = std::move(elem->first);
+                size += elem->second;
+                return true;
+            }());
+        }(std::index_sequence_for<Es...> {});
+
+        --ctx.depth;
+        if (err.has_value()) [[unlikely]] {
+            return std::unexpected {std::move(*err)};
+        }
+
+        return std::pair {std::move(val), size};
+    }
+
+private:
+    template <typename V>
+    static constexpr void CheckArity() noexcept {
+        static_assert(std::tuple_size_v<std::remove_cvref_t<V>>
+                          == sizeof...(Es),
+                      "The number of values does not match the schema");
+    }
+};
+
+/**
+ * @brief A list with any number of elements of the same schema, decoded as a @p std::vector.
+ *
+ * @details It can be serialized from any sized range of values.
+ */
+template <typename E>
+struct ListOf {
+    using Value = std::vector<typename E::Value>;
+
+    static constexpr std::size_t min_size {codec::min_elem_size};
+
+    static constexpr std::optional<std::size_t> fixed_size {std::nullopt};
+
+    template <typename V>
+    static std::optional<std::size_t> CalcSize(const V& val) noexcept {
+        auto size {codec::CalcHeaderSize(std::ranges::size(val))};
+        for (const auto& elem : val) {
+            if (!size.has_value()) [[unlikely]] {
+                break;
+            }
+
+            const auto elem_size {E::CalcSize(elem)};
+            size = elem_size.has_value()
+                     ? std::make_optional(*size + *elem_size)
+                     : std::nullopt;
+        }
+        return size;
+    }
+
+    template <typename V>
+    static std::size_t Write(const V& val,
+                             const std::span<std::byte> buf) noexcept {
+        auto size {codec::WriteHeader(Type::List, std::ranges::size(val), buf)};
+        for (const auto& elem : val) {
+            size += E::Write(elem, buf.subspan(size));
+        }
+        return size;
+    }
+
+    static detail::Decoded<Value> Read(const std::span<const std::byte> bytes,
+                                       detail::ReadContext& ctx) noexcept {
+        const auto header {detail::ReadHeader(bytes, Type::List)};
+        if (!header.has_value()) [[unlikely]] {
+            return std::unexpected {header.error()};
+        }
+
+        const auto capacity {codec::CapListCapacity(
+            header->len, bytes.size() - header->size, E::min_size)};
+        if (const auto added {detail::AddElem(ctx)}; !added.has_value())
+            [[unlikely]] {
+            return std::unexpected {added.error()};
+        } else if (const auto reserved {detail::AddAllocSize(
+                       ctx, Type::List, capacity * sizeof(typename E::Value))};
+                   !reserved.has_value()) [[unlikely]] {
+            return std::unexpected {reserved.error()};
+        } else if (const auto entered {detail::EnterList(ctx)};
+                   !entered.has_value()) [[unlikely]] {
+            return std::unexpected {entered.error()};
+        }
+
+        Value vals;
+        vals.reserve(capacity);
+        auto size {header->size};
+        for (std::size_t i {0}; i != header->len; ++i) {
+            auto elem {E::Read(bytes.subspan(size), ctx)};
+            if (!elem.has_value()) [[unlikely]] {
+                --ctx.depth;
+                return std::unexpected {std::move(elem).error()};
+            }
+
+            vals.push_back(std::move(elem->first));
+            size += elem->second;
+        }
+
+        --ctx.depth;
+        return std::pair {std::move(vals), size};
+    }
+};
+
+//! An element of any shape, decoded as a dynamic @ref Message::Value.
+struct Any {
+    using Value = Message::Value;
+
+    static constexpr std::size_t min_size {codec::min_elem_size};
+
+    static constexpr std::optional<std::size_t> fixed_size {std::nullopt};
+
+    static std::optional<std::size_t> CalcSize(const Value& val) noexcept {
+        return detail::CalcEncodedSize(val);
+    }
+
+    static std::size_t Write(const Value& val,
+                             const std::span<std::byte> buf) noexcept {
+        return detail::WriteMsgBytes(val, buf);
+    }
+
+    static detail::Decoded<Value> Read(const std::span<const std::byte> bytes,
+                                       detail::ReadContext& ctx) noexcept {
+        return detail::LoadMsgBytes(bytes, ctx);
+    }
+};
+
+//! An ASCII item.
+using A = Array<ASCII>;
+
+//! A binary item.
+using B = Array<Binary>;
+
+}  // namespace secs2::schema
+
+namespace secs2 {
+
+/**
+ * @brief A compile-time schema of a SECS-II message.
+ *
+ * @details
+ * Serialization and deserialization are generated for the shape of the message,
+ * so no @ref Message is built, and headers with fixed lengths are built at compile time.
+ * The bytes are the same as those of the equivalent @ref Message.
+ *
+ * ```c++
+ * using namespace schema;
+ *
+ * // S1F13: L[2] <A MDLN> <A SOFTREV>
+ * using S1F13 = Schema<L<A, A>>;
+ *
+ * const auto bytes {S1F13::ToBytes({"MDLN-A", "1.0.0"})};
+ * const auto [mdln, softrev] {S1F13::BuildFromBytes(*bytes)->first};
+ * ```
+ *
+ * Messages of unknown shapes can be handled by @ref schema::Any or by @ref Message::BuildFromBytes
+ * when @ref BuildFromBytes returns an error.
+ *
+ * @tparam S The schema of the root, such as @ref schema::L or @ref schema::Scalar.
+ */
+template <typename S>
+class Schema {
+public:
+    //! The decoded value.
+    using Value = typename S::Value;
+
+    //! The smallest encoded size of a value.
+    static constexpr std::size_t min_size {S::min_size};
+
+    //! The encoded size if it is the same for all values.
+    static constexpr std::optional<std::size_t> fixed_size {S::fixed_size};
+
+    /**
+     * @brief Calculate the encoded size of a value.
+     *
+     * @return The size in bytes, or @p std::nullopt if a length exceeds @ref Message::max_length.
+     */
+    template <typename V = Value>
+    static std::optional<std::size_t> GetEncodedSize(const V& val) noexcept {
+        return S::CalcSize(val);
+    }
+
+    /**
+     * @brief Serialize a value.
+     *
+     * @return The same as @ref Message::ToBytes.
+     */
+    template <typename V = Value>
+    static std::optional<std::vector<std::byte>> ToBytes(
+        const V& val) noexcept {
+        const auto size {S::CalcSize(val)};
+        if (!size.has_value()) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        std::vector<std::byte> bytes(*size);
+        S::Write(val, bytes);
+        return bytes;
+    }
+
+    /**
+     * @brief Serialize a value into a buffer.
+     *
+     * @return The same as @ref Message::SerializeInto.
+     */
+    template <typename V = Value>
+    static std::expected<std::size_t, Error> SerializeInto(
+        const V& val, const std::span<std::byte> buf) noexcept {
+        const auto size {S::CalcSize(val)};
+        if (!size.has_value()) [[unlikely]] {
+            return std::unexpected {schema::detail::MakeExceededLengthError()};
+        } else if (buf.size() < *size) [[unlikely]] {
+            return std::unexpected {
+                schema::detail::MakeInsufficientBufferError(*size, buf.size())};
+        }
+
+        return S::Write(val, buf);
+    }
+
+    /**
+     * @brief Deserialize a value from a buffer.
+     *
+     * @param opts Limits on the resources used by the whole message.
+     * @return
+     * The value and its size in bytes if successful.
+     * Otherwise the same errors as @ref Message::BuildFromBytes or:
+     * - @p std::errc::invalid_argument
+     *   - An element is not of the type in the schema.
+     *   - The length of a list or a scalar does not match the schema.
+     */
+    static std::expected<std::pair<Value, std::size_t>, Error> BuildFromBytes(
+        const std::span<const std::byte> bytes,
+        const DecodeOptions& opts = {}) noexcept {
+        schema::detail::ReadContext ctx {.opts = opts};
+        return S::Read(bytes, ctx);
+    }
+};
+
+}  // namespace secs2
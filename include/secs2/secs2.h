@@ -12,19 +12,35 @@
 
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <deque>
 #include <expected>
 #include <format>
+#include <functional>
+#include <initializer_list>
 #include <iostream>
+#include <iterator>
+#include <limits>
 #include <optional>
+#include <ranges>
 #include <span>
 #include <string>
+#include <string_view>
 #include <system_error>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
 
+#ifdef SECS2_USE_PMR
+#include <memory_resource>
+#endif
+
+#ifdef SECS2_SMALL_VECTOR
+#include "small_vector.h"
+#endif
+
 namespace secs2 {
 
 //! The types and format codes of SECS-II data.
@@ -68,37 +84,117 @@ enum class Type : std::uint8_t {
     Unknown = 0b111111
 };
 
+/**
+ * @brief The containers storing SECS-II values.
+ *
+ * @details
+ * If @p SECS2_USE_PMR is defined, they use polymorphic allocators,
+ * so a whole message can be allocated from a single memory resource such as an arena.
+ * If @p SECS2_SMALL_VECTOR is defined, short numeric and binary values are stored inline.
+ */
+namespace container {
+
+#ifdef SECS2_USE_PMR
+template <typename T>
+using Vector = std::pmr::vector<T>;
+
+template <typename T>
+using Deque = std::pmr::deque<T>;
+
+using String = std::pmr::string;
+#else
+template <typename T>
+using Vector = std::vector<T>;
+
+template <typename T>
+using Deque = std::deque<T>;
+
+using String = std::string;
+#endif
+
+#ifdef SECS2_SMALL_VECTOR
+//! The number of bytes of values stored inline in a numeric or binary item.
+inline constexpr std::size_t item_inline_size {16};
+
+/**
+ * @brief The container of numeric and binary values.
+ *
+ * @details
+ * Up to @ref item_inline_size bytes of values are stored inline,
+ * so most single-value items do not allocate memory.
+ */
+template <typename T>
+using ItemVector = SmallVector<T, item_inline_size / sizeof(T),
+                               typename Vector<T>::allocator_type>;
+#else
+//! The container of numeric and binary values.
+template <typename T>
+using ItemVector = Vector<T>;
+#endif
+
+}  // namespace container
+
 //! Binary bytes.
-using Binary = std::vector<std::byte>;
+using Binary = container::ItemVector<std::byte>;
+
+#ifdef SECS2_COMPACT_BOOLEAN
+/**
+ * @brief A boolean value stored in a single byte.
+ *
+ * @details
+ * It is always stored as @p 0 or @p 1 like a serialized boolean value,
+ * so contiguous values can be copied from and to bytes directly.
+ */
+class Bool {
+public:
+    constexpr Bool() noexcept = default;
 
+    constexpr Bool(const bool val) noexcept :
+        val_ {static_cast<std::uint8_t>(val)} {}
+
+    constexpr operator bool() const noexcept {
+        return val_ != 0;
+    }
+
+private:
+    std::uint8_t val_ {0};
+};
+
+static_assert(sizeof(Bool) == sizeof(std::byte));
+static_assert(std::is_trivially_copyable_v<Bool>);
+
+//! Boolean values stored contiguously.
+using Boolean = container::Vector<Bool>;
+#else
 //! Boolean values.
-using Boolean = std::deque<bool>;
+using Boolean = container::Deque<bool>;
+#endif
 
 //! An ASCII character string.
-using ASCII = std::string;
+using ASCII = container::String;
 
 //! 1-byte signed integers.
-using I1 = std::vector<std::int8_t>;
+using I1 = container::ItemVector<std::int8_t>;
 //! 2-byte signed integers.
-using I2 = std::vector<std::int16_t>;
+using I2 = container::ItemVector<std::int16_t>;
 //! 4-byte signed integers.
-using I4 = std::vector<std::int32_t>;
+using I4 = container::ItemVector<std::int32_t>;
 //! 8-byte signed integers.
-using I8 = std::vector<std::int64_t>;
+using I8 = container::ItemVector<std::int64_t>;
 
 //! 1-byte unsigned integers.
-using U1 = std::vector<std::uint8_t>;
+using U1 = container::ItemVector<std::uint8_t>;
 //! 2-byte unsigned integers.
-using U2 = std::vector<std::uint16_t>;
+using U2 = container::ItemVector<std::uint16_t>;
 //! 4-byte unsigned integers.
-using U4 = std::vector<std::uint32_t>;
+using U4 = container::ItemVector<std::uint32_t>;
 //! 8-byte unsigned integers.
-using U8 = std::vector<std::uint64_t>;
+using U8 = container::ItemVector<std::uint64_t>;
 
 //! 4-byte floating points.
-using F4 = std::vector<float>;
+using F4 = container::ItemVector<float>;
 //! 8-byte floating points.
-using F8 = std::vector<double>;
+using F8 = container::ItemVector<double>;
 
 //! A single SECS-II item, excluding lists.
 using Item = std::variant<Binary, ASCII, Boolean, I1, I2, I4, I8, U1, U2, U4,
@@ -110,24 +206,143 @@ class List;
 using ListElem = std::variant<Item, List>;
 
 //! A SECS-II list that can contain nested items and lists.
-class List : public std::vector<ListElem> {};
+class List : public container::Vector<ListElem> {
+#ifdef SECS2_USE_PMR
+public:
+    List() noexcept = default;
+
+    //! Construct an empty list that allocates memory from a memory resource.
+    explicit List(const allocator_type& alloc) noexcept : vector {alloc} {}
+#endif
+};
+
+//! Map types to format codes.
+template <typename T>
+inline constexpr Type format_code {Type::Unknown};
+
+#define MAP_FORMAT_TYPE_TO_CODE(type) \
+    template <>                       \
+    inline constexpr Type format_code<type> {Type::type};
+
+MAP_FORMAT_TYPE_TO_CODE(Binary)
+MAP_FORMAT_TYPE_TO_CODE(ASCII)
+MAP_FORMAT_TYPE_TO_CODE(List)
+MAP_FORMAT_TYPE_TO_CODE(Boolean)
+MAP_FORMAT_TYPE_TO_CODE(I1)
+MAP_FORMAT_TYPE_TO_CODE(I2)
+MAP_FORMAT_TYPE_TO_CODE(I4)
+MAP_FORMAT_TYPE_TO_CODE(I8)
+MAP_FORMAT_TYPE_TO_CODE(U1)
+MAP_FORMAT_TYPE_TO_CODE(U2)
+MAP_FORMAT_TYPE_TO_CODE(U4)
+MAP_FORMAT_TYPE_TO_CODE(U8)
+MAP_FORMAT_TYPE_TO_CODE(F4)
+MAP_FORMAT_TYPE_TO_CODE(F8)
+
+#undef MAP_FORMAT_TYPE_TO_CODE
+
+/**
+ * @brief A function object combining multiple callable types.
+ *
+ * @details
+ * It builds a visitor from lambdas for @ref VisitValue.
+ */
+template <typename... Fs>
+struct Overload : Fs... {
+    template <typename... Ts>
+    explicit Overload(Ts&&... ts) : Fs {std::forward<Ts>(ts)}... {}
+
+    using Fs::operator()...;
+};
+
+template <typename... Ts>
+Overload(Ts&&...) -> Overload<std::remove_reference_t<Ts>...>;
+
+/**
+ * @brief Get a pointer to the raw value of a SECS-II item or list without copying.
+ *
+ * @return The pointer to the value if it is of type @p T, otherwise @p nullptr.
+ */
+template <typename T>
+const T* GetItemPtr(const ListElem& elem) noexcept {
+    if constexpr (std::same_as<T, List>) {
+        return std::get_if<List>(&elem);
+    } else if (const auto item {std::get_if<Item>(&elem)}; item != nullptr) {
+        return std::get_if<T>(item);
+    } else {
+        return nullptr;
+    }
+}
+
+//! @overload
+template <typename T>
+T* GetItemPtr(ListElem& elem) noexcept {
+    return const_cast<T*>(GetItemPtr<T>(std::as_const(elem)));
+}
 
 //! Get the raw value of a SECS-II item.
 template <typename T>
 std::optional<T> GetItemValue(const ListElem& elem) noexcept {
-    if constexpr (std::same_as<T, List>) {
-        if (std::holds_alternative<List>(elem)) {
-            return std::get<List>(elem);
-        }
+    if (const auto val {GetItemPtr<T>(elem)}; val != nullptr) {
+        return *val;
     } else {
-        if (std::holds_alternative<Item>(elem)) {
-            if (const auto& item {std::get<Item>(elem)};
-                std::holds_alternative<T>(item)) {
-                return std::get<T>(item);
-            }
-        }
+        return std::nullopt;
+    }
+}
+
+/**
+ * @brief Get a view of the elements of a SECS-II item without copying.
+ *
+ * @tparam T The type of an item whose elements are stored contiguously, such as @ref U4 or @ref Binary.
+ * @return The elements if the item is of type @p T, otherwise @p std::nullopt.
+ */
+template <std::ranges::contiguous_range T>
+std::optional<std::span<const std::ranges::range_value_t<T>>> GetItemSpan(
+    const ListElem& elem) noexcept {
+    if (const auto val {GetItemPtr<T>(elem)}; val != nullptr) {
+        return std::span {*val};
+    } else {
+        return std::nullopt;
     }
-    return std::nullopt;
+}
+
+/**
+ * @brief Visit the raw value of a SECS-II item or list without copying.
+ *
+ * @details
+ * The visitor is called with a constant reference to the value of its own type,
+ * such as @ref List or @ref U4, instead of a nested variant.
+ *
+ * ```c++
+ * VisitValue(elem, Overload {[](const List& list) {}, [](const auto& item) {}});
+ * ```
+ *
+ * @return The result of the visitor.
+ */
+template <typename Visitor>
+decltype(auto) VisitValue(const ListElem& elem, Visitor&& visitor) {
+    if (const auto list {std::get_if<List>(&elem)}; list != nullptr) {
+        return std::invoke(std::forward<Visitor>(visitor), *list);
+    } else {
+        return std::visit(std::forward<Visitor>(visitor), std::get<Item>(elem));
+    }
+}
+
+/**
+ * @brief Find a nested element of a SECS-II list without copying.
+ *
+ * @param elem An item or list.
+ * @param path The indices of elements from @p elem. An empty path refers to @p elem itself.
+ * @return The pointer to the element, or @p nullptr if the path does not exist.
+ */
+const ListElem* FindElem(const ListElem& elem,
+                         std::span<const std::size_t> path) noexcept;
+
+//! @overload
+inline const ListElem* FindElem(
+    const ListElem& elem,
+    const std::initializer_list<std::size_t> path) noexcept {
+    return FindElem(elem, std::span {path.begin(), path.size()});
 }
 
 //! The error with an error code and a human-readable message.
@@ -135,9 +350,92 @@ using Error = std::pair<std::error_code, std::string>;
 
 class Message;
 
+namespace detail {
+
+//! A callback receiving consecutive chunks of serialized bytes with a context.
+using ChunkSink = void (*)(void* ctx, std::span<const std::byte> bytes) noexcept;
+
+/**
+ * @brief Pass the bytes of a message to a callback chunk by chunk.
+ *
+ * @details
+ * It is the encoder of the library exported for @ref Message::SerializeInto with an output iterator.
+ * The callback is a plain function pointer, which is called once per header or value chunk.
+ *
+ * @param val A message whose lengths do not exceed the maximum allowed length.
+ */
+void EmitMsgBytes(const ListElem& val, ChunkSink sink, void* ctx) noexcept;
+
+}  // namespace detail
+
+//! A callable receiving consecutive chunks of serialized bytes.
+using ByteSink = std::function<void(std::span<const std::byte>)>;
+
 //! The deserialized message from bytes and the number of bytes consumed.
 using DeserializedMessage = std::pair<Message, std::size_t>;
 
+/**
+ * @brief Options for formatting SML (SECS Message Language) strings.
+ *
+ * @details
+ * Limits bound the output for huge messages. Formatting stops as soon as a limit is reached,
+ * and elided elements are printed as @p "... (N more)" instead of being formatted.
+ */
+struct SmlOptions {
+    //! The number of spaces to use for indentation.
+    std::size_t indent_width {4};
+
+    //! The maximum number of elements formatted for each item or list.
+    std::size_t max_elem_count {std::numeric_limits<std::size_t>::max()};
+
+    /**
+     * @brief The maximum number of nested list levels whose elements are formatted.
+     *
+     * @details
+     * Lists below this depth only have their headers formatted.
+     */
+    std::size_t max_depth {std::numeric_limits<std::size_t>::max()};
+
+    /**
+     * @brief The maximum number of characters after which no more elements are formatted.
+     *
+     * @details
+     * It is a soft limit checked before each element,
+     * so the element crossing it and the closing brackets are still written.
+     */
+    std::size_t max_size {std::numeric_limits<std::size_t>::max()};
+};
+
+/**
+ * @brief Limits on the resources used to deserialize a message.
+ *
+ * @details
+ * They protect against malformed or hostile input, whose headers can declare far more elements than it contains.
+ */
+struct DecodeOptions {
+    /**
+     * @brief The maximum number of nested list levels.
+     *
+     * @details
+     * A single item has no level and a list of items has one level.
+     * Lists are deserialized recursively, so this limit also bounds the stack usage.
+     * The default is far deeper than any real message but stops hostile input from exhausting the stack.
+     */
+    std::size_t max_depth {64};
+
+    //! The maximum number of items and lists in total, including nested ones.
+    std::size_t max_elem_count {std::numeric_limits<std::size_t>::max()};
+
+    /**
+     * @brief The maximum number of bytes reserved for values in total.
+     *
+     * @details
+     * It counts the elements of items and the capacities of lists,
+     * regardless of whether they are stored inline or on the heap.
+     */
+    std::size_t max_alloc_size {std::numeric_limits<std::size_t>::max()};
+};
+
 //! A SECS-II message containing a single item or a list of items.
 class Message {
 public:
@@ -171,6 +469,64 @@ public:
     static std::expected<DeserializedMessage, Error> BuildFromBytes(
         std::span<const std::byte>) noexcept;
 
+    /**
+     * @brief Deserialize a message from a sequence of bytes within limits.
+     *
+     * @param opts Limits on the resources used.
+     * @return
+     * The same as the overload without options or:
+     * - @p std::errc::value_too_large: A limit is exceeded.
+     */
+    static std::expected<DeserializedMessage, Error> BuildFromBytes(
+        std::span<const std::byte>, const DecodeOptions& opts) noexcept;
+
+#ifdef SECS2_USE_PMR
+    /**
+     * @brief Deserialize a message from a sequence of bytes into a memory resource.
+     *
+     * @details
+     * All containers of the message are allocated from @p resource,
+     * which must outlive the message. A monotonic buffer resource lets a whole message be released at once.
+     *
+     * @param opts Limits on the resources used.
+     * @return The same as the overload without a memory resource.
+     */
+    static std::expected<DeserializedMessage, Error> BuildFromBytes(
+        std::span<const std::byte>, std::pmr::memory_resource* resource,
+        const DecodeOptions& opts = {}) noexcept;
+#endif
+
+    /**
+     * @brief Check whether a sequence of bytes starts with a valid message without deserializing it.
+     *
+     * @details
+     * It performs exactly the same checks on the format as @ref BuildFromBytes without allocating memory,
+     * but applies no limit of @ref DecodeOptions.
+     * Headers are read in a single loop instead of recursively,
+     * so deeply nested input cannot overflow the stack.
+     *
+     * @return
+     * The number of bytes of the message if it is valid.
+     * Otherwise the same errors as @ref BuildFromBytes.
+     */
+    static std::expected<std::size_t, Error> Validate(
+        std::span<const std::byte>) noexcept;
+
+    /**
+     * @brief Parse a message from a SML (SECS Message Language) string.
+     *
+     * @details
+     * It accepts the output of @ref ToSml with any whitespace between tokens.
+     * The number of elements in brackets, such as @p [2], is optional but must be correct if present.
+     * Integers can be decimal or hexadecimal with a @p 0x prefix.
+     *
+     * @return
+     * The message if successful, otherwise @p std::errc::invalid_argument
+     * with the offset of the invalid character in the error message.
+     */
+    static std::expected<Message, Error> BuildFromSml(
+        std::string_view) noexcept;
+
     //! Construct a message from a given value.
     explicit Message(Value val) noexcept;
 
@@ -195,6 +551,40 @@ public:
         return GetItemValue<T>(val_);
     }
 
+    //! Get a pointer to the raw stored value without copying, or @p nullptr if it is not of type @p T.
+    template <typename T>
+    const T* GetValuePtr() const noexcept {
+        return GetItemPtr<T>(val_);
+    }
+
+    //! Get a view of the elements of the stored item without copying.
+    template <std::ranges::contiguous_range T>
+    std::optional<std::span<const std::ranges::range_value_t<T>>> GetValueSpan()
+        const noexcept {
+        return GetItemSpan<T>(val_);
+    }
+
+    //! Same as @ref secs2::VisitValue for the stored value.
+    template <typename Visitor>
+    decltype(auto) Visit(Visitor&& visitor) const {
+        return VisitValue(val_, std::forward<Visitor>(visitor));
+    }
+
+    //! Same as @ref secs2::FindElem for the stored value.
+    const Value* FindElem(std::span<const std::size_t> path) const noexcept;
+
+    //! @overload
+    const Value* FindElem(std::initializer_list<std::size_t> path) const noexcept;
+
+    /**
+     * @brief Get the number of bytes of the message after serialization.
+     *
+     * @return
+     * The exact size of the result of @ref ToBytes if the length does not exceed @ref max_length,
+     * otherwise @p std::nullopt.
+     */
+    std::optional<std::size_t> GetEncodedSize() const noexcept;
+
     /**
      * @brief Serialize the message to a sequence of bytes.
      *
@@ -226,9 +616,64 @@ public:
      * @return
      * A sequence of bytes if the length does not exceed @ref max_length,
      * otherwise @p std::nullopt.
+     *
+     * @note The bytes are written into a single buffer of @ref GetEncodedSize bytes.
      */
     std::optional<std::vector<std::byte>> ToBytes() const noexcept;
 
+    /**
+     * @brief Serialize the message into a caller-provided buffer.
+     *
+     * @details The format is the same as @ref ToBytes.
+     *
+     * @return
+     * The number of bytes written if successful.
+     * Otherwise a pair with an error code and a descriptive error message, and no byte is written.
+     * - @p std::errc::value_too_large: The length exceeds @ref max_length.
+     * - @p std::errc::no_buffer_space: The buffer is smaller than @ref GetEncodedSize.
+     */
+    std::expected<std::size_t, Error> SerializeInto(
+        std::span<std::byte> buf) const noexcept;
+
+    /**
+     * @brief Serialize the message and pass the bytes to a sink chunk by chunk.
+     *
+     * @details
+     * The format is the same as @ref ToBytes. No intermediate buffer is allocated.
+     *
+     * @return
+     * The number of bytes passed to the sink if successful.
+     * Otherwise a pair with an error code and a descriptive error message, and the sink is not called.
+     * - @p std::errc::value_too_large: The length exceeds @ref max_length.
+     */
+    std::expected<std::size_t, Error> SerializeInto(
+        const ByteSink& sink) const noexcept;
+
+    /**
+     * @brief Serialize the message to an output iterator.
+     *
+     * @return
+     * The iterator past the last byte written if successful.
+     * Otherwise the same errors as @ref SerializeInto with a sink.
+     */
+    template <std::output_iterator<std::byte> Out>
+    std::expected<Out, Error> SerializeInto(Out out) const noexcept {
+        if (const auto checked {CheckEncodedSize()}; !checked.has_value())
+            [[unlikely]] {
+            return std::unexpected {checked.error()};
+        }
+
+        detail::EmitMsgBytes(
+            val_,
+            [](void* const ctx,
+               const std::span<const std::byte> bytes) noexcept {
+                auto& out {*static_cast<Out*>(ctx)};
+                out = std::ranges::copy(bytes, std::move(out)).out;
+            },
+            &out);
+        return out;
+    }
+
     /**
      * @brief Format the message to a SML (SECS Message Language) string.
      *
@@ -236,6 +681,28 @@ public:
      */
     std::string ToSml(std::size_t indent_width = 4) const noexcept;
 
+    /**
+     * @brief Format the message to a SML (SECS Message Language) string within limits.
+     *
+     * @param opts Formatting options.
+     */
+    std::string ToSml(const SmlOptions& opts) const noexcept;
+
+    /**
+     * @brief Format the message to a SML (SECS Message Language) string and append it to a buffer.
+     *
+     * @details
+     * Reusing a buffer across messages avoids allocating memory for each of them.
+     *
+     * @param buf A buffer.
+     * @param indent_width The number of spaces to use for indentation.
+     */
+    void AppendSml(std::string& buf,
+                   std::size_t indent_width = 4) const noexcept;
+
+    //! @overload
+    void AppendSml(std::string& buf, const SmlOptions& opts) const noexcept;
+
     //! Swaps this message with another.
     void swap(Message&) noexcept;
 
@@ -243,6 +710,9 @@ public:
     bool operator==(const Message&) const noexcept = default;
 
 private:
+    //! Check that no length exceeds @ref max_length.
+    std::expected<void, Error> CheckEncodedSize() const noexcept;
+
     Value val_;
 };
 
@@ -253,12 +723,61 @@ void swap(Message&, Message&) noexcept;
 std::expected<DeserializedMessage, Error> BuildMsgFromBytes(
     std::span<const std::byte>) noexcept;
 
+//! Same as @ref Message::BuildFromBytes.
+std::expected<DeserializedMessage, Error> BuildMsgFromBytes(
+    std::span<const std::byte>, const DecodeOptions& opts) noexcept;
+
+#ifdef SECS2_USE_PMR
+//! Same as @ref Message::BuildFromBytes.
+std::expected<DeserializedMessage, Error> BuildMsgFromBytes(
+    std::span<const std::byte>, std::pmr::memory_resource* resource,
+    const DecodeOptions& opts = {}) noexcept;
+#endif
+
+//! Same as @ref Message::Validate.
+std::expected<std::size_t, Error> ValidateMsgBytes(
+    std::span<const std::byte>) noexcept;
+
+/**
+ * @brief Format a serialized message to a SML (SECS Message Language) string without deserializing it.
+ *
+ * @details
+ * The bytes are read and formatted in a single pass, and no message is built.
+ * The result is the same as @ref Message::ToSml of the deserialized message.
+ *
+ * @param indent_width The number of spaces to use for indentation.
+ * @return The SML string if successful, otherwise the same errors as @ref Message::BuildFromBytes.
+ */
+std::expected<std::string, Error> BuildSmlFromBytes(
+    std::span<const std::byte>, std::size_t indent_width = 4) noexcept;
+
+/**
+ * @brief Format a serialized message to a SML (SECS Message Language) string within limits without deserializing it.
+ *
+ * @details
+ * Elided elements are skipped over without being formatted, but they are still validated.
+ *
+ * @param opts Formatting options.
+ * @return The SML string if successful, otherwise the same errors as @ref Message::BuildFromBytes.
+ */
+std::expected<std::string, Error> BuildSmlFromBytes(
+    std::span<const std::byte>, const SmlOptions& opts) noexcept;
+
+//! Same as @ref Message::BuildFromSml.
+std::expected<Message, Error> BuildMsgFromSml(std::string_view) noexcept;
+
 //! Get the raw value of a SECS-II message.
 template <typename T>
 std::optional<T> GetMsgValue(const Message::Value& val) noexcept {
     return GetItemValue<T>(val);
 }
 
+//! Get a pointer to the raw value of a SECS-II message without copying.
+template <typename T>
+const T* GetMsgValuePtr(const Message::Value& val) noexcept {
+    return GetItemPtr<T>(val);
+}
+
 //! Output the SML (SECS Message Language) string of a SECS-II message to an output stream.
 std::ostream& operator<<(std::ostream&, const Message&) noexcept;
 
@@ -277,34 +796,78 @@ std::string to_string(Type) noexcept;
  * @brief The string formatter for SECS-II messages.
  *
  * @details
- * The format specification has the form @p {indent_width}.
+ * The format specification has the form @p {indent_width}{e{elem_count}}{d{depth}}{b{size}},
+ * where every part is optional and the limits can be in any order.
+ * For example, @p "{:2e8d3b4096}" indents with 2 spaces,
+ * formats at most 8 elements per item or list, 3 list levels and about 4096 characters.
  *
- * @param indent_width The number of spaces to use for indentation (optional).
+ * @param indent_width The number of spaces to use for indentation.
+ * @param elem_count The same as @ref secs2::SmlOptions::max_elem_count.
+ * @param depth The same as @ref secs2::SmlOptions::max_depth.
+ * @param size The same as @ref secs2::SmlOptions::max_size.
  */
 template <>
 class std::formatter<secs2::Message> : std::formatter<std::string> {
 public:
-    constexpr auto parse(std::format_parse_context& ctx) noexcept {
-        const auto last_format {ctx.end() - sizeof('}') / sizeof(char)};
+    constexpr auto parse(std::format_parse_context& ctx) {
+        auto it {ctx.begin()};
+        const auto end {ctx.end()};
+        if (it != end && IsDigit(*it)) {
+            opts_.indent_width = ParseNumber(it, end);
+        }
+
+        while (it != end && *it != '}') {
+            const auto key {*it++};
+            if (it == end || !IsDigit(*it)) {
+                throw std::format_error {"Invalid format for SECS-II messages"};
+            }
 
-        try {
-            const std::string_view arg {ctx.begin(), last_format};
-            indent_width_ = std::stoul(arg.data());
-        } catch (const std::exception&) {
+            const auto num {ParseNumber(it, end)};
+            if (key == 'e') {
+                opts_.max_elem_count = num;
+            } else if (key == 'd') {
+                opts_.max_depth = num;
+            } else if (key == 'b') {
+                opts_.max_size = num;
+            } else {
+                throw std::format_error {"Invalid format for SECS-II messages"};
+            }
         }
 
-        return last_format;
+        return it;
     }
 
-    auto format(const secs2::Message&, std::format_context&) const noexcept;
+    std::format_context::iterator format(const secs2::Message&,
+                                         std::format_context&) const noexcept;
 
 private:
-    std::optional<std::size_t> indent_width_;
+    static constexpr bool IsDigit(const char c) noexcept {
+        return c >= '0' && c <= '9';
+    }
+
+    //! Parse a decimal number and advance the iterator past it.
+    static constexpr std::size_t ParseNumber(
+        std::format_parse_context::iterator& it,
+        const std::format_parse_context::iterator end) {
+        std::size_t num {0};
+        for (; it != end && IsDigit(*it); ++it) {
+            const auto digit {static_cast<std::size_t>(*it - '0')};
+            if (num > (std::numeric_limits<std::size_t>::max() - digit) / 10) {
+                throw std::format_error {
+                    "Too large number for SECS-II messages"};
+            }
+            num = num * 10 + digit;
+        }
+        return num;
+    }
+
+    secs2::SmlOptions opts_;
 };
 
 //! The string formatter for SECS-II types.
 template <>
 class std::formatter<secs2::Type> : std::formatter<std::string> {
 public:
-    auto format(secs2::Type, std::format_context&) const noexcept;
+    std::format_context::iterator format(secs2::Type,
+                                         std::format_context&) const noexcept;
 };
\ No newline at end of file
@@ -0,0 +1,500 @@
+/**
+ * @file small_vector.h
+ * @brief A vector storing a few elements inline without allocating memory.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace secs2::container {
+
+/**
+ * @brief A contiguous container that stores up to @p N elements inline.
+ *
+ * @details
+ * It has the same interface as @p std::vector for the operations used by SECS-II items.
+ * Memory is allocated only when the number of elements exceeds @p N.
+ * Elements must be trivially copyable, so they are copied and relocated as bytes.
+ *
+ * @tparam T The type of elements.
+ * @tparam N The number of elements stored inline.
+ * @tparam Alloc The allocator used after elements no longer fit inline.
+ */
+template <typename T, std::size_t N, typename Alloc = std::allocator<T>>
+    requires(std::is_trivially_copyable_v<T> && N > 0)
+class SmallVector {
+private:
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    //! The number of elements stored inline.
+    static constexpr size_type inline_capacity {N};
+
+    SmallVector() noexcept {}
+
+    explicit SmallVector(const Alloc& alloc) noexcept : alloc_ {alloc} {}
+
+    explicit SmallVector(const size_type count,
+                         const Alloc& alloc = Alloc {}) noexcept :
+        alloc_ {alloc} {
+        resize(count);
+    }
+
+    SmallVector(const size_type count, const T& val,
+                const Alloc& alloc = Alloc {}) noexcept :
+        alloc_ {alloc} {
+        assign(count, val);
+    }
+
+    template <std::input_iterator It>
+    SmallVector(const It first, const It last,
+                const Alloc& alloc = Alloc {}) noexcept :
+        alloc_ {alloc} {
+        assign(first, last);
+    }
+
+    SmallVector(const std::initializer_list<T> vals,
+                const Alloc& alloc = Alloc {}) noexcept :
+        alloc_ {alloc} {
+        assign(vals);
+    }
+
+    SmallVector(const SmallVector& other) noexcept :
+        alloc_ {AllocTraits::select_on_container_copy_construction(
+            other.alloc_)} {
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(const SmallVector& other, const Alloc& alloc) noexcept :
+        alloc_ {alloc} {
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept : alloc_ {other.alloc_} {
+        Steal(other);
+    }
+
+    SmallVector(SmallVector&& other, const Alloc& alloc) noexcept :
+        alloc_ {alloc} {
+        if (alloc_ == other.alloc_) {
+            Steal(other);
+        } else {
+            assign(other.begin(), other.end());
+            other.clear();
+        }
+    }
+
+    ~SmallVector() noexcept {
+        Release();
+    }
+
+    SmallVector& operator=(const SmallVector& other) noexcept {
+        if (this != &other) {
+            if constexpr (AllocTraits::propagate_on_container_copy_assignment::
+                              value) {
+                if (alloc_ != other.alloc_) {
+                    Release();
+                }
+
+                alloc_ = other.alloc_;
+            }
+
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+
+        if constexpr (AllocTraits::propagate_on_container_move_assignment::
+                          value) {
+            Release();
+            alloc_ = std::move(other.alloc_);
+            Steal(other);
+        } else if (alloc_ == other.alloc_) {
+            Release();
+            Steal(other);
+        } else {
+            assign(other.begin(), other.end());
+            other.clear();
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(const std::initializer_list<T> vals) noexcept {
+        assign(vals);
+        return *this;
+    }
+
+    allocator_type get_allocator() const noexcept {
+        return alloc_;
+    }
+
+    T* data() noexcept {
+        return IsInline() ? inline_ : heap_;
+    }
+
+    const T* data() const noexcept {
+        return IsInline() ? inline_ : heap_;
+    }
+
+    iterator begin() noexcept {
+        return data();
+    }
+
+    const_iterator begin() const noexcept {
+        return data();
+    }
+
+    const_iterator cbegin() const noexcept {
+        return data();
+    }
+
+    iterator end() noexcept {
+        return data() + size_;
+    }
+
+    const_iterator end() const noexcept {
+        return data() + size_;
+    }
+
+    const_iterator cend() const noexcept {
+        return data() + size_;
+    }
+
+    reverse_iterator rbegin() noexcept {
+        return reverse_iterator {end()};
+    }
+
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator {end()};
+    }
+
+    reverse_iterator rend() noexcept {
+        return reverse_iterator {begin()};
+    }
+
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator {begin()};
+    }
+
+    bool empty() const noexcept {
+        return size_ == 0;
+    }
+
+    size_type size() const noexcept {
+        return size_;
+    }
+
+    size_type max_size() const noexcept {
+        return std::min<size_type>(AllocTraits::max_size(alloc_),
+                                   std::numeric_limits<difference_type>::max());
+    }
+
+    size_type capacity() const noexcept {
+        return capacity_;
+    }
+
+    reference operator[](const size_type idx) noexcept {
+        assert(idx < size_);
+        return data()[idx];
+    }
+
+    const_reference operator[](const size_type idx) const noexcept {
+        assert(idx < size_);
+        return data()[idx];
+    }
+
+    reference front() noexcept {
+        return (*this)[0];
+    }
+
+    const_reference front() const noexcept {
+        return (*this)[0];
+    }
+
+    reference back() noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    const_reference back() const noexcept {
+        return (*this)[size_ - 1];
+    }
+
+    void reserve(const size_type count) noexcept {
+        if (count > capacity_) {
+            Reallocate(count);
+        }
+    }
+
+    void shrink_to_fit() noexcept {
+        if (!IsInline() && size_ <= N) {
+            const auto heap {heap_};
+            std::memcpy(inline_, heap, size_ * sizeof(T));
+            AllocTraits::deallocate(alloc_, heap, capacity_);
+            capacity_ = N;
+        } else if (!IsInline() && size_ < capacity_) {
+            Reallocate(size_);
+        }
+    }
+
+    void clear() noexcept {
+        size_ = 0;
+    }
+
+    void resize(const size_type count) noexcept {
+        resize(count, T {});
+    }
+
+    void resize(const size_type count, const T& val) noexcept {
+        // The value may refer to an element released by reallocation.
+        const auto val_copy {val};
+        reserve(count);
+        if (count > size_) {
+            std::uninitialized_fill(end(), data() + count, val_copy);
+        }
+
+        size_ = count;
+    }
+
+    void assign(const size_type count, const T& val) noexcept {
+        clear();
+        resize(count, val);
+    }
+
+    template <std::input_iterator It>
+    void assign(It first, const It last) noexcept {
+        clear();
+        if constexpr (std::forward_iterator<It>) {
+            const auto count {
+                static_cast<size_type>(std::ranges::distance(first, last))};
+            reserve(count);
+            std::uninitialized_copy(first, last, data());
+            size_ = count;
+        } else {
+            for (; first != last; ++first) {
+                push_back(*first);
+            }
+        }
+    }
+
+    void assign(const std::initializer_list<T> vals) noexcept {
+        assign(vals.begin(), vals.end());
+    }
+
+    void push_back(const T& val) noexcept {
+        emplace_back(val);
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) noexcept {
+        T* ptr {nullptr};
+        if (size_ == capacity_) [[unlikely]] {
+            // The arguments may refer to elements released by reallocation.
+            const T val(std::forward<Args>(args)...);
+            Reallocate(GrowCapacity(size_ + 1));
+            ptr = std::construct_at(data() + size_, val);
+        } else {
+            ptr = std::construct_at(data() + size_,
+                                    std::forward<Args>(args)...);
+        }
+
+        ++size_;
+        return *ptr;
+    }
+
+    void pop_back() noexcept {
+        assert(!empty());
+        --size_;
+    }
+
+    iterator insert(const const_iterator pos, const T& val) noexcept {
+        return insert(pos, static_cast<size_type>(1), val);
+    }
+
+    iterator insert(const const_iterator pos, const size_type count,
+                    const T& val) noexcept {
+        // The value may refer to an element, which is moved by making a gap.
+        const auto val_copy {val};
+        const auto gap {MakeGap(pos, count)};
+        std::uninitialized_fill_n(gap, count, val_copy);
+        return gap;
+    }
+
+    template <std::forward_iterator It>
+    iterator insert(const const_iterator pos, const It first,
+                    const It last) noexcept {
+        if constexpr (std::contiguous_iterator<It>) {
+            // The elements may be moved or released by making a gap.
+            if (first != last && Contains(std::to_address(first)))
+                [[unlikely]] {
+                const SmallVector vals(first, last, alloc_);
+                return insert(pos, vals.begin(), vals.end());
+            }
+        }
+
+        const auto count {
+            static_cast<size_type>(std::ranges::distance(first, last))};
+        const auto gap {MakeGap(pos, count)};
+        std::uninitialized_copy(first, last, gap);
+        return gap;
+    }
+
+    iterator insert(const const_iterator pos,
+                    const std::initializer_list<T> vals) noexcept {
+        return insert(pos, vals.begin(), vals.end());
+    }
+
+    iterator erase(const const_iterator pos) noexcept {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const const_iterator first,
+                   const const_iterator last) noexcept {
+        const auto begin_idx {static_cast<size_type>(first - begin())};
+        const auto end_idx {static_cast<size_type>(last - begin())};
+        assert(begin_idx <= end_idx && end_idx <= size_);
+        std::memmove(data() + begin_idx, data() + end_idx,
+                     (size_ - end_idx) * sizeof(T));
+        size_ -= end_idx - begin_idx;
+        return begin() + begin_idx;
+    }
+
+    void swap(SmallVector& other) noexcept {
+        assert(alloc_ == other.alloc_);
+        auto tmp {std::move(other)};
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    friend void swap(SmallVector& lhs, SmallVector& rhs) noexcept {
+        lhs.swap(rhs);
+    }
+
+    friend bool operator==(const SmallVector& lhs,
+                           const SmallVector& rhs) noexcept {
+        return std::ranges::equal(lhs, rhs);
+    }
+
+    friend auto operator<=>(const SmallVector& lhs,
+                            const SmallVector& rhs) noexcept {
+        return std::lexicographical_compare_three_way(
+            lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+private:
+    bool IsInline() const noexcept {
+        return capacity_ == N;
+    }
+
+    //! Whether a pointer refers to an element.
+    bool Contains(const T* const ptr) const noexcept {
+        return std::less_equal<> {}(data(), ptr)
+               && std::less<> {}(ptr, data() + size_);
+    }
+
+    size_type GrowCapacity(const size_type min_capacity) const noexcept {
+        return std::max(capacity_ * 2, min_capacity);
+    }
+
+    //! Move elements to a new allocation with a capacity larger than @p N.
+    void Reallocate(const size_type capacity) noexcept {
+        assert(capacity >= size_);
+        assert(capacity > N);
+        const auto heap {AllocTraits::allocate(alloc_, capacity)};
+        std::memcpy(heap, data(), size_ * sizeof(T));
+        if (!IsInline()) {
+            AllocTraits::deallocate(alloc_, heap_, capacity_);
+        }
+
+        heap_ = heap;
+        capacity_ = capacity;
+    }
+
+    //! Shift elements after a position to leave room for new elements.
+    iterator MakeGap(const const_iterator pos, const size_type count) noexcept {
+        const auto idx {static_cast<size_type>(pos - begin())};
+        assert(idx <= size_);
+        if (size_ + count > capacity_) {
+            Reallocate(GrowCapacity(size_ + count));
+        }
+
+        std::memmove(data() + idx + count, data() + idx,
+                     (size_ - idx) * sizeof(T));
+        size_ += count;
+        return begin() + idx;
+    }
+
+    //! Take the elements of another vector, which is left empty.
+    void Steal(SmallVector& other) noexcept {
+        assert(IsInline() && empty());
+        if (other.IsInline()) {
+            std::memcpy(inline_, other.inline_, other.size_ * sizeof(T));
+        } else {
+            heap_ = other.heap_;
+            capacity_ = other.capacity_;
+            other.capacity_ = N;
+        }
+
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+
+    //! Free the allocated memory and become an empty inline vector.
+    void Release() noexcept {
+        if (!IsInline()) {
+            AllocTraits::deallocate(alloc_, heap_, capacity_);
+            capacity_ = N;
+        }
+
+        size_ = 0;
+    }
+
+    size_type size_ {0};
+
+    //! The capacity, which is @p N if elements are stored inline.
+    size_type capacity_ {N};
+
+    union {
+        T* heap_ {nullptr};
+        T inline_[N];
+    };
+
+    [[no_unique_address]] Alloc alloc_ {};
+};
+
+}  // namespace secs2::container
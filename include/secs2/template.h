@@ -0,0 +1,166 @@
+/**
+ * @file template.h
+ * @brief Pre-serialized SECS-II messages whose item values can be replaced in place.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <concepts>
+#include <cstddef>
+#include <expected>
+#include <initializer_list>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace secs2 {
+
+/**
+ * @brief A serialized message with slots whose values can be replaced without serializing it again.
+ *
+ * @details
+ * A slot is an item at a path in the message.
+ * If a new value has the same length as the old one, only the bytes of the value are overwritten.
+ * Otherwise the header of the item is rebuilt and the following bytes are moved.
+ * The lengths of lists never change, as they are the numbers of elements.
+ *
+ * ```c++
+ * auto tmpl {MessageTemplate::Build(Message {U1 {0}})};
+ * const auto ack {tmpl->AddSlot({})};
+ * tmpl->Fill<U1>(*ack, 1);
+ * const auto bytes {tmpl->GetBytes()};
+ * ```
+ */
+class MessageTemplate {
+public:
+    /**
+     * @brief Serialize a message into a template without slots.
+     *
+     * @return
+     * The template if successful, otherwise a pair with an error code and a descriptive error message.
+     * - @p std::errc::value_too_large: The length exceeds @ref Message::max_length.
+     */
+    static std::expected<MessageTemplate, Error> Build(
+        const Message& msg) noexcept;
+
+    /**
+     * @brief Copy a serialized message into a template without slots.
+     *
+     * @param bytes A buffer starting from a message.
+     * @return The template if successful, otherwise the same errors as @ref Message::BuildFromBytes.
+     */
+    static std::expected<MessageTemplate, Error> BuildFromBytes(
+        std::span<const std::byte> bytes) noexcept;
+
+    /**
+     * @brief Add a slot for an item.
+     *
+     * @param path The indices of elements from the root. An empty path refers to the root.
+     * @return
+     * The index of the slot if successful, which is the index of the existing slot if the item already has one.
+     * Otherwise the same errors as @ref FindElemBytes or:
+     * - @p std::errc::invalid_argument: The element is a list.
+     */
+    std::expected<std::size_t, Error> AddSlot(
+        std::span<const std::size_t> path) noexcept;
+
+    //! @overload
+    std::expected<std::size_t, Error> AddSlot(
+        const std::initializer_list<std::size_t> path) noexcept {
+        return AddSlot(std::span {path.begin(), path.size()});
+    }
+
+    //! Get the number of slots.
+    std::size_t GetSlotCount() const noexcept;
+
+    /**
+     * @brief Replace the value of a slot with an item.
+     *
+     * @param slot The index of a slot.
+     * @param item An item of the same type as the slot.
+     * @return
+     * Nothing if successful. Otherwise a pair with an error code and a descriptive error message,
+     * and the template is unchanged.
+     * - @p std::errc::invalid_argument: The slot does not exist or the type does not match the slot.
+     * - @p std::errc::value_too_large: The length exceeds @ref Message::max_length.
+     */
+    std::expected<void, Error> Fill(std::size_t slot,
+                                    const Item& item) noexcept;
+
+    /**
+     * @brief Replace the value of a numeric or binary slot.
+     *
+     * @tparam T The type of the slot, such as @ref U4 or @ref Binary.
+     * @return The same as @ref Fill with an item.
+     */
+    template <typename T>
+        requires(!std::same_as<T, List> && !std::same_as<T, ASCII>
+                 && !std::same_as<T, Boolean>)
+    std::expected<void, Error> Fill(
+        std::size_t slot,
+        std::span<const std::ranges::range_value_t<T>> vals) noexcept;
+
+    //! @overload
+    template <typename T>
+        requires(!std::same_as<T, List> && !std::same_as<T, ASCII>
+                 && !std::same_as<T, Boolean>)
+    std::expected<void, Error> Fill(
+        const std::size_t slot,
+        const std::ranges::range_value_t<T> val) noexcept {
+        return Fill<T>(slot, std::span {&val, 1});
+    }
+
+    //! Replace the value of an ASCII slot.
+    std::expected<void, Error> FillAscii(std::size_t slot,
+                                         std::string_view chars) noexcept;
+
+    //! Replace the value of a boolean slot.
+    std::expected<void, Error> FillBoolean(
+        std::size_t slot, std::span<const bool> vals) noexcept;
+
+    //! @overload
+    std::expected<void, Error> FillBoolean(std::size_t slot,
+                                           bool val) noexcept;
+
+    //! Get the serialized message.
+    std::span<const std::byte> GetBytes() const noexcept;
+
+private:
+    //! The location of an item whose value can be replaced.
+    struct Slot {
+        //! The format code.
+        Type type {Type::Unknown};
+        //! The offset of the header from the beginning of the message.
+        std::size_t offset {0};
+        //! The size of the format byte and length bytes.
+        std::size_t header_size {0};
+        //! The number of bytes of the value.
+        std::size_t len {0};
+    };
+
+    explicit MessageTemplate(std::vector<std::byte> bytes) noexcept;
+
+    /**
+     * @brief Replace the value of a slot.
+     *
+     * @param write A function writing the new value to a buffer of @p len bytes.
+     */
+    template <typename F>
+    std::expected<void, Error> Replace(std::size_t slot, Type type,
+                                       std::size_t len, F&& write) noexcept;
+
+    std::vector<std::byte> bytes_;
+    std::vector<Slot> slots_;
+};
+
+}  // namespace secs2
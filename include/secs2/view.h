@@ -0,0 +1,217 @@
+/**
+ * @file view.h
+ * @brief Zero-copy views over serialized SECS-II data.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <cstddef>
+#include <expected>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace secs2 {
+
+/**
+ * @brief A read-only view of a serialized item or list.
+ *
+ * @details
+ * A view refers to bytes that have already been checked by @ref MessageView::BuildFromBytes.
+ * It does not own the bytes or allocate memory, and element values are only decoded when they are read.
+ * The underlying bytes must outlive the view.
+ */
+class ItemView {
+public:
+    class Iterator;
+
+    //! Construct an empty view whose type is unknown.
+    ItemView() noexcept = default;
+
+    //! Get the type of the viewed value.
+    Type GetType() const noexcept;
+
+    /**
+     * @brief Get the number of elements in the viewed value.
+     *
+     * @note
+     * For an list, it is the number of elements that is counted in terms of its direct elements only
+     * and does not take into account any nested linked lists within the elements.
+     */
+    std::size_t GetSize() const noexcept;
+
+    //! Get the serialized bytes of the viewed value, including its header.
+    std::span<const std::byte> GetBytes() const noexcept;
+
+    //! Get the serialized bytes of the viewed value, excluding its header.
+    std::span<const std::byte> GetBodyBytes() const noexcept;
+
+    /**
+     * @brief Get a direct element of a list.
+     *
+     * @return
+     * The view of the element, or @p std::nullopt if the viewed value is not a list
+     * or the index is out of range.
+     *
+     * @note Elements are located by skipping headers, so it takes linear time.
+     */
+    std::optional<ItemView> GetElem(std::size_t idx) const noexcept;
+
+    //! Get an iterator to the first direct element of a list.
+    Iterator begin() const noexcept;
+
+    //! Get an iterator past the last direct element of a list.
+    Iterator end() const noexcept;
+
+    /**
+     * @brief Decode a single element of an item.
+     *
+     * @tparam T The type of the item, such as @ref U4.
+     * @return
+     * The value of the element, or @p std::nullopt if the item is not of type @p T
+     * or the index is out of range.
+     */
+    template <typename T>
+        requires(!std::same_as<T, List>)
+    std::optional<std::ranges::range_value_t<T>> GetElemValue(
+        std::size_t idx) const noexcept;
+
+    //! Get the characters of an ASCII item without copying.
+    std::optional<std::string_view> GetASCII() const noexcept;
+
+    //! Get the bytes of a binary item without copying.
+    std::optional<std::span<const std::byte>> GetBinary() const noexcept;
+
+    //! Decode the raw value if it is of type @p T.
+    template <typename T>
+    std::optional<T> GetValue() const noexcept;
+
+    //! Decode the viewed value into an owned value.
+    Message::Value ToValue() const noexcept;
+
+    //! Decode the viewed value into an owned message.
+    Message ToMessage() const noexcept;
+
+private:
+    friend class MessageView;
+
+    /**
+     * @brief Construct a view of the first value in checked bytes.
+     *
+     * @param byte_size The size of the value in bytes, including nested elements.
+     */
+    ItemView(std::span<const std::byte> bytes, std::size_t byte_size) noexcept;
+
+    std::span<const std::byte> bytes_;
+    Type type_ {Type::Unknown};
+    std::size_t len_ {0};
+    std::size_t header_size_ {0};
+};
+
+//! A forward iterator over the direct elements of a viewed list.
+class ItemView::Iterator {
+public:
+    using value_type = ItemView;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::forward_iterator_tag;
+
+    Iterator() noexcept = default;
+
+    const ItemView& operator*() const noexcept;
+
+    const ItemView* operator->() const noexcept;
+
+    Iterator& operator++() noexcept;
+
+    Iterator operator++(int) noexcept;
+
+    bool operator==(const Iterator&) const noexcept;
+
+private:
+    friend class ItemView;
+
+    /**
+     * @param bytes The bytes starting from the first remaining element.
+     * @param count The number of remaining elements.
+     */
+    Iterator(std::span<const std::byte> bytes, std::size_t count) noexcept;
+
+    std::span<const std::byte> bytes_;
+    std::size_t count_ {0};
+    ItemView curr_;
+};
+
+static_assert(std::forward_iterator<ItemView::Iterator>);
+
+//! A read-only view of a serialized SECS-II message.
+class MessageView {
+public:
+    /**
+     * @brief Check a sequence of bytes and build a view of the message they contain.
+     *
+     * @details
+     * All headers are checked in a single pass, so subsequent access never fails due to malformed data.
+     * Lists nested deeper than the default @ref DecodeOptions::max_depth are rejected,
+     * so the view can always be decoded.
+     * No value is decoded and no memory is allocated.
+     *
+     * @return
+     * The view if successful, otherwise the same errors as @ref Message::BuildFromBytes.
+     */
+    static std::expected<MessageView, Error> BuildFromBytes(
+        std::span<const std::byte>) noexcept;
+
+    //! Get the view of the top-level item or list.
+    const ItemView& GetRoot() const noexcept;
+
+    //! Same as @ref ItemView::GetType.
+    Type GetType() const noexcept;
+
+    //! Same as @ref ItemView::GetSize.
+    std::size_t GetSize() const noexcept;
+
+    //! Get the number of bytes consumed by the message.
+    std::size_t GetByteSize() const noexcept;
+
+    //! Decode the message into an owned message.
+    Message ToMessage() const noexcept;
+
+    /**
+     * @brief Format the message to a SML (SECS Message Language) string without decoding it.
+     *
+     * @details
+     * The result is the same as @ref Message::ToSml of the decoded message.
+     *
+     * @param indent_width The number of spaces to use for indentation.
+     */
+    std::string ToSml(std::size_t indent_width = 4) const noexcept;
+
+    //! Same as @ref Message::ToSml with options.
+    std::string ToSml(const SmlOptions& opts) const noexcept;
+
+    //! Same as @ref ToSml, but append the string to a buffer.
+    void AppendSml(std::string& buf,
+                   std::size_t indent_width = 4) const noexcept;
+
+    //! @overload
+    void AppendSml(std::string& buf, const SmlOptions& opts) const noexcept;
+
+private:
+    explicit MessageView(ItemView root) noexcept;
+
+    ItemView root_;
+};
+
+}  // namespace secs2
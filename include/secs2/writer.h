@@ -0,0 +1,188 @@
+/**
+ * @file writer.h
+ * @brief Streaming serialization of SECS-II messages without building values.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ *
+ * @example tests/secs2_tests.cpp
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace secs2 {
+
+/**
+ * @brief A push-style writer serializing items and lists directly to bytes.
+ *
+ * @details
+ * Each call writes a header and a value immediately, so no @ref List or @ref Item has to be built first.
+ * Every list must be declared with its number of elements, which is checked when it is closed.
+ * Messages can be written back-to-back to the same writer.
+ *
+ * ```c++
+ * std::vector<std::byte> buf;
+ * MessageWriter writer {buf};
+ * writer.BeginList(2).WriteU4(4001).WriteAscii("LOT-1").EndList();
+ * if (!writer.Finish().has_value()) {
+ *     // Handle the error.
+ * }
+ * ```
+ *
+ * If a call fails, the writer stops writing and @ref Finish returns the first error.
+ * A buffer is restored to its original size, but bytes already passed to a sink cannot be taken back.
+ */
+class MessageWriter {
+public:
+    //! Construct a writer appending bytes to a buffer.
+    explicit MessageWriter(std::vector<std::byte>& buf) noexcept;
+
+    //! Construct a writer passing bytes to a sink chunk by chunk.
+    explicit MessageWriter(ByteSink sink) noexcept;
+
+    /**
+     * @brief Start a list.
+     *
+     * @param count The number of direct elements that will be written before @ref EndList.
+     */
+    MessageWriter& BeginList(std::size_t count) noexcept;
+
+    //! Close the innermost list, whose number of elements must match the declared one.
+    MessageWriter& EndList() noexcept;
+
+    /**
+     * @brief Write a numeric or binary item.
+     *
+     * @tparam T The type of the item, such as @ref U4 or @ref Binary.
+     */
+    template <typename T>
+        requires(!std::same_as<T, List> && !std::same_as<T, ASCII>
+                 && !std::same_as<T, Boolean>)
+    MessageWriter& WriteItem(
+        std::span<const std::ranges::range_value_t<T>> vals) noexcept;
+
+    //! Write an existing item or list.
+    MessageWriter& Write(const Message::Value& val) noexcept;
+
+    MessageWriter& WriteAscii(std::string_view chars) noexcept;
+
+    MessageWriter& WriteBinary(std::span<const std::byte> vals) noexcept;
+
+    MessageWriter& WriteBoolean(std::span<const bool> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteBoolean(bool val) noexcept;
+
+    MessageWriter& WriteI1(std::span<const std::int8_t> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteI1(std::int8_t val) noexcept;
+
+    MessageWriter& WriteI2(std::span<const std::int16_t> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteI2(std::int16_t val) noexcept;
+
+    MessageWriter& WriteI4(std::span<const std::int32_t> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteI4(std::int32_t val) noexcept;
+
+    MessageWriter& WriteI8(std::span<const std::int64_t> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteI8(std::int64_t val) noexcept;
+
+    MessageWriter& WriteU1(std::span<const std::uint8_t> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteU1(std::uint8_t val) noexcept;
+
+    MessageWriter& WriteU2(std::span<const std::uint16_t> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteU2(std::uint16_t val) noexcept;
+
+    MessageWriter& WriteU4(std::span<const std::uint32_t> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteU4(std::uint32_t val) noexcept;
+
+    MessageWriter& WriteU8(std::span<const std::uint64_t> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteU8(std::uint64_t val) noexcept;
+
+    MessageWriter& WriteF4(std::span<const float> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteF4(float val) noexcept;
+
+    MessageWriter& WriteF8(std::span<const double> vals) noexcept;
+
+    //! @overload
+    MessageWriter& WriteF8(double val) noexcept;
+
+    /**
+     * @brief Check whether all messages have been written completely.
+     *
+     * @return
+     * The number of bytes written if successful.
+     * Otherwise a pair with an error code and a descriptive error message.
+     * - @p std::errc::value_too_large: A length exceeds @ref Message::max_length.
+     * - @p std::errc::invalid_argument
+     *   - The number of elements written to a list does not match the declared one.
+     *   - A list is not closed.
+     */
+    std::expected<std::size_t, Error> Finish() const noexcept;
+
+private:
+    //! A list whose elements have not all been written yet.
+    struct Frame {
+        //! The declared number of elements.
+        std::size_t count {0};
+        //! The number of elements written.
+        std::size_t written {0};
+    };
+
+    //! Count a new element in the innermost list, or fail if the list is full.
+    bool BeginElem() noexcept;
+
+    //! Write the header of an item, or fail if the length exceeds the maximum allowed length.
+    bool WriteItemHeader(Type type, std::size_t len) noexcept;
+
+    void WriteHeader(Type type, std::size_t len) noexcept;
+
+    void WriteBytes(std::span<const std::byte> bytes) noexcept;
+
+    //! Convert values to big-endian bytes and write them.
+    template <typename T>
+        requires std::is_arithmetic_v<T>
+    void WriteBigEndian(std::span<const T> vals) noexcept;
+
+    void Fail(Error err) noexcept;
+
+    std::vector<std::byte>* buf_ {nullptr};
+    ByteSink sink_;
+    std::size_t init_buf_size_ {0};
+    std::size_t byte_size_ {0};
+    std::vector<Frame> frames_;
+    std::optional<Error> err_;
+};
+
+}  // namespace secs2
@@ -0,0 +1,384 @@
+#include "archive.h"
+#include "byte/read.h"
+#include "byte/write.h"
+
+#include <bit_manip/bit_manip.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cerrno>
+#include <format>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace secs2 {
+
+namespace {
+
+namespace err {
+
+//! Make an error from the current @p errno of a failed system call.
+Error MakeSystemError(const std::string_view op,
+                      const std::filesystem::path& path) noexcept {
+    return {std::error_code {errno, std::system_category()},
+            std::format("Failed to {} '{}'", op, path.string())};
+}
+
+//! Make an error indicating that a file is not an archive.
+Error MakeInvalidArchiveError(const std::filesystem::path& path) noexcept {
+    return {std::make_error_code(std::errc::argument_out_of_domain),
+            std::format("'{}' is not a SECS-II archive", path.string())};
+}
+
+}  // namespace err
+
+//! The magic number and the version.
+constexpr std::array file_header {
+    std::byte {'S'}, std::byte {'2'}, std::byte {'A'}, std::byte {'R'},
+    std::byte {0},   std::byte {0},   std::byte {0},   std::byte {1}};
+
+//! Check whether a file shorter than the file header starts it, as when its first write was interrupted.
+bool IsTornFileHeader(const std::span<const std::byte> bytes) noexcept {
+    return bytes.size() < file_header.size()
+           && std::ranges::equal(bytes,
+                                 std::span {file_header}.first(bytes.size()));
+}
+
+//! The size, the tag and the timestamp.
+constexpr std::size_t record_header_size {sizeof(std::uint32_t)
+                                          + sizeof(std::uint32_t)
+                                          + sizeof(std::uint64_t)};
+
+//! Check whether a message is too large for the size of a record.
+constexpr bool IsExceedRecordSize(const std::size_t size) noexcept {
+    return size > std::numeric_limits<std::uint32_t>::max();
+}
+
+//! Write an integer to the beginning of a buffer and return the rest.
+template <typename T>
+std::span<std::byte> WriteInt(const T val,
+                              const std::span<std::byte> bytes) noexcept {
+    bit::WriteBytes(val, bytes.first(sizeof(T)), std::endian::big);
+    return bytes.subspan(sizeof(T));
+}
+
+//! Read an integer from the beginning of a buffer.
+template <typename T>
+T ReadInt(const std::span<const std::byte> bytes) noexcept {
+    T val {0};
+    bit::ReadBytes(bytes.first(sizeof(T)), val, std::endian::big);
+    return val;
+}
+
+//! Check whether the rest of an archive holds a complete record of a message.
+constexpr bool IsCompleteRecord(const std::size_t rest_size,
+                                const std::uint32_t msg_size) noexcept {
+    return rest_size - record_header_size >= msg_size;
+}
+
+/**
+ * @brief Get the end of the last complete record in an archive file.
+ *
+ * @param size The size of the file, which must start with a file header.
+ */
+std::expected<std::size_t, Error> FindRecordEnd(
+    const int fd, const std::size_t size,
+    const std::filesystem::path& path) noexcept {
+    auto offset {file_header.size()};
+    while (size - offset >= record_header_size) {
+        std::array<std::byte, sizeof(std::uint32_t)> msg_size_bytes;
+        if (::pread(fd, msg_size_bytes.data(), msg_size_bytes.size(),
+                    static_cast<off_t>(offset))
+            != static_cast<ssize_t>(msg_size_bytes.size())) [[unlikely]] {
+            return std::unexpected {err::MakeSystemError("read", path)};
+        }
+
+        const auto msg_size {ReadInt<std::uint32_t>(msg_size_bytes)};
+        if (!IsCompleteRecord(size - offset, msg_size)) [[unlikely]] {
+            break;
+        }
+
+        offset += record_header_size + msg_size;
+    }
+
+    return offset;
+}
+
+}  // namespace
+
+ArchiveWriter::ArchiveWriter(const int fd) noexcept : fd_ {fd} {}
+
+ArchiveWriter::ArchiveWriter(ArchiveWriter&& other) noexcept :
+    fd_ {std::exchange(other.fd_, -1)}, buf_ {std::move(other.buf_)} {}
+
+ArchiveWriter& ArchiveWriter::operator=(ArchiveWriter&& other) noexcept {
+    if (this != &other) {
+        Close();
+        fd_ = std::exchange(other.fd_, -1);
+        buf_ = std::move(other.buf_);
+    }
+    return *this;
+}
+
+ArchiveWriter::~ArchiveWriter() noexcept {
+    Close();
+}
+
+void ArchiveWriter::Close() noexcept {
+    if (fd_ != -1) {
+        [[maybe_unused]] const auto flushed {Flush()};
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+std::expected<ArchiveWriter, Error> ArchiveWriter::Open(
+    const std::filesystem::path& path) noexcept {
+    const auto fd {
+        ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644)};
+    if (fd == -1) [[unlikely]] {
+        return std::unexpected {err::MakeSystemError("open", path)};
+    }
+
+    ArchiveWriter writer {fd};
+    struct stat st {};
+    if (::fstat(fd, &st) == -1) [[unlikely]] {
+        return std::unexpected {err::MakeSystemError("stat", path)};
+    }
+
+    const auto size {static_cast<std::size_t>(st.st_size)};
+    std::array<std::byte, file_header.size()> header;
+    const auto header_size {std::min(size, header.size())};
+    if (::pread(fd, header.data(), header_size, 0)
+        != static_cast<ssize_t>(header_size)) [[unlikely]] {
+        return std::unexpected {err::MakeInvalidArchiveError(path)};
+    }
+
+    if (IsTornFileHeader(std::span {header}.first(header_size))) {
+        // A file header torn by an interrupted first write is written again.
+        if (size != 0 && ::ftruncate(fd, 0) == -1) [[unlikely]] {
+            return std::unexpected {err::MakeSystemError("truncate", path)};
+        }
+
+        writer.buf_.assign(file_header.begin(), file_header.end());
+        return writer;
+    } else if (header != file_header) [[unlikely]] {
+        return std::unexpected {err::MakeInvalidArchiveError(path)};
+    }
+
+    // A record torn by an interrupted write is discarded,
+    // so new records are appended right after the last complete one.
+    const auto end {FindRecordEnd(fd, size, path)};
+    if (!end.has_value()) [[unlikely]] {
+        return std::unexpected {end.error()};
+    } else if (*end != size
+               && ::ftruncate(fd, static_cast<off_t>(*end)) == -1)
+        [[unlikely]] {
+        return std::unexpected {err::MakeSystemError("truncate", path)};
+    }
+
+    return writer;
+}
+
+std::span<std::byte> ArchiveWriter::AddRecord(
+    const std::size_t size, const RecordMetadata& meta) noexcept {
+    const auto offset {buf_.size()};
+    buf_.resize(offset + record_header_size + size);
+    auto bytes {std::span {buf_}.subspan(offset)};
+    bytes = WriteInt(static_cast<std::uint32_t>(size), bytes);
+    bytes = WriteInt(meta.tag, bytes);
+    return WriteInt(meta.timestamp, bytes);
+}
+
+std::expected<void, Error> ArchiveWriter::Append(
+    const Message& msg, const RecordMetadata& meta) noexcept {
+    const auto size {msg.GetEncodedSize()};
+    if (!size.has_value() || IsExceedRecordSize(*size)) [[unlikely]] {
+        return std::unexpected {byte::w::err::MakeExceededLengthError()};
+    }
+
+    [[maybe_unused]] const auto written {
+        msg.SerializeInto(AddRecord(*size, meta))};
+    assert(written.has_value());
+    if (buf_.size() >= flush_size) {
+        return Flush();
+    }
+
+    return {};
+}
+
+std::expected<void, Error> ArchiveWriter::Append(
+    const std::span<const std::byte> bytes,
+    const RecordMetadata& meta) noexcept {
+    const auto size {byte::r::CheckMsgBytes(bytes)};
+    if (!size.has_value()) [[unlikely]] {
+        return std::unexpected {size.error()};
+    } else if (IsExceedRecordSize(*size)) [[unlikely]] {
+        return std::unexpected {byte::w::err::MakeExceededLengthError()};
+    }
+
+    std::ranges::copy(bytes.first(*size), AddRecord(*size, meta).begin());
+    if (buf_.size() >= flush_size) {
+        return Flush();
+    }
+
+    return {};
+}
+
+std::expected<void, Error> ArchiveWriter::Flush() noexcept {
+    assert(fd_ != -1);
+    std::size_t written_size {0};
+    while (written_size != buf_.size()) {
+        const auto written {::write(fd_, buf_.data() + written_size,
+                                    buf_.size() - written_size)};
+        if (written == -1) [[unlikely]] {
+            const auto code {errno};
+            if (code == EINTR) {
+                continue;
+            }
+
+            // Keep the records that have not been written for a later retry.
+            buf_.erase(buf_.begin(), buf_.begin() + written_size);
+            return std::unexpected {
+                Error {std::error_code {code, std::system_category()},
+                       "Failed to write records"}};
+        }
+
+        written_size += static_cast<std::size_t>(written);
+    }
+
+    buf_.clear();
+    return {};
+}
+
+MessageArchive::MessageArchive(const std::byte* const data,
+                               const std::size_t size,
+                               std::vector<std::size_t> offsets) noexcept :
+    data_ {data}, size_ {size}, offsets_ {std::move(offsets)} {}
+
+MessageArchive::MessageArchive(MessageArchive&& other) noexcept :
+    data_ {std::exchange(other.data_, nullptr)},
+    size_ {std::exchange(other.size_, 0)},
+    offsets_ {std::move(other.offsets_)},
+    torn_size_ {std::exchange(other.torn_size_, 0)} {}
+
+MessageArchive& MessageArchive::operator=(MessageArchive&& other) noexcept {
+    if (this != &other) {
+        Unmap();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        offsets_ = std::move(other.offsets_);
+        torn_size_ = std::exchange(other.torn_size_, 0);
+    }
+    return *this;
+}
+
+MessageArchive::~MessageArchive() noexcept {
+    Unmap();
+}
+
+void MessageArchive::Unmap() noexcept {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<std::byte*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+}
+
+std::expected<MessageArchive, Error> MessageArchive::Open(
+    const std::filesystem::path& path) noexcept {
+    const auto fd {::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd == -1) [[unlikely]] {
+        return std::unexpected {err::MakeSystemError("open", path)};
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) == -1) [[unlikely]] {
+        auto error {err::MakeSystemError("stat", path)};
+        ::close(fd);
+        return std::unexpected {std::move(error)};
+    }
+
+    const auto size {static_cast<std::size_t>(st.st_size)};
+    if (size < file_header.size()) [[unlikely]] {
+        std::array<std::byte, file_header.size()> header;
+        const auto read {::pread(fd, header.data(), size, 0)};
+        ::close(fd);
+        if (read != static_cast<ssize_t>(size)
+            || !IsTornFileHeader(std::span {header}.first(size))) {
+            return std::unexpected {err::MakeInvalidArchiveError(path)};
+        }
+
+        // A file header torn by an interrupted first write holds no record.
+        MessageArchive archive {nullptr, 0, {}};
+        archive.torn_size_ = size;
+        return archive;
+    }
+
+    const auto mapped {::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)};
+    // The mapping stays valid after the file is closed.
+    auto error {mapped == MAP_FAILED ? err::MakeSystemError("map", path)
+                                     : Error {}};
+    ::close(fd);
+    if (mapped == MAP_FAILED) [[unlikely]] {
+        return std::unexpected {std::move(error)};
+    }
+
+    // The archive is unmapped by its destructor if it turns out to be invalid.
+    MessageArchive archive {static_cast<const std::byte*>(mapped), size, {}};
+    const std::span bytes {archive.data_, archive.size_};
+    if (!std::ranges::equal(bytes.first(file_header.size()), file_header))
+        [[unlikely]] {
+        return std::unexpected {err::MakeInvalidArchiveError(path)};
+    }
+
+    auto offset {file_header.size()};
+    while (size - offset >= record_header_size) {
+        const auto msg_size {ReadInt<std::uint32_t>(bytes.subspan(offset))};
+        if (!IsCompleteRecord(size - offset, msg_size)) [[unlikely]] {
+            break;
+        }
+
+        archive.offsets_.push_back(offset);
+        offset += record_header_size + msg_size;
+    }
+
+    // Records after a torn one cannot be framed, so indexing stops there.
+    archive.torn_size_ = size - offset;
+    return archive;
+}
+
+std::size_t MessageArchive::GetCount() const noexcept {
+    return offsets_.size();
+}
+
+std::size_t MessageArchive::GetTornSize() const noexcept {
+    return torn_size_;
+}
+
+ArchiveRecord MessageArchive::GetRecord(const std::size_t idx) const noexcept {
+    assert(idx < offsets_.size());
+    const auto bytes {std::span {data_, size_}.subspan(offsets_[idx])};
+    const auto msg_size {ReadInt<std::uint32_t>(bytes)};
+    return {.meta = {.tag = ReadInt<std::uint32_t>(
+                         bytes.subspan(sizeof(std::uint32_t))),
+                     .timestamp = ReadInt<std::uint64_t>(
+                         bytes.subspan(2 * sizeof(std::uint32_t)))},
+            .bytes = bytes.subspan(record_header_size, msg_size)};
+}
+
+std::expected<MessageView, Error> MessageArchive::GetView(
+    const std::size_t idx) const noexcept {
+    return MessageView::BuildFromBytes(GetRecord(idx).bytes);
+}
+
+}  // namespace secs2
@@ -0,0 +1,129 @@
+#include "batch.h"
+#include "byte/length.h"
+#include "byte/read.h"
+#include "byte/write.h"
+
+#include <cassert>
+#include <utility>
+
+namespace secs2 {
+
+namespace {
+
+/**
+ * @brief Deserialize back-to-back messages and append them to a vector.
+ *
+ * @details
+ * The number of bytes consumed by each message tells where the next one starts.
+ *
+ * @param opts Limits applied to each message.
+ * @param resource The memory resource from which values are allocated.
+ */
+std::expected<std::size_t, Error> LoadBatchBytes(
+    const std::span<const std::byte> bytes, std::vector<Message>& msgs,
+    const DecodeOptions& opts
+#ifdef SECS2_USE_PMR
+    ,
+    std::pmr::memory_resource* const resource
+#endif
+    ) noexcept {
+    const auto init_count {msgs.size()};
+    std::size_t byte_size {0};
+    while (byte_size != bytes.size()) {
+        byte::r::LoadContext ctx {
+#ifdef SECS2_USE_PMR
+            .resource = resource,
+#endif
+            .opts = opts};
+        auto loaded {byte::r::LoadMsgBytes(bytes.subspan(byte_size), ctx)};
+        if (!loaded.has_value()) [[unlikely]] {
+            msgs.erase(msgs.begin() + init_count, msgs.end());
+            return std::unexpected {std::move(loaded).error()};
+        }
+
+        msgs.emplace_back(std::move(loaded->first));
+        byte_size += loaded->second;
+    }
+
+    return byte_size;
+}
+
+}  // namespace
+
+std::size_t EncodedBatch::GetCount() const noexcept {
+    return offsets.size();
+}
+
+std::span<const std::byte> EncodedBatch::GetMsgBytes(
+    const std::size_t idx) const noexcept {
+    assert(idx < offsets.size());
+    const auto end {idx + 1 != offsets.size() ? offsets[idx + 1]
+                                              : bytes.size()};
+    return std::span {bytes}.subspan(offsets[idx], end - offsets[idx]);
+}
+
+std::expected<EncodedBatch, Error> EncodeBatch(
+    const std::span<const Message> msgs) noexcept {
+    EncodedBatch batch;
+    return EncodeBatchInto(msgs, batch).transform(
+        [&batch](std::size_t) noexcept { return std::move(batch); });
+}
+
+std::expected<std::size_t, Error> EncodeBatchInto(
+    const std::span<const Message> msgs, EncodedBatch& batch) noexcept {
+    batch.bytes.clear();
+    batch.offsets.clear();
+    batch.offsets.reserve(msgs.size());
+    std::size_t byte_size {0};
+    for (const auto& msg : msgs) {
+        const auto size {msg.GetEncodedSize()};
+        if (!size.has_value()) [[unlikely]] {
+            batch.offsets.clear();
+            return std::unexpected {byte::w::err::MakeExceededLengthError()};
+        }
+
+        batch.offsets.push_back(byte_size);
+        byte_size += *size;
+    }
+
+    batch.bytes.resize(byte_size);
+    const std::span buf {batch.bytes};
+    for (std::size_t i {0}; i != msgs.size(); ++i) {
+        [[maybe_unused]] const auto written {byte::w::WriteMsgBytes(
+            msgs[i].GetValue(), buf.subspan(batch.offsets[i]))};
+        assert(batch.offsets[i] + written
+               == (i + 1 != msgs.size() ? batch.offsets[i + 1] : byte_size));
+    }
+
+    return byte_size;
+}
+
+std::expected<std::vector<Message>, Error> DecodeBatch(
+    const std::span<const std::byte> bytes,
+    const DecodeOptions& opts) noexcept {
+    std::vector<Message> msgs;
+    return DecodeBatchInto(bytes, msgs, opts).transform(
+        [&msgs](std::size_t) noexcept { return std::move(msgs); });
+}
+
+std::expected<std::size_t, Error> DecodeBatchInto(
+    const std::span<const std::byte> bytes,
+    std::vector<Message>& msgs, const DecodeOptions& opts) noexcept {
+#ifdef SECS2_USE_PMR
+    return LoadBatchBytes(bytes, msgs, opts, std::pmr::get_default_resource());
+#else
+    return LoadBatchBytes(bytes, msgs, opts);
+#endif
+}
+
+#ifdef SECS2_USE_PMR
+std::expected<std::size_t, Error> DecodeBatchInto(
+    const std::span<const std::byte> bytes, std::vector<Message>& msgs,
+    std::pmr::memory_resource* const resource,
+    const DecodeOptions& opts) noexcept {
+    assert(resource != nullptr);
+    return LoadBatchBytes(bytes, msgs, opts, resource);
+}
+#endif
+
+}  // namespace secs2
@@ -23,4 +23,37 @@ std::size_t CalcLength(const Message::Value& val) noexcept {
                       val);
 }
 
+std::optional<std::size_t> CalcEncodedSize(const Item& item) noexcept {
+    const auto len {CalcLength(item)};
+    return codec::CalcHeaderSize(len).transform(
+        [len](const auto header_size) noexcept { return header_size + len; });
+}
+
+std::optional<std::size_t> CalcEncodedSize(const List& list) noexcept {
+    const auto header_size {codec::CalcHeaderSize(CalcLength(list))};
+    if (!header_size.has_value()) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    auto size {*header_size};
+    for (const auto& val : list) {
+        if (const auto elem_size {std::visit(
+                [](const auto& raw) noexcept { return CalcEncodedSize(raw); },
+                val)};
+            elem_size.has_value()) [[likely]] {
+            size += *elem_size;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    return size;
+}
+
+std::optional<std::size_t> CalcEncodedSize(
+    const Message::Value& val) noexcept {
+    return std::visit(
+        [](const auto& raw) noexcept { return CalcEncodedSize(raw); }, val);
+}
+
 }  // namespace secs2
\ No newline at end of file
@@ -10,7 +10,9 @@
 
 #pragma once
 
+#include "codec.h"
 #include "secs2.h"
+#include "traits.h"
 
 #include <bit_manip/bit_manip.h>
 
@@ -32,6 +34,8 @@ inline constexpr std::size_t type_bit_begin {len_bit_begin + len_bit_count};
 //! The number of bits for the format code.
 inline constexpr std::size_t type_bit_count {CHAR_BIT - type_bit_begin};
 
+static_assert(format_code_count == std::size_t {1} << type_bit_count);
+
 //! The maximum number of bytes used to represent the length.
 inline constexpr std::size_t max_len_byte_count {3};
 
@@ -57,6 +61,19 @@ std::size_t CalcLength(const List& list) noexcept;
  */
 std::size_t CalcLength(const Message::Value& val) noexcept;
 
+//! @overload
+std::optional<std::size_t> CalcEncodedSize(const Item& item) noexcept;
+
+//! @overload
+std::optional<std::size_t> CalcEncodedSize(const List& list) noexcept;
+
+/**
+ * @brief Get the number of bytes of a message after serialization, including all headers.
+ *
+ * @return The number of bytes if no length exceeds the maximum allowed length, otherwise @p std::nullopt.
+ */
+std::optional<std::size_t> CalcEncodedSize(const Message::Value& val) noexcept;
+
 //! Check whether a given number of length bytes is within the valid range.
 constexpr bool IsNotExceedLengthByteCountRange(
     const std::size_t count) noexcept {
@@ -93,38 +110,10 @@ constexpr std::optional<std::size_t> FilterExceededLength(
 //! Calculates the number of bytes required for a given length.
 constexpr std::optional<std::size_t> CalcLengthByteCount(
     const std::size_t len) noexcept {
-    if (len <= std::numeric_limits<std::uint8_t>::max()) [[likely]] {
-        return sizeof(std::uint8_t);
-    } else if (len <= std::numeric_limits<std::uint16_t>::max()) {
-        return sizeof(std::uint16_t);
-    } else if (IsNotExceedMaxLength(len)) {
-        return sizeof(std::uint16_t) + sizeof(std::uint8_t);
-    } else [[unlikely]] {
-        return std::nullopt;
-    }
+    return codec::CalcHeaderSize(len).transform(
+        [](const std::size_t size) noexcept {
+            return size - sizeof(std::byte);
+        });
 }
 
-//! Length bytes.
-struct LengthBytes {
-    //! The number of valid bytes.
-    std::size_t valid_count {0};
-    //! Reserved bytes.
-    std::array<std::byte, max_len_byte_count> reserved {};
-
-    //! Build length bytes for a given length.
-    explicit constexpr LengthBytes(const std::size_t len) noexcept {
-        assert(IsNotExceedMaxLength(len));
-        [[assume(IsNotExceedMaxLength(len))]];
-        valid_count = CalcLengthByteCount(len).value_or(0);
-        assert(valid_count > 0);
-        [[assume(valid_count > 0)]];
-        bit::WriteBytes(len, std::as_writable_bytes(std::span {reserved}),
-                        std::endian::big);
-        if (valid_count < reserved.size()) [[likely]] {
-            std::ranges::copy_n(reserved.cend() - valid_count, valid_count,
-                                reserved.begin());
-        }
-    }
-};
-
 }  // namespace secs2
\ No newline at end of file
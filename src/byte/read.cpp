@@ -1,23 +1,26 @@
 #include "read.h"
 #include "length.h"
+#include "probe.h"
+#include "traits.h"
 
 #include <bit_manip/bit_manip.h>
 
+#include <algorithm>
 #include <cassert>
 #include <format>
-#include <functional>
 #include <ranges>
-#include <unordered_map>
 
 namespace secs2::byte::r {
 
 namespace err {
 
 Error MakeIncompleteDataError() noexcept {
+    probe::ReportError(instrument::ErrorKind::IncompleteData);
     return {std::make_error_code(std::errc::message_size), "Incomplete data"};
 }
 
 Error MakeUnknownTypeError(const Type type) noexcept {
+    probe::ReportError(instrument::ErrorKind::UnknownType);
     return {std::make_error_code(std::errc::argument_out_of_domain),
             std::format("Unknown format type: 0x{:02X}",
                         static_cast<std::uint8_t>(type))};
@@ -25,73 +28,147 @@ Error MakeUnknownTypeError(const Type type) noexcept {
 
 Error MakeUnalignedLengthError(const std::size_t len, const Type type,
                                const std::size_t align) noexcept {
+    probe::ReportError(instrument::ErrorKind::UnalignedLength);
     return {std::make_error_code(std::errc::message_size),
             std::format("Length {} is not aligned to {} size {}", len,
                         to_string(type), align)};
 }
 
 Error MakeInvalidLengthByteCountError(const std::size_t count) noexcept {
+    probe::ReportError(instrument::ErrorKind::InvalidLengthByteCount);
     return {std::make_error_code(std::errc::argument_out_of_domain),
             std::format("Invalid number of length bytes: {}", count)};
 }
 
+Error MakeExceededDepthError(const std::size_t max_depth) noexcept {
+    probe::ReportError(instrument::ErrorKind::ExceededDepth);
+    return {std::make_error_code(std::errc::value_too_large),
+            std::format("Lists are nested more than {} levels", max_depth)};
+}
+
+Error MakeExceededElemCountError(const std::size_t max_count) noexcept {
+    probe::ReportError(instrument::ErrorKind::ExceededElemCount);
+    return {std::make_error_code(std::errc::value_too_large),
+            std::format("The number of elements exceeds {}", max_count)};
+}
+
+Error MakeExceededAllocSizeError(const std::size_t max_size) noexcept {
+    probe::ReportError(instrument::ErrorKind::ExceededAllocSize);
+    return {std::make_error_code(std::errc::value_too_large),
+            std::format("Values require more than {} bytes", max_size)};
+}
+
+Error MakeCanceledError() noexcept {
+    return {std::make_error_code(std::errc::operation_canceled),
+            "Another element failed to load"};
+}
+
 }  // namespace err
 
+namespace {
+
+//! Add a value to a counter if the total does not exceed a limit.
+bool TryAdd(std::size_t& counter, const std::size_t val,
+            const std::size_t max) noexcept {
+    if (val > max - counter) [[unlikely]] {
+        return false;
+    }
+
+    counter += val;
+    return true;
+}
+
+//! @overload
+bool TryAdd(std::atomic<std::size_t>& counter, const std::size_t val,
+            const std::size_t max) noexcept {
+    auto curr {counter.load(std::memory_order_relaxed)};
+    do {
+        if (val > max - curr) [[unlikely]] {
+            return false;
+        }
+    } while (!counter.compare_exchange_weak(curr, curr + val,
+                                            std::memory_order_relaxed));
+    return true;
+}
+
+}  // namespace
+
+std::expected<void, Error> AddAllocSize(LoadContext& ctx,
+                                        const Type type,
+                                        const std::size_t size) noexcept {
+    const auto max {ctx.opts.max_alloc_size};
+    const auto added {ctx.shared != nullptr
+                          ? TryAdd(ctx.shared->alloc_size, size, max)
+                          : TryAdd(ctx.alloc_size, size, max)};
+    if (!added) [[unlikely]] {
+        return std::unexpected {err::MakeExceededAllocSizeError(max)};
+    }
+
+    probe::DecodeAlloc(type, size);
+    return {};
+}
+
 std::expected<Loaded, Error> LoadBoolValBytes(
-    const std::span<const std::byte> bytes, const std::size_t len) noexcept {
+    const std::span<const std::byte> bytes, const std::size_t len,
+    LoadContext& ctx) noexcept {
     if (bytes.size() < len) [[unlikely]] {
         return std::unexpected {err::MakeIncompleteDataError()};
     }
 
-    Boolean vals;
     const auto count {len};
-    std::ranges::for_each(std::views::iota(static_cast<std::size_t>(0), count),
-                          [&vals, &bytes](const auto i) noexcept {
-                              vals.push_back(static_cast<bool>(bytes[i]));
-                          });
-    return std::pair {vals, len};
+    if (const auto added {AddAllocSize(ctx, Type::Boolean, count * sizeof(bool))};
+        !added.has_value()) [[unlikely]] {
+        return std::unexpected {added.error()};
+    }
+
+    auto vals {MakeEmptyValue<Boolean>(ctx)};
+    vals.resize(count);
+    // Any non-zero byte is true, so values are normalized instead of copied.
+    std::ranges::transform(bytes.first(count), vals.begin(),
+                           [](const auto byte) noexcept {
+                               return byte != std::byte {0};
+                           });
+    return Loaded {std::move(vals), len};
 }
 
 std::expected<Loaded, Error> LoadListValBytes(
-    const std::span<const std::byte> bytes, const std::size_t len) noexcept {
-    List list;
+    const std::span<const std::byte> bytes, const std::size_t len,
+    LoadContext& ctx) noexcept {
+    if (ctx.depth == ctx.opts.max_depth) [[unlikely]] {
+        return std::unexpected {
+            err::MakeExceededDepthError(ctx.opts.max_depth)};
+    }
+
     const auto count {len};
-    list.reserve(count);
+    const auto capacity {codec::CapListCapacity(count, bytes.size())};
+    if (const auto added {AddAllocSize(ctx, Type::List,
+                                           capacity * sizeof(ListElem))};
+        !added.has_value()) [[unlikely]] {
+        return std::unexpected {added.error()};
+    }
 
+    auto list {MakeEmptyValue<List>(ctx)};
+    list.reserve(capacity);
+
+    ++ctx.depth;
     std::size_t byte_size {0};
     for (std::size_t i {0}; i != count; ++i) {
-        if (auto loaded {LoadMsgBytes(bytes.subspan(byte_size))};
+        if (auto loaded {LoadMsgBytes(bytes.subspan(byte_size), ctx)};
             loaded.has_value()) [[likely]] {
             byte_size += loaded->second;
-            list.push_back(std::move(loaded)->first);
+            list.push_back(std::move(loaded->first));
         } else {
+            --ctx.depth;
             return std::unexpected {loaded.error()};
         }
     }
 
-    return std::pair {list, byte_size};
+    --ctx.depth;
+    return Loaded {std::move(list), byte_size};
 }
 
-std::expected<Loaded, Error> LoadMsgBytes(
+std::expected<Header, Error> ReadHeader(
     const std::span<const std::byte> bytes) noexcept {
-    using Loader = std::function<std::expected<Loaded, Error>(
-        std::span<const std::byte>, std::size_t)>;
-    static const std::unordered_map<Type, Loader> loaders {
-        {Type::List, LoadValBytes<List>},
-        {Type::Boolean, LoadValBytes<Boolean>},
-        {Type::ASCII, LoadValBytes<ASCII>},
-        {Type::Binary, LoadValBytes<Binary>},
-        {Type::I1, LoadValBytes<I1>},
-        {Type::I2, LoadValBytes<I2>},
-        {Type::I4, LoadValBytes<I4>},
-        {Type::I8, LoadValBytes<I8>},
-        {Type::U1, LoadValBytes<U1>},
-        {Type::U2, LoadValBytes<U2>},
-        {Type::U4, LoadValBytes<U4>},
-        {Type::U8, LoadValBytes<U8>},
-        {Type::F4, LoadValBytes<F4>},
-        {Type::F8, LoadValBytes<F8>}};
-
     if (bytes.empty()) [[unlikely]] {
         return std::unexpected {err::MakeIncompleteDataError()};
     }
@@ -102,29 +179,127 @@ std::expected<Loaded, Error> LoadMsgBytes(
             err::MakeInvalidLengthByteCountError(len_byte_count)};
     }
 
-    const auto loader {loaders.find(type)};
-    if (loader == loaders.cend()) [[unlikely]] {
+    if (!IsKnownType(type)) [[unlikely]] {
         return std::unexpected {err::MakeUnknownTypeError(type)};
     }
 
-    const auto len_bytes {bytes.subspan(1)};
-    const auto len {ReadLength(len_bytes, len_byte_count)};
-    if (len.has_value()) [[likely]] {
-        const auto val_bytes {len_bytes.subspan(len_byte_count)};
-        return loader->second(val_bytes, *len)
-            .transform([len_byte_count](const auto& val) noexcept {
-                return std::pair {
-                    val.first, sizeof(std::byte) + len_byte_count + val.second};
-            });
+    if (const auto len {ReadLength(bytes.subspan(1), len_byte_count)};
+        len.has_value()) [[likely]] {
+        return Header {.type = type,
+                       .len = *len,
+                       .size = sizeof(std::byte) + len_byte_count};
     } else {
         return std::unexpected {err::MakeIncompleteDataError()};
     }
 }
 
+std::expected<std::size_t, Error> CheckMsgBytes(
+    const std::span<const std::byte> bytes) noexcept {
+    // Elements are stored in pre-order, so tracking the number of elements
+    // that still have to be read is enough to find the end of a message.
+    std::size_t pending_count {1};
+    std::size_t byte_size {0};
+    while (pending_count != 0) {
+        const auto header {ReadHeader(bytes.subspan(byte_size))};
+        if (!header.has_value()) [[unlikely]] {
+            return std::unexpected {header.error()};
+        }
+
+        byte_size += header->size;
+        --pending_count;
+        if (header->type == Type::List) {
+            pending_count += header->len;
+            continue;
+        }
+
+        if (bytes.size() - byte_size < header->len) [[unlikely]] {
+            return std::unexpected {err::MakeIncompleteDataError()};
+        }
+
+        if (const auto align {GetElemSize(header->type)};
+            header->len % align != 0) [[unlikely]] {
+            return std::unexpected {
+                err::MakeUnalignedLengthError(header->len, header->type, align)};
+        }
+
+        byte_size += header->len;
+    }
+
+    return byte_size;
+}
+
+std::size_t SkipMsgBytes(const std::span<const std::byte> bytes) noexcept {
+    std::size_t pending_count {1};
+    std::size_t byte_size {0};
+    while (pending_count != 0) {
+        assert(byte_size < bytes.size());
+        const auto [type, len_byte_count] {
+            ReadFormatByte(bytes[byte_size])};
+        const auto len {
+            ReadLength(bytes.subspan(byte_size + 1), len_byte_count)};
+        assert(len.has_value());
+        byte_size += sizeof(std::byte) + len_byte_count;
+        --pending_count;
+        if (type == Type::List) {
+            pending_count += *len;
+        } else {
+            byte_size += *len;
+        }
+    }
+
+    return byte_size;
+}
+
+std::expected<Loaded, Error> LoadValBytes(
+    const Type type, const std::span<const std::byte> bytes,
+    const std::size_t len, LoadContext& ctx) noexcept {
+    using Loader = std::expected<Loaded, Error> (*)(
+        std::span<const std::byte>, std::size_t, LoadContext&) noexcept;
+    static constexpr auto loaders {BuildFormatCodeTable<Loader>(
+        []<typename T>(std::type_identity<T>) noexcept -> Loader {
+            return LoadValBytes<T>;
+        })};
+
+    const auto code {static_cast<std::size_t>(type)};
+    if (code >= loaders.size() || loaders[code] == nullptr) [[unlikely]] {
+        return std::unexpected {err::MakeUnknownTypeError(type)};
+    }
+
+    return loaders[code](bytes, len, ctx);
+}
+
+std::expected<Loaded, Error> LoadMsgBytes(
+    const std::span<const std::byte> bytes, LoadContext& ctx) noexcept {
+    const auto header {ReadHeader(bytes)};
+    if (!header.has_value()) [[unlikely]] {
+        return std::unexpected {header.error()};
+    }
+
+    const auto max {ctx.opts.max_elem_count};
+    if (ctx.shared != nullptr) {
+        if (ctx.shared->failed.load(std::memory_order_relaxed)) [[unlikely]] {
+            return std::unexpected {err::MakeCanceledError()};
+        } else if (!TryAdd(ctx.shared->elem_count, 1, max)) [[unlikely]] {
+            return std::unexpected {err::MakeExceededElemCountError(max)};
+        }
+    } else if (!TryAdd(ctx.elem_count, 1, max)) [[unlikely]] {
+        return std::unexpected {err::MakeExceededElemCountError(max)};
+    }
+
+    const auto val_bytes {bytes.subspan(header->size)};
+    return LoadValBytes(header->type, val_bytes, header->len, ctx)
+        .transform([&header, &ctx](Loaded&& val) noexcept {
+            const auto byte_size {header->size + val.second};
+            probe::DecodeElem(header->type, byte_size, ctx.depth);
+            return Loaded {std::move(val.first), byte_size};
+        });
+}
+
 template <>
 std::expected<Loaded, Error> LoadItemValBytes<Boolean>(
-    const std::span<const std::byte> bytes, const std::size_t len) noexcept {
-    return LoadBoolValBytes(bytes, len);
+    const std::span<const std::byte> bytes, const std::size_t len,
+    LoadContext& ctx) noexcept {
+    return LoadBoolValBytes(bytes, len, ctx);
 }
 
 }  // namespace secs2::byte::r
\ No newline at end of file
@@ -12,11 +12,13 @@
 
 #include "length.h"
 #include "secs2.h"
+#include "swap.h"
 #include "traits.h"
 
 #include <bit_manip/bit_manip.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <expected>
 #include <iterator>
@@ -28,6 +30,10 @@
 #include <type_traits>
 #include <utility>
 
+#ifdef SECS2_USE_PMR
+#include <memory_resource>
+#endif
+
 namespace secs2::byte::r {
 
 namespace err {
@@ -44,32 +50,155 @@ Error MakeInvalidLengthByteCountError(std::size_t count) noexcept;
 //! Make an error indicating that the length is not properly aligned.
 Error MakeUnalignedLengthError(std::size_t len, Type type,
                                std::size_t align) noexcept;
+
+//! Make an error indicating that lists are nested too deeply.
+Error MakeExceededDepthError(std::size_t max_depth) noexcept;
+
+//! Make an error indicating that there are too many elements.
+Error MakeExceededElemCountError(std::size_t max_count) noexcept;
+
+//! Make an error indicating that values require too much memory.
+Error MakeExceededAllocSizeError(std::size_t max_size) noexcept;
+
+//! Make an error indicating that loading stopped because another element failed.
+Error MakeCanceledError() noexcept;
 }  // namespace err
 
 //! A deserialized message and its size in bytes.
 using Loaded = std::pair<Message::Value, std::size_t>;
 
-//! Same as @ref Message::BuildFromBytes.
-std::expected<Loaded, Error> LoadMsgBytes(
+//! Counters shared by contexts loading elements of the same message concurrently.
+struct SharedCounters {
+    //! The number of elements loaded so far.
+    std::atomic<std::size_t> elem_count {0};
+
+    //! The number of bytes reserved for values so far.
+    std::atomic<std::size_t> alloc_size {0};
+
+    //! Whether an element has failed, after which the others stop loading.
+    std::atomic<bool> failed {false};
+};
+
+/**
+ * @brief The state shared by all loaders while deserializing a message.
+ *
+ * @details
+ * Loaders update its counters, so each message is loaded with a new context.
+ */
+struct LoadContext {
+#ifdef SECS2_USE_PMR
+    //! The memory resource from which values are allocated.
+    std::pmr::memory_resource* resource {std::pmr::get_default_resource()};
+#endif
+
+    //! Limits on the resources used.
+    DecodeOptions opts {};
+
+    //! The number of lists enclosing the element being loaded.
+    std::size_t depth {0};
+
+    //! The number of elements loaded so far.
+    std::size_t elem_count {0};
+
+    //! The number of bytes reserved for values so far.
+    std::size_t alloc_size {0};
+
+    /**
+     * @brief Counters used instead of @ref elem_count and @ref alloc_size, or @p nullptr.
+     *
+     * @details
+     * They allow elements to be loaded concurrently within the limits of a whole message.
+     */
+    SharedCounters* shared {nullptr};
+};
+
+/**
+ * @brief Record the memory reserved for values.
+ *
+ * @return Nothing if the total size does not exceed @ref DecodeOptions::max_alloc_size, otherwise an error.
+ */
+std::expected<void, Error> AddAllocSize(LoadContext& ctx, Type type,
+                                        std::size_t size) noexcept;
+
+//! Construct an empty value that allocates memory as required by a context.
+template <typename T>
+T MakeEmptyValue([[maybe_unused]] const LoadContext& ctx) noexcept {
+#ifdef SECS2_USE_PMR
+    return T {typename T::allocator_type {ctx.resource}};
+#else
+    return T {};
+#endif
+}
+
+//! The header of an item or list.
+using Header = codec::Header;
+
+/**
+ * @brief Read the header of an item or list from a buffer.
+ *
+ * @details
+ * It checks the format code and the length bytes but not the value.
+ */
+std::expected<Header, Error> ReadHeader(
+    std::span<const std::byte> bytes) noexcept;
+
+/**
+ * @brief Check the bytes of a message without deserializing its value.
+ *
+ * @details
+ * It performs the same checks as @ref LoadMsgBytes in a single pass over headers,
+ * without allocating memory or recursing into nested lists.
+ *
+ * @return The size of the message in bytes if it is valid, otherwise an error.
+ */
+std::expected<std::size_t, Error> CheckMsgBytes(
     std::span<const std::byte> bytes) noexcept;
 
+/**
+ * @brief Get the size of a message in bytes by reading its headers only.
+ *
+ * @warning The bytes must have been checked by @ref CheckMsgBytes.
+ */
+std::size_t SkipMsgBytes(std::span<const std::byte> bytes) noexcept;
+
+//! Same as @ref Message::BuildFromBytes.
+std::expected<Loaded, Error> LoadMsgBytes(std::span<const std::byte> bytes,
+                                          LoadContext& ctx) noexcept;
+
+/**
+ * @brief Read the value of an item or list from a buffer.
+ *
+ * @param type The type of the value.
+ * @param bytes A buffer starting from the value, excluding its header.
+ * @param len The length from the header.
+ * @param ctx The context of deserialization.
+ */
+std::expected<Loaded, Error> LoadValBytes(Type type,
+                                          std::span<const std::byte> bytes,
+                                          std::size_t len,
+                                          LoadContext& ctx) noexcept;
+
 /**
  * @brief Read the bytes of a boolean from a buffer.
  *
  * @param bytes A buffer.
  * @param len The size of the boolean in bytes.
+ * @param ctx The context of deserialization.
  */
 std::expected<Loaded, Error> LoadBoolValBytes(std::span<const std::byte> bytes,
-                                              std::size_t len) noexcept;
+                                              std::size_t len,
+                                              LoadContext& ctx) noexcept;
 
 /**
  * @brief Read the bytes of a list from a buffer.
  *
  * @param bytes A buffer.
  * @param len The number of direct elements in the list.
+ * @param ctx The context of deserialization.
  */
 std::expected<Loaded, Error> LoadListValBytes(std::span<const std::byte> bytes,
-                                              std::size_t len) noexcept;
+                                              std::size_t len,
+                                              LoadContext& ctx) noexcept;
 
 //! Read a format byte (the first byte) from a buffer.
 constexpr std::pair<Type, std::size_t> ReadFormatByte(
@@ -99,28 +228,37 @@ constexpr std::optional<std::size_t> ReadLength(
  *
  * @param bytes A buffer.
  * @param len The size of the item in bytes.
+ * @param ctx The context of deserialization.
  */
 template <typename T>
     requires(!std::same_as<T, List>)
 std::expected<Loaded, Error> LoadItemValBytes(
-    const std::span<const std::byte> bytes, const std::size_t len) noexcept {
+    const std::span<const std::byte> bytes, const std::size_t len,
+    LoadContext& ctx) noexcept {
     using Value = std::ranges::range_value_t<T>;
     if (bytes.size() < len) [[unlikely]] {
         return std::unexpected {err::MakeIncompleteDataError()};
     }
 
-    T vals;
+    auto vals {MakeEmptyValue<T>(ctx)};
     if (len % sizeof(Value) != 0) [[unlikely]] {
         return std::unexpected {
             err::MakeUnalignedLengthError(len, format_code<T>, sizeof(Value))};
     }
 
     const auto count {len / sizeof(Value)};
-    if constexpr (std::ranges::contiguous_range<T>) {
-        vals.reserve(count);
+    if (const auto added {AddAllocSize(ctx, format_code<T>, count * sizeof(Value))};
+        !added.has_value()) [[unlikely]] {
+        return std::unexpected {added.error()};
     }
 
-    if constexpr (sizeof(Value) <= sizeof(std::byte)) {
+    if constexpr (std::ranges::contiguous_range<T>
+                  && std::is_arithmetic_v<Value>) {
+        vals.resize(count);
+        LoadBigEndian(bytes.first(len), std::span {vals});
+    } else if constexpr (std::same_as<Value, std::byte>) {
+        vals.assign(bytes.begin(), bytes.begin() + count);
+    } else if constexpr (sizeof(Value) <= sizeof(std::byte)) {
         std::ranges::transform(
             bytes.subspan(0, count), std::back_inserter(vals),
             [](const auto byte) noexcept { return static_cast<Value>(byte); });
@@ -128,28 +266,28 @@ std::expected<Loaded, Error> LoadItemValBytes(
         std::ranges::for_each(
             std::views::iota(static_cast<std::size_t>(0), count),
             [bytes, &vals](const auto i) noexcept {
-                Value val;
-                bit::ReadBytes(bytes.subspan(i * sizeof(Value)), val,
-                               std::endian::big);
-                vals.push_back(val);
+                vals.push_back(codec::LoadScalar<Value>(
+                    bytes.subspan(i * sizeof(Value))));
             });
     }
-    return std::pair {vals, len};
+    return Loaded {std::move(vals), len};
 }
 
 //! Read the value of an item or list from a buffer.
 template <typename T>
 std::expected<Loaded, Error> LoadValBytes(
-    const std::span<const std::byte> bytes, const std::size_t len) noexcept {
+    const std::span<const std::byte> bytes, const std::size_t len,
+    LoadContext& ctx) noexcept {
     if constexpr (std::same_as<T, List>) {
-        return LoadListValBytes(bytes, len);
+        return LoadListValBytes(bytes, len, ctx);
     } else {
-        return LoadItemValBytes<T>(bytes, len);
+        return LoadItemValBytes<T>(bytes, len, ctx);
     }
 }
 
 template <>
 std::expected<Loaded, Error> LoadItemValBytes<Boolean>(
-    std::span<const std::byte> bytes, std::size_t len) noexcept;
+    std::span<const std::byte> bytes, std::size_t len,
+    LoadContext& ctx) noexcept;
 
 }  // namespace secs2::byte::r
\ No newline at end of file
@@ -0,0 +1,165 @@
+#include "swap.h"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define SECS2_SWAP_X86
+    #include <immintrin.h>
+#elif defined(__ARM_NEON)
+    #define SECS2_SWAP_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace secs2::byte {
+
+namespace {
+
+//! A kernel reversing the bytes of each element.
+using Kernel = void (*)(const std::byte*, std::byte*, std::size_t) noexcept;
+
+//! A set of kernels for 2-byte, 4-byte and 8-byte elements.
+struct Kernels {
+    const char* name;
+    Kernel swap2;
+    Kernel swap4;
+    Kernel swap8;
+};
+
+template <typename T>
+void SwapScalar(const std::byte* src, std::byte* dst,
+                const std::size_t count) noexcept {
+    for (std::size_t i {0}; i != count; ++i) {
+        T val;
+        std::memcpy(&val, src + i * sizeof(T), sizeof(T));
+        val = std::byteswap(val);
+        std::memcpy(dst + i * sizeof(T), &val, sizeof(T));
+    }
+}
+
+//! Build a shuffle mask reversing each element of @p Size bytes in a 16-byte block.
+template <std::size_t Size>
+constexpr std::array<std::uint8_t, 16> BuildShuffleMask() noexcept {
+    std::array<std::uint8_t, 16> mask {};
+    for (std::size_t i {0}; i != mask.size(); ++i) {
+        mask[i] = static_cast<std::uint8_t>(i / Size * Size + Size - 1
+                                            - i % Size);
+    }
+    return mask;
+}
+
+#if defined(SECS2_SWAP_X86)
+
+template <typename T>
+__attribute__((target("ssse3"))) void SwapSsse3(
+    const std::byte* src, std::byte* dst, const std::size_t count) noexcept {
+    static constexpr auto mask_bytes {BuildShuffleMask<sizeof(T)>()};
+    const auto mask {_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(mask_bytes.data()))};
+    constexpr std::size_t block_count {sizeof(__m128i) / sizeof(T)};
+    std::size_t i {0};
+    for (; i + block_count <= count; i += block_count) {
+        const auto block {_mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(src + i * sizeof(T)))};
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * sizeof(T)),
+                         _mm_shuffle_epi8(block, mask));
+    }
+    SwapScalar<T>(src + i * sizeof(T), dst + i * sizeof(T), count - i);
+}
+
+template <typename T>
+__attribute__((target("avx2"))) void SwapAvx2(const std::byte* src,
+                                               std::byte* dst,
+                                               const std::size_t count) noexcept {
+    static constexpr auto mask_bytes {BuildShuffleMask<sizeof(T)>()};
+    // `vpshufb` shuffles within each 128-bit lane, so both lanes use the same mask.
+    const auto mask {_mm256_broadcastsi128_si256(_mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(mask_bytes.data())))};
+    constexpr std::size_t block_count {sizeof(__m256i) / sizeof(T)};
+    std::size_t i {0};
+    for (; i + block_count <= count; i += block_count) {
+        const auto block {_mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(src + i * sizeof(T)))};
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * sizeof(T)),
+                            _mm256_shuffle_epi8(block, mask));
+    }
+    SwapScalar<T>(src + i * sizeof(T), dst + i * sizeof(T), count - i);
+}
+
+#elif defined(SECS2_SWAP_NEON)
+
+template <typename T>
+void SwapNeon(const std::byte* src, std::byte* dst,
+              const std::size_t count) noexcept {
+    constexpr std::size_t block_count {sizeof(uint8x16_t) / sizeof(T)};
+    std::size_t i {0};
+    for (; i + block_count <= count; i += block_count) {
+        const auto block {
+            vld1q_u8(reinterpret_cast<const std::uint8_t*>(src + i * sizeof(T)))};
+        uint8x16_t swapped;
+        if constexpr (sizeof(T) == sizeof(std::uint16_t)) {
+            swapped = vrev16q_u8(block);
+        } else if constexpr (sizeof(T) == sizeof(std::uint32_t)) {
+            swapped = vrev32q_u8(block);
+        } else {
+            swapped = vrev64q_u8(block);
+        }
+        vst1q_u8(reinterpret_cast<std::uint8_t*>(dst + i * sizeof(T)), swapped);
+    }
+    SwapScalar<T>(src + i * sizeof(T), dst + i * sizeof(T), count - i);
+}
+
+#endif
+
+Kernels SelectKernels() noexcept {
+#if defined(SECS2_SWAP_X86)
+    if (__builtin_cpu_supports("avx2")) {
+        return {"AVX2", SwapAvx2<std::uint16_t>, SwapAvx2<std::uint32_t>,
+                SwapAvx2<std::uint64_t>};
+    } else if (__builtin_cpu_supports("ssse3")) {
+        return {"SSSE3", SwapSsse3<std::uint16_t>, SwapSsse3<std::uint32_t>,
+                SwapSsse3<std::uint64_t>};
+    }
+#elif defined(SECS2_SWAP_NEON)
+    return {"NEON", SwapNeon<std::uint16_t>, SwapNeon<std::uint32_t>,
+            SwapNeon<std::uint64_t>};
+#endif
+    return {"Scalar", SwapScalar<std::uint16_t>, SwapScalar<std::uint32_t>,
+            SwapScalar<std::uint64_t>};
+}
+
+const Kernels& GetKernels() noexcept {
+    static const auto kernels {SelectKernels()};
+    return kernels;
+}
+
+}  // namespace
+
+void SwapBytes(const std::byte* const src, std::byte* const dst,
+               const std::size_t count, const std::size_t elem_size) noexcept {
+    const auto& kernels {GetKernels()};
+    switch (elem_size) {
+        case sizeof(std::uint16_t):
+            kernels.swap2(src, dst, count);
+            break;
+        case sizeof(std::uint32_t):
+            kernels.swap4(src, dst, count);
+            break;
+        case sizeof(std::uint64_t):
+            kernels.swap8(src, dst, count);
+            break;
+        default:
+            assert(false);
+            std::unreachable();
+    }
+}
+
+const char* GetSwapKernelName() noexcept {
+    return GetKernels().name;
+}
+
+}  // namespace secs2::byte
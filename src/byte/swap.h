@@ -0,0 +1,77 @@
+/**
+ * @file swap.h
+ * @brief Bulk big-endian conversion for SECS-II numeric items.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <type_traits>
+
+namespace secs2::byte {
+
+/**
+ * @brief Reverse the bytes of each element in a buffer.
+ *
+ * @details
+ * The kernel is chosen once at runtime from AVX2, SSSE3, NEON or a portable scalar loop,
+ * depending on what the processor supports.
+ *
+ * @param src The source bytes.
+ * @param dst The destination bytes, which may be the same as @p src but must not partially overlap it.
+ * @param count The number of elements.
+ * @param elem_size The size of each element in bytes, which must be 2, 4 or 8.
+ */
+void SwapBytes(const std::byte* src, std::byte* dst, std::size_t count,
+               std::size_t elem_size) noexcept;
+
+//! Get the name of the byte swapping kernel in use.
+const char* GetSwapKernelName() noexcept;
+
+//! Convert big-endian bytes to native values.
+template <typename T>
+    requires std::is_arithmetic_v<T>
+void LoadBigEndian(const std::span<const std::byte> src,
+                   const std::span<T> dst) noexcept {
+    assert(src.size() == dst.size_bytes());
+    if (dst.empty()) {
+        return;
+    }
+
+    if constexpr (sizeof(T) == sizeof(std::byte)
+                  || std::endian::native == std::endian::big) {
+        std::memcpy(dst.data(), src.data(), src.size());
+    } else {
+        SwapBytes(src.data(), std::as_writable_bytes(dst).data(), dst.size(),
+                  sizeof(T));
+    }
+}
+
+//! Convert native values to big-endian bytes.
+template <typename T>
+    requires std::is_arithmetic_v<T>
+void StoreBigEndian(const std::span<const T> src,
+                    const std::span<std::byte> dst) noexcept {
+    assert(src.size_bytes() == dst.size());
+    if (src.empty()) {
+        return;
+    }
+
+    if constexpr (sizeof(T) == sizeof(std::byte)
+                  || std::endian::native == std::endian::big) {
+        std::memcpy(dst.data(), src.data(), dst.size());
+    } else {
+        SwapBytes(std::as_bytes(src).data(), dst.data(), src.size(), sizeof(T));
+    }
+}
+
+}  // namespace secs2::byte
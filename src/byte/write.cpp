@@ -1,112 +1,167 @@
 #include "write.h"
 #include "length.h"
+#include "probe.h"
+#include "swap.h"
 #include "traits.h"
 
 #include <bit_manip/bit_manip.h>
 
-#include <iterator>
+#include <algorithm>
+#include <format>
 #include <ranges>
 #include <span>
 #include <type_traits>
 
 namespace secs2::byte::w {
 
-std::size_t CopyBoolValBytes(const Boolean& vals,
-                             std::vector<std::byte>& buf) noexcept {
-    const auto init_buf_size {buf.size()};
+namespace err {
+
+Error MakeExceededLengthError() noexcept {
+    probe::ReportError(instrument::ErrorKind::ExceededLength);
+    return {std::make_error_code(std::errc::value_too_large),
+            std::format("Length exceeds the maximum {}", max_len)};
+}
+
+Error MakeInsufficientBufferError(const std::size_t required,
+                                  const std::size_t provided) noexcept {
+    probe::ReportError(instrument::ErrorKind::InsufficientBuffer);
+    return {std::make_error_code(std::errc::no_buffer_space),
+            std::format("Buffer size {} is less than the required size {}",
+                        provided, required)};
+}
+
+}  // namespace err
+
+namespace {
+
+std::size_t WriteBoolValBytes(const Boolean& vals,
+                              const std::span<std::byte> buf) noexcept {
+    assert(buf.size() >= vals.size());
+#ifdef SECS2_COMPACT_BOOLEAN
+    std::ranges::copy(std::as_bytes(std::span {vals}), buf.begin());
+#else
     std::ranges::transform(
-        vals, std::back_inserter(buf),
+        vals, buf.begin(),
         [](const auto val) noexcept { return static_cast<std::byte>(val); });
-    return buf.size() - init_buf_size;
+#endif
+    return vals.size();
 }
 
-std::size_t CopyValBytes(const Item& item,
-                         std::vector<std::byte>& buf) noexcept {
+std::size_t WriteElemBytes(const List& list,
+                           const std::span<std::byte> buf) noexcept {
+    auto size {WriteHeaderBytes(Type::List, CalcLength(list), buf)};
+    {
+        [[maybe_unused]] const probe::EncodeListScope scope;
+        for (const auto& val : list) {
+            size += WriteMsgBytes(val, buf.subspan(size));
+        }
+    }
+
+    probe::EncodeElem(Type::List, size);
+    return size;
+}
+
+std::size_t WriteElemBytes(const Item& item,
+                           const std::span<std::byte> buf) noexcept {
     const auto type {GetType(item)};
-    assert(type != Type::Unknown && type != Type::List);
-    const auto init_buf_size {buf.size()};
+    auto size {WriteHeaderBytes(type, CalcLength(item), buf)};
+    size += WriteValBytes(item, buf.subspan(size));
+    probe::EncodeElem(type, size);
+    return size;
+}
+
+std::size_t WriteElemBytes(const Message::Value& val,
+                           const std::span<std::byte> buf) noexcept {
+    return WriteMsgBytes(val, buf);
+}
+
+/**
+ * @brief Build and append the bytes of a message to a buffer with a single allocation.
+ *
+ * @return
+ * The number of bytes written to the buffer if the message does not exceed the maximum allowed length.
+ * Otherwise @p std::nullopt and no byte is written to the buffer.
+ */
+template <typename T>
+std::optional<std::size_t> AppendMsgBytes(
+    const T& val, std::vector<std::byte>& buf) noexcept {
+    return CalcEncodedSize(val).transform(
+        [&val, &buf](const auto size) noexcept {
+            const auto init_buf_size {buf.size()};
+            buf.resize(init_buf_size + size);
+            return WriteElemBytes(val, std::span {buf}.subspan(init_buf_size));
+        });
+}
+
+}  // namespace
+
+std::size_t WriteValBytes(const Item& item,
+                          const std::span<std::byte> buf) noexcept {
+    assert(GetType(item) != Type::Unknown && GetType(item) != Type::List);
+    assert(buf.size() >= CalcLength(item));
     const Overload visitor {
-        [&buf](const Boolean& raw) noexcept { CopyBoolValBytes(raw, buf); },
-        [&buf](const auto& raw) noexcept {
+        [buf](const Boolean& raw) noexcept {
+            return WriteBoolValBytes(raw, buf);
+        },
+        [buf](const auto& raw) noexcept {
             using Value =
                 std::ranges::range_value_t<std::decay_t<decltype(raw)>>;
-            if constexpr (sizeof(Value) <= sizeof(std::byte)) {
-                std::ranges::copy(std::as_bytes(std::span {raw}),
-                                  std::back_inserter(buf));
+            const auto size {raw.size() * sizeof(Value)};
+            if constexpr (std::is_arithmetic_v<Value>) {
+                StoreBigEndian(std::span {raw}, buf.first(size));
             } else {
-                std::ranges::for_each(raw, [&buf](const auto val) noexcept {
-                    Value big_endian_val {};
-                    const auto big_endian_buf {
-                        std::as_writable_bytes(std::span {&big_endian_val, 1})};
-                    bit::WriteBytes(val, big_endian_buf, std::endian::big);
-                    std::ranges::copy(std::as_bytes(big_endian_buf),
-                                      std::back_inserter(buf));
-                });
+                std::ranges::copy(std::as_bytes(std::span {raw}), buf.begin());
             }
+            return size;
         }};
-    std::visit(visitor, item);
-    return buf.size() - init_buf_size;
+    return std::visit(visitor, item);
+}
+
+std::size_t WriteHeaderBytes(const Type type, const std::size_t len,
+                             const std::span<std::byte> buf) noexcept {
+    assert(IsNotExceedMaxLength(len));
+    assert(buf.size() >= codec::CalcHeaderSize(len));
+    return codec::WriteHeader(type, len, buf);
+}
+
+std::size_t WriteMsgBytes(const Message::Value& val,
+                          const std::span<std::byte> buf) noexcept {
+    return std::visit(
+        [buf](const auto& raw) noexcept { return WriteElemBytes(raw, buf); },
+        val);
+}
+
+std::size_t CopyValBytes(const Item& item,
+                         std::vector<std::byte>& buf) noexcept {
+    const auto init_buf_size {buf.size()};
+    buf.resize(init_buf_size + CalcLength(item));
+    return WriteValBytes(item, std::span {buf}.subspan(init_buf_size));
 }
 
 std::size_t BuildHeaderBytes(const Type type, const std::size_t len,
                              std::vector<std::byte>& buf) noexcept {
     assert(IsNotExceedMaxLength(len));
     const auto init_buf_size {buf.size()};
-    const auto format_byte {BuildFormatByte(type, len)};
-    buf.push_back(format_byte);
-
-    const LengthBytes len_bytes {len};
-    assert(len_bytes.valid_count <= len_bytes.reserved.size());
-    for (std::size_t i {0}; i != len_bytes.valid_count; ++i) {
-        buf.push_back(static_cast<std::byte>(len_bytes.reserved[i]));
-    }
-
-    return buf.size() - init_buf_size;
+    buf.resize(init_buf_size + codec::max_header_size);
+    const auto size {
+        WriteHeaderBytes(type, len, std::span {buf}.subspan(init_buf_size))};
+    buf.resize(init_buf_size + size);
+    return size;
 }
 
 std::optional<std::size_t> BuildMsgBytes(const Item& item,
                                          std::vector<std::byte>& buf) noexcept {
-    if (const auto len {CalcLength(item)}; IsNotExceedMaxLength(len))
-        [[likely]] {
-        const auto init_buf_size {buf.size()};
-        BuildHeaderBytes(GetType(item), len, buf);
-        CopyValBytes(item, buf);
-        return buf.size() - init_buf_size;
-    } else {
-        return std::nullopt;
-    }
+    return AppendMsgBytes(item, buf);
 }
 
 std::optional<std::size_t> BuildMsgBytes(const List& list,
                                          std::vector<std::byte>& buf) noexcept {
-    if (const auto len {CalcLength(list)}; IsNotExceedMaxLength(len))
-        [[likely]] {
-        const auto init_buf_size {buf.size()};
-        BuildHeaderBytes(Type::List, len, buf);
-        for (const auto& val : list) {
-            if (!std::visit(
-                     [&buf](const auto& raw) noexcept {
-                         return BuildMsgBytes(raw, buf);
-                     },
-                     val)
-                     .has_value()) [[unlikely]] {
-                buf.resize(init_buf_size);
-                buf.shrink_to_fit();
-                return std::nullopt;
-            }
-        }
-
-        return buf.size() - init_buf_size;
-    } else {
-        return std::nullopt;
-    }
+    return AppendMsgBytes(list, buf);
 }
 
 std::optional<std::size_t> BuildMsgBytes(const Message::Value& val,
                                          std::vector<std::byte>& buf) noexcept {
-    return std::visit(
-        [&buf](const auto& raw) noexcept { return BuildMsgBytes(raw, buf); },
-        val);
+    return AppendMsgBytes(val, buf);
 }
 
-}  // namespace secs2::byte::w
\ No newline at end of file
+}  // namespace secs2::byte::w
@@ -11,17 +11,71 @@
 #pragma once
 
 #include "length.h"
+#include "probe.h"
 #include "secs2.h"
+#include "swap.h"
+#include "traits.h"
 
 #include <bit_manip/bit_manip.h>
 
+#include <algorithm>
+#include <array>
 #include <cassert>
+#include <concepts>
 #include <cstdint>
 #include <optional>
+#include <ranges>
+#include <span>
+#include <type_traits>
 #include <vector>
 
 namespace secs2::byte::w {
 
+namespace err {
+
+//! Make an error indicating that a length exceeds the maximum allowed length.
+Error MakeExceededLengthError() noexcept;
+
+//! Make an error indicating that a buffer is too small.
+Error MakeInsufficientBufferError(std::size_t required,
+                                  std::size_t provided) noexcept;
+
+}  // namespace err
+
+//! A callable receiving consecutive chunks of serialized bytes.
+template <typename T>
+concept ByteConsumer = std::invocable<T&, std::span<const std::byte>>;
+
+/**
+ * @brief Write the bytes of an item to a buffer.
+ *
+ * @param item An item.
+ * @param buf A buffer whose size is at least @ref CalcLength of the item.
+ * @return The number of bytes written.
+ */
+std::size_t WriteValBytes(const Item& item, std::span<std::byte> buf) noexcept;
+
+/**
+ * @brief Write the bytes of a message header to a buffer.
+ *
+ * @param type A type.
+ * @param len The length, which must not exceed the maximum allowed length.
+ * @param buf A buffer that is large enough to hold the header.
+ * @return The number of bytes written.
+ */
+std::size_t WriteHeaderBytes(Type type, std::size_t len,
+                             std::span<std::byte> buf) noexcept;
+
+/**
+ * @brief Write the bytes of a message to a buffer.
+ *
+ * @param val A message whose lengths do not exceed the maximum allowed length.
+ * @param buf A buffer whose size is at least @ref CalcEncodedSize of the message.
+ * @return The number of bytes written.
+ */
+std::size_t WriteMsgBytes(const Message::Value& val,
+                          std::span<std::byte> buf) noexcept;
+
 //! Copy the bytes of an item to a buffer.
 std::size_t CopyValBytes(const Item& item,
                          std::vector<std::byte>& buf) noexcept;
@@ -48,20 +102,88 @@ std::optional<std::size_t> BuildMsgBytes(const List& list,
 std::optional<std::size_t> BuildMsgBytes(const Message::Value& val,
                                          std::vector<std::byte>& buf) noexcept;
 
-//! Build the format byte (the first byte) for a given type and length.
-constexpr std::byte BuildFormatByte(const Type type,
-                                    const std::size_t len) noexcept {
-    assert(IsNotExceedMaxLength(len));
-    [[assume(IsNotExceedMaxLength(len))]];
-    const auto len_byte_count {CalcLengthByteCount(len).value_or(0)};
-    assert(len_byte_count > 0);
-    [[assume(len_byte_count > 0)]];
-    std::byte byte {0};
-    bit::SetBits(byte, static_cast<std::uint8_t>(len_byte_count), len_bit_begin,
-                 len_bit_count);
-    bit::SetBits(byte, static_cast<std::uint8_t>(type), type_bit_begin,
-                 type_bit_count);
-    return byte;
+//! Build the bytes of a message header and pass them to a sink.
+template <ByteConsumer Sink>
+std::size_t EmitHeaderBytes(const Type type, const std::size_t len,
+                            Sink& sink) noexcept {
+    std::array<std::byte, codec::max_header_size> header;
+    const auto size {WriteHeaderBytes(type, len, header)};
+    sink(std::span<const std::byte> {header}.first(size));
+    return size;
+}
+
+/**
+ * @brief Pass the bytes of an item to a sink.
+ *
+ * @details
+ * Multi-byte values are converted to big-endian in fixed-size chunks on the stack,
+ * so no intermediate buffer is allocated.
+ */
+template <ByteConsumer Sink>
+std::size_t EmitValBytes(const Item& item, Sink& sink) noexcept {
+    assert(GetType(item) != Type::Unknown && GetType(item) != Type::List);
+    constexpr std::size_t chunk_size {256};
+    return std::visit(
+        [&sink]<typename T>(const T& raw) noexcept {
+            using Value = std::ranges::range_value_t<T>;
+            if constexpr (std::ranges::contiguous_range<T>
+                          && sizeof(Value) <= sizeof(std::byte)) {
+                sink(std::as_bytes(std::span {raw}));
+            } else {
+                constexpr auto chunk_count {chunk_size / sizeof(Value)};
+                std::array<std::byte, chunk_count * sizeof(Value)> chunk;
+                for (std::size_t i {0}; i < raw.size(); i += chunk_count) {
+                    const auto count {std::min(chunk_count, raw.size() - i)};
+                    const auto bytes {
+                        std::span {chunk}.first(count * sizeof(Value))};
+                    if constexpr (std::ranges::contiguous_range<T>) {
+                        StoreBigEndian(std::span {raw}.subspan(i, count),
+                                       bytes);
+                    } else {
+                        std::ranges::transform(
+                            raw | std::views::drop(i) | std::views::take(count),
+                            bytes.begin(), [](const auto val) noexcept {
+                                return static_cast<std::byte>(val);
+                            });
+                    }
+                    sink(std::span<const std::byte> {bytes});
+                }
+            }
+            return raw.size() * sizeof(Value);
+        },
+        item);
+}
+
+/**
+ * @brief Build the bytes of a message and pass them to a sink chunk by chunk.
+ *
+ * @param val A message whose lengths do not exceed the maximum allowed length.
+ * @param sink A sink.
+ * @return The number of bytes passed to the sink.
+ */
+template <ByteConsumer Sink>
+std::size_t EmitMsgBytes(const Message::Value& val, Sink& sink) noexcept {
+    const Overload visitor {
+        [&sink](const List& list) noexcept {
+            auto size {EmitHeaderBytes(Type::List, CalcLength(list), sink)};
+            {
+                [[maybe_unused]] const probe::EncodeListScope scope;
+                for (const auto& elem : list) {
+                    size += EmitMsgBytes(elem, sink);
+                }
+            }
+
+            probe::EncodeElem(Type::List, size);
+            return size;
+        },
+        [&sink](const Item& item) noexcept {
+            const auto type {GetType(item)};
+            auto size {EmitHeaderBytes(type, CalcLength(item), sink)};
+            size += EmitValBytes(item, sink);
+            probe::EncodeElem(type, size);
+            return size;
+        }};
+    return std::visit(visitor, val);
 }
 
-}  // namespace secs2::byte::w
\ No newline at end of file
+}  // namespace secs2::byte::w
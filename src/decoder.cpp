@@ -0,0 +1,257 @@
+#include "decoder.h"
+#include "byte/length.h"
+#include "byte/read.h"
+#include "traits.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace secs2 {
+
+MessageDecoder::MessageDecoder(const DecodeOptions& opts) noexcept :
+    opts_ {opts} {}
+
+#ifdef SECS2_USE_PMR
+MessageDecoder::MessageDecoder(std::pmr::memory_resource* const resource,
+                               const DecodeOptions& opts) noexcept :
+    opts_ {opts}, resource_ {resource} {
+    assert(resource_ != nullptr);
+}
+#endif
+
+std::expected<std::size_t, Error> MessageDecoder::Feed(
+    const std::span<const std::byte> bytes) noexcept {
+    std::size_t consumed_size {0};
+    while (consumed_size != bytes.size()) {
+        std::expected<std::size_t, Error> size;
+        switch (state_) {
+            case State::Header:
+                size = FeedHeader(bytes.subspan(consumed_size));
+                break;
+            case State::Body:
+                size = FeedBody(bytes.subspan(consumed_size));
+                break;
+            case State::Done:
+                return consumed_size;
+            case State::Failed:
+                assert(err_.has_value());
+                return std::unexpected {*err_};
+        }
+
+        if (size.has_value()) [[likely]] {
+            consumed_size += *size;
+            byte_size_ += *size;
+        } else {
+            return std::unexpected {std::move(size).error()};
+        }
+    }
+
+    if (state_ == State::Failed) [[unlikely]] {
+        assert(err_.has_value());
+        return std::unexpected {*err_};
+    }
+
+    return consumed_size;
+}
+
+std::expected<std::size_t, Error> MessageDecoder::FeedHeader(
+    const std::span<const std::byte> bytes) noexcept {
+    assert(!bytes.empty());
+    std::size_t consumed_size {0};
+    if (header_size_ == 0) {
+        const auto [type, len_byte_count] {
+            byte::r::ReadFormatByte(bytes.front())};
+        if (IsExceedLengthByteCountRange(len_byte_count)) [[unlikely]] {
+            return Fail(
+                byte::r::err::MakeInvalidLengthByteCountError(len_byte_count));
+        } else if (!IsKnownType(type)) [[unlikely]] {
+            return Fail(byte::r::err::MakeUnknownTypeError(type));
+        }
+
+        len_byte_count_ = len_byte_count;
+        header_[header_size_++] = bytes.front();
+        ++consumed_size;
+    }
+
+    const auto header_size {sizeof(std::byte) + len_byte_count_};
+    const auto count {std::min(header_size - header_size_,
+                               bytes.size() - consumed_size)};
+    std::ranges::copy_n(bytes.begin() + consumed_size, count,
+                        header_.begin() + header_size_);
+    header_size_ += count;
+    consumed_size += count;
+    if (header_size_ != header_size) {
+        return consumed_size;
+    }
+
+    const auto header {
+        byte::r::ReadHeader(std::span {header_}.first(header_size_))};
+    assert(header.has_value());
+    type_ = header->type;
+    len_ = header->len;
+    header_size_ = 0;
+
+    if (elem_count_ == opts_.max_elem_count) [[unlikely]] {
+        return Fail(
+            byte::r::err::MakeExceededElemCountError(opts_.max_elem_count));
+    }
+
+    ++elem_count_;
+    if (!frames_.empty()) {
+        // The element will be stored in the enclosing list.
+        auto ctx {GetLoadContext()};
+        const auto added {
+            byte::r::AddAllocSize(ctx, Type::List, sizeof(ListElem))};
+        alloc_size_ = ctx.alloc_size;
+        if (!added.has_value()) [[unlikely]] {
+            return Fail(added.error());
+        }
+    }
+
+    if (type_ == Type::List) {
+        // Partially decoded lists are the lists enclosing the current one.
+        if (frames_.size() == opts_.max_depth) [[unlikely]] {
+            return Fail(byte::r::err::MakeExceededDepthError(opts_.max_depth));
+        }
+
+        if (len_ == 0) {
+            Complete(byte::r::MakeEmptyValue<List>(GetLoadContext()));
+        } else {
+            // The capacity is not reserved from the declared length,
+            // which has not been backed by any received byte yet.
+            frames_.push_back(
+                {.list = byte::r::MakeEmptyValue<List>(GetLoadContext()),
+                 .remaining_count = len_});
+        }
+        return consumed_size;
+    }
+
+    if (const auto align {GetElemSize(type_)}; len_ % align != 0)
+        [[unlikely]] {
+        return Fail(
+            byte::r::err::MakeUnalignedLengthError(len_, type_, align));
+    } else if (len_ > opts_.max_alloc_size - alloc_size_) [[unlikely]] {
+        // The value requires at least as many bytes as its length,
+        // so it is rejected before its body is buffered.
+        return Fail(
+            byte::r::err::MakeExceededAllocSizeError(opts_.max_alloc_size));
+    }
+
+    state_ = State::Body;
+    body_.clear();
+    if (len_ == 0) {
+        auto loaded {LoadVal({})};
+        assert(loaded.has_value());
+        Complete(std::move(*loaded));
+    }
+
+    return consumed_size;
+}
+
+std::expected<std::size_t, Error> MessageDecoder::FeedBody(
+    const std::span<const std::byte> bytes) noexcept {
+    const auto count {std::min(len_ - body_.size(), bytes.size())};
+    std::span<const std::byte> val_bytes;
+    if (body_.empty() && count == len_) {
+        // The whole value is available, so it can be decoded without buffering.
+        val_bytes = bytes.first(count);
+    } else {
+        body_.insert(body_.end(), bytes.begin(), bytes.begin() + count);
+        if (body_.size() != len_) {
+            return count;
+        }
+
+        val_bytes = body_;
+    }
+
+    auto loaded {LoadVal(val_bytes)};
+    if (!loaded.has_value()) [[unlikely]] {
+        return Fail(std::move(loaded).error());
+    }
+
+    Complete(std::move(*loaded));
+    return count;
+}
+
+std::expected<Message::Value, Error> MessageDecoder::LoadVal(
+    const std::span<const std::byte> bytes) noexcept {
+    auto ctx {GetLoadContext()};
+    auto loaded {byte::r::LoadValBytes(type_, bytes, len_, ctx)};
+    alloc_size_ = ctx.alloc_size;
+    return std::move(loaded).transform(
+        [](byte::r::Loaded&& val) noexcept { return std::move(val.first); });
+}
+
+void MessageDecoder::Complete(Message::Value val) noexcept {
+    state_ = State::Header;
+    while (!frames_.empty()) {
+        auto& frame {frames_.back()};
+        frame.list.push_back(std::move(val));
+        if (--frame.remaining_count != 0) {
+            return;
+        }
+
+        val = std::move(frame.list);
+        frames_.pop_back();
+    }
+
+    val_ = std::move(val);
+    state_ = State::Done;
+}
+
+std::expected<std::size_t, Error> MessageDecoder::Fail(Error err) noexcept {
+    state_ = State::Failed;
+    err_ = err;
+    return std::unexpected {std::move(err)};
+}
+
+byte::r::LoadContext MessageDecoder::GetLoadContext() const noexcept {
+    return {
+#ifdef SECS2_USE_PMR
+        .resource = resource_,
+#endif
+        .opts = opts_,
+        .depth = frames_.size(),
+        .elem_count = elem_count_,
+        .alloc_size = alloc_size_};
+}
+
+bool MessageDecoder::HasMessage() const noexcept {
+    return state_ == State::Done;
+}
+
+bool MessageDecoder::HasError() const noexcept {
+    return state_ == State::Failed;
+}
+
+std::size_t MessageDecoder::GetByteSize() const noexcept {
+    return byte_size_;
+}
+
+std::optional<DeserializedMessage> MessageDecoder::TakeMessage() noexcept {
+    if (!HasMessage()) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    assert(val_.has_value());
+    DeserializedMessage loaded {Message {std::move(*val_)}, byte_size_};
+    Reset();
+    return loaded;
+}
+
+void MessageDecoder::Reset() noexcept {
+    state_ = State::Header;
+    header_size_ = 0;
+    len_byte_count_ = 0;
+    type_ = Type::Unknown;
+    len_ = 0;
+    body_.clear();
+    frames_.clear();
+    val_.reset();
+    err_.reset();
+    elem_count_ = 0;
+    alloc_size_ = 0;
+    byte_size_ = 0;
+}
+
+}  // namespace secs2
@@ -0,0 +1,71 @@
+#include "encoded.h"
+#include "byte/write.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace secs2 {
+
+EncodedMessage::EncodedMessage(Message msg) noexcept :
+    msg_ {std::move(msg)}, bytes_ {msg_.ToBytes()} {}
+
+const Message& EncodedMessage::GetMessage() const noexcept {
+    return msg_;
+}
+
+std::optional<std::size_t> EncodedMessage::GetEncodedSize() const noexcept {
+    return bytes_.transform([](const std::vector<std::byte>& bytes) noexcept {
+        return bytes.size();
+    });
+}
+
+std::optional<std::span<const std::byte>> EncodedMessage::ToBytes()
+    const noexcept {
+    if (!bytes_.has_value()) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    return std::span<const std::byte> {*bytes_};
+}
+
+std::expected<std::size_t, Error> EncodedMessage::SerializeInto(
+    const std::span<std::byte> buf) const noexcept {
+    const auto bytes {ToBytes()};
+    if (!bytes.has_value()) [[unlikely]] {
+        return std::unexpected {byte::w::err::MakeExceededLengthError()};
+    } else if (buf.size() < bytes->size()) [[unlikely]] {
+        return std::unexpected {byte::w::err::MakeInsufficientBufferError(
+            bytes->size(), buf.size())};
+    }
+
+    std::ranges::copy(*bytes, buf.begin());
+    return bytes->size();
+}
+
+std::expected<std::size_t, Error> EncodedMessage::SerializeInto(
+    const ByteSink& sink) const noexcept {
+    const auto bytes {ToBytes()};
+    if (!bytes.has_value()) [[unlikely]] {
+        return std::unexpected {byte::w::err::MakeExceededLengthError()};
+    }
+
+    sink(*bytes);
+    return bytes->size();
+}
+
+void EncodedMessage::swap(EncodedMessage& other) noexcept {
+    using std::swap;
+    swap(msg_, other.msg_);
+    swap(bytes_, other.bytes_);
+}
+
+void EncodedMessage::swap(Message& msg) noexcept {
+    msg_.swap(msg);
+    bytes_ = msg_.ToBytes();
+}
+
+void swap(EncodedMessage& lhs, EncodedMessage& rhs) noexcept {
+    lhs.swap(rhs);
+}
+
+}  // namespace secs2
@@ -0,0 +1,348 @@
+#include "hash.h"
+#include "byte/length.h"
+#include "byte/read.h"
+#include "byte/swap.h"
+#include "traits.h"
+
+#include <bit_manip/bit_manip.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <ranges>
+#include <type_traits>
+
+namespace secs2 {
+
+namespace {
+
+//! The size of chunks for converting values on the stack.
+constexpr std::size_t chunk_size {256};
+
+//! A streaming 64-bit hash whose result does not depend on how bytes are split into chunks.
+class Hasher {
+public:
+    void Update(std::span<const std::byte> bytes) noexcept {
+        total_size_ += bytes.size();
+        if (tail_size_ != 0) {
+            const auto count {std::min(tail_.size() - tail_size_, bytes.size())};
+            std::ranges::copy(bytes.first(count), tail_.begin() + tail_size_);
+            tail_size_ += count;
+            bytes = bytes.subspan(count);
+            if (tail_size_ != tail_.size()) {
+                return;
+            }
+
+            state_ = Mix(state_, LoadWord(tail_));
+            tail_size_ = 0;
+        }
+
+        for (; bytes.size() >= sizeof(std::uint64_t);
+             bytes = bytes.subspan(sizeof(std::uint64_t))) {
+            state_ = Mix(state_, LoadWord(bytes));
+        }
+
+        std::ranges::copy(bytes, tail_.begin());
+        tail_size_ = bytes.size();
+    }
+
+    //! Hash the format code and the length of an item or list.
+    void UpdateHeader(const Type type, const std::size_t len) noexcept {
+        std::array<std::byte, sizeof(std::byte) + sizeof(std::uint32_t)> header;
+        header.front() = static_cast<std::byte>(type);
+        bit::WriteBytes(static_cast<std::uint32_t>(len),
+                        std::span {header}.subspan(1), std::endian::big);
+        Update(header);
+    }
+
+    std::uint64_t Finish() const noexcept {
+        auto state {state_};
+        if (tail_size_ != 0) {
+            std::array<std::byte, sizeof(std::uint64_t)> word {};
+            std::ranges::copy_n(tail_.begin(), tail_size_, word.begin());
+            state = Mix(state, LoadWord(word));
+        }
+
+        // The finalizer of MurmurHash3.
+        state ^= total_size_;
+        state ^= state >> 33;
+        state *= 0xFF51AFD7ED558CCD;
+        state ^= state >> 33;
+        state *= 0xC4CEB9FE1A85EC53;
+        state ^= state >> 33;
+        return state;
+    }
+
+private:
+    static std::uint64_t LoadWord(
+        const std::span<const std::byte> bytes) noexcept {
+        std::uint64_t word;
+        std::memcpy(&word, bytes.data(), sizeof(word));
+        return word;
+    }
+
+    static std::uint64_t Mix(const std::uint64_t state,
+                             std::uint64_t word) noexcept {
+        word *= 0x87C37B91114253D5;
+        word = std::rotl(word, 31);
+        word *= 0x4CF5AD432745937F;
+        return std::rotl(state ^ word, 27) * 5 + 0x52DCE729;
+    }
+
+    std::uint64_t state_ {0x9E3779B97F4A7C15};
+    std::uint64_t total_size_ {0};
+    std::array<std::byte, sizeof(std::uint64_t)> tail_ {};
+    std::size_t tail_size_ {0};
+};
+
+//! Hash the value of an item in the same form as its normalized big-endian bytes.
+void HashItemVal(Hasher& hasher, const Item& item) noexcept {
+    std::visit(
+        [&hasher]<typename T>(const T& raw) noexcept {
+            using Value = std::ranges::range_value_t<T>;
+            if constexpr (std::same_as<T, Boolean>) {
+                std::array<std::byte, chunk_size> chunk;
+                for (std::size_t i {0}; i < raw.size(); i += chunk.size()) {
+                    const auto count {std::min(chunk.size(), raw.size() - i)};
+                    std::ranges::transform(
+                        raw | std::views::drop(i) | std::views::take(count),
+                        chunk.begin(), [](const auto val) noexcept {
+                            return static_cast<std::byte>(
+                                static_cast<bool>(val));
+                        });
+                    hasher.Update(std::span {chunk}.first(count));
+                }
+            } else if constexpr (sizeof(Value) == sizeof(std::byte)) {
+                hasher.Update(std::as_bytes(std::span {raw}));
+            } else {
+                constexpr auto chunk_count {chunk_size / sizeof(Value)};
+                std::array<Value, chunk_count> vals;
+                std::array<std::byte, chunk_count * sizeof(Value)> chunk;
+                for (std::size_t i {0}; i < raw.size(); i += chunk_count) {
+                    const auto count {std::min(chunk_count, raw.size() - i)};
+                    auto src {std::span {raw}.subspan(i, count)};
+                    if constexpr (std::is_floating_point_v<Value>) {
+                        // Negative zero is equal to positive zero.
+                        std::ranges::transform(
+                            src, vals.begin(), [](const Value val) noexcept {
+                                return val == 0 ? Value {0} : val;
+                            });
+                        src = std::span {vals}.first(count);
+                    }
+
+                    const auto bytes {
+                        std::span {chunk}.first(count * sizeof(Value))};
+                    byte::StoreBigEndian(std::span<const Value> {src}, bytes);
+                    hasher.Update(bytes);
+                }
+            }
+        },
+        item);
+}
+
+void HashVal(Hasher& hasher, const Message::Value& val) noexcept {
+    const Overload visitor {
+        [&hasher](const List& list) noexcept {
+            hasher.UpdateHeader(Type::List, list.size());
+            for (const auto& elem : list) {
+                HashVal(hasher, elem);
+            }
+        },
+        [&hasher](const Item& item) noexcept {
+            hasher.UpdateHeader(GetType(item), CalcLength(item));
+            HashItemVal(hasher, item);
+        }};
+    std::visit(visitor, val);
+}
+
+//! Check whether big-endian bytes are a negative zero.
+bool IsNegativeZero(const std::span<const std::byte> bytes) noexcept {
+    return bytes.front() == std::byte {0x80}
+           && std::ranges::all_of(bytes.subspan(1), [](const auto byte) noexcept {
+                  return byte == std::byte {0};
+              });
+}
+
+//! Hash the bytes of a value after normalizing them in the same way as @ref HashItemVal.
+void HashValBytes(Hasher& hasher, const Type type,
+                  std::span<const std::byte> bytes) noexcept {
+    if (type != Type::Boolean && type != Type::F4 && type != Type::F8) {
+        hasher.Update(bytes);
+        return;
+    }
+
+    const auto elem_size {GetElemSize(type)};
+    std::array<std::byte, chunk_size> chunk;
+    while (!bytes.empty()) {
+        const auto count {std::min(chunk.size(), bytes.size())};
+        const auto normalized {std::span {chunk}.first(count)};
+        std::ranges::copy(bytes.first(count), normalized.begin());
+        if (type == Type::Boolean) {
+            std::ranges::transform(normalized, normalized.begin(),
+                                   [](const auto byte) noexcept {
+                                       return static_cast<std::byte>(
+                                           byte != std::byte {0});
+                                   });
+        } else {
+            for (std::size_t i {0}; i != count; i += elem_size) {
+                if (const auto val {normalized.subspan(i, elem_size)};
+                    IsNegativeZero(val)) {
+                    val.front() = std::byte {0};
+                }
+            }
+        }
+
+        hasher.Update(normalized);
+        bytes = bytes.subspan(count);
+    }
+}
+
+//! Check whether two serialized floating-point values are equal as numbers.
+template <typename T>
+bool EqualFloatBytes(const std::span<const std::byte> lhs,
+                     const std::span<const std::byte> rhs) noexcept {
+    for (std::size_t i {0}; i < lhs.size(); i += sizeof(T)) {
+        T lhs_val, rhs_val;
+        bit::ReadBytes(lhs.subspan(i, sizeof(T)), lhs_val, std::endian::big);
+        bit::ReadBytes(rhs.subspan(i, sizeof(T)), rhs_val, std::endian::big);
+        if (lhs_val != rhs_val) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//! Check whether the bytes of two values of the same type and length are equal as deserialized values.
+bool EqualValBytes(const Type type, const std::span<const std::byte> lhs,
+                   const std::span<const std::byte> rhs) noexcept {
+    assert(lhs.size() == rhs.size());
+    switch (type) {
+        case Type::Boolean: {
+            return std::ranges::equal(lhs, rhs, [](const auto l, const auto r) {
+                return (l != std::byte {0}) == (r != std::byte {0});
+            });
+        }
+        case Type::F4: {
+            return EqualFloatBytes<float>(lhs, rhs);
+        }
+        case Type::F8: {
+            return EqualFloatBytes<double>(lhs, rhs);
+        }
+        default: {
+            return std::ranges::equal(lhs, rhs);
+        }
+    }
+}
+
+//! Check that a buffer contains a whole aligned value.
+std::expected<void, Error> CheckValBytes(const std::span<const std::byte> bytes,
+                                         const byte::r::Header& header) noexcept {
+    if (bytes.size() < header.len) [[unlikely]] {
+        return std::unexpected {byte::r::err::MakeIncompleteDataError()};
+    } else if (const auto align {GetElemSize(header.type)};
+               header.len % align != 0) [[unlikely]] {
+        return std::unexpected {
+            byte::r::err::MakeUnalignedLengthError(header.len, header.type,
+                                                   align)};
+    }
+
+    return {};
+}
+
+}  // namespace
+
+std::uint64_t HashValue(const Message::Value& val) noexcept {
+    Hasher hasher;
+    HashVal(hasher, val);
+    return hasher.Finish();
+}
+
+std::uint64_t HashMsg(const Message& msg) noexcept {
+    return HashValue(msg.GetValue());
+}
+
+std::expected<std::uint64_t, Error> HashMsgBytes(
+    const std::span<const std::byte> bytes) noexcept {
+    Hasher hasher;
+    // Elements are read in pre-order, the same as @ref byte::r::CheckMsgBytes.
+    std::size_t pending_count {1};
+    std::size_t byte_size {0};
+    while (pending_count != 0) {
+        const auto header {byte::r::ReadHeader(bytes.subspan(byte_size))};
+        if (!header.has_value()) [[unlikely]] {
+            return std::unexpected {header.error()};
+        }
+
+        byte_size += header->size;
+        --pending_count;
+        hasher.UpdateHeader(header->type, header->len);
+        if (header->type == Type::List) {
+            pending_count += header->len;
+            continue;
+        }
+
+        const auto val_bytes {bytes.subspan(byte_size)};
+        if (const auto checked {CheckValBytes(val_bytes, *header)};
+            !checked.has_value()) [[unlikely]] {
+            return std::unexpected {checked.error()};
+        }
+
+        HashValBytes(hasher, header->type, val_bytes.first(header->len));
+        byte_size += header->len;
+    }
+
+    return hasher.Finish();
+}
+
+std::expected<bool, Error> EqualMsgBytes(
+    const std::span<const std::byte> lhs,
+    const std::span<const std::byte> rhs) noexcept {
+    std::size_t pending_count {1};
+    std::size_t lhs_size {0};
+    std::size_t rhs_size {0};
+    while (pending_count != 0) {
+        const auto lhs_header {byte::r::ReadHeader(lhs.subspan(lhs_size))};
+        if (!lhs_header.has_value()) [[unlikely]] {
+            return std::unexpected {lhs_header.error()};
+        }
+
+        const auto rhs_header {byte::r::ReadHeader(rhs.subspan(rhs_size))};
+        if (!rhs_header.has_value()) [[unlikely]] {
+            return std::unexpected {rhs_header.error()};
+        } else if (lhs_header->type != rhs_header->type
+                   || lhs_header->len != rhs_header->len) {
+            return false;
+        }
+
+        lhs_size += lhs_header->size;
+        rhs_size += rhs_header->size;
+        --pending_count;
+        if (lhs_header->type == Type::List) {
+            pending_count += lhs_header->len;
+            continue;
+        }
+
+        const auto lhs_val {lhs.subspan(lhs_size)};
+        const auto rhs_val {rhs.subspan(rhs_size)};
+        if (const auto checked {CheckValBytes(lhs_val, *lhs_header)};
+            !checked.has_value()) [[unlikely]] {
+            return std::unexpected {checked.error()};
+        } else if (const auto checked {CheckValBytes(rhs_val, *rhs_header)};
+                   !checked.has_value()) [[unlikely]] {
+            return std::unexpected {checked.error()};
+        } else if (!EqualValBytes(lhs_header->type,
+                                  lhs_val.first(lhs_header->len),
+                                  rhs_val.first(rhs_header->len))) {
+            return false;
+        }
+
+        lhs_size += lhs_header->len;
+        rhs_size += rhs_header->len;
+    }
+
+    return true;
+}
+
+}  // namespace secs2
@@ -0,0 +1,211 @@
+#include "index.h"
+#include "byte/read.h"
+#include "traits.h"
+
+#include <cassert>
+#include <format>
+#include <system_error>
+#include <utility>
+
+namespace secs2 {
+
+namespace {
+
+namespace err {
+
+//! Make an error indicating that an element on a path does not exist.
+Error MakeMissingElemError(const std::size_t depth) noexcept {
+    return {std::make_error_code(std::errc::result_out_of_range),
+            std::format("The element at depth {} does not exist", depth)};
+}
+
+//! Make an error indicating that an element is not of the expected type.
+Error MakeMismatchedTypeError(const Type expected,
+                              const Type actual) noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            std::format("The element is {} rather than {}",
+                        to_string(actual), to_string(expected))};
+}
+
+}  // namespace err
+
+//! A list whose elements have not all been indexed yet.
+struct Frame {
+    //! The index of the list node.
+    std::size_t node {0};
+    //! The number of elements that have not been indexed.
+    std::size_t pending_count {0};
+};
+
+}  // namespace
+
+std::expected<MsgHeader, Error> ReadMsgHeader(
+    const std::span<const std::byte> bytes) noexcept {
+    return byte::r::ReadHeader(bytes);
+}
+
+std::expected<std::span<const std::byte>, Error> FindElemBytes(
+    const std::span<const std::byte> bytes,
+    const std::span<const std::size_t> path) noexcept {
+    std::size_t offset {0};
+    for (std::size_t depth {0}; depth != path.size(); ++depth) {
+        const auto header {byte::r::ReadHeader(bytes.subspan(offset))};
+        if (!header.has_value()) [[unlikely]] {
+            return std::unexpected {header.error()};
+        } else if (header->type != Type::List || path[depth] >= header->len)
+            [[unlikely]] {
+            return std::unexpected {err::MakeMissingElemError(depth)};
+        }
+
+        offset += header->size;
+        for (std::size_t i {0}; i != path[depth]; ++i) {
+            const auto skipped {byte::r::CheckMsgBytes(bytes.subspan(offset))};
+            if (!skipped.has_value()) [[unlikely]] {
+                return std::unexpected {skipped.error()};
+            }
+
+            offset += *skipped;
+        }
+    }
+
+    return bytes.subspan(offset);
+}
+
+template <typename T>
+std::expected<T, Error> Extract(
+    const std::span<const std::byte> bytes,
+    const std::span<const std::size_t> path) noexcept {
+    const auto elem_bytes {FindElemBytes(bytes, path)};
+    if (!elem_bytes.has_value()) [[unlikely]] {
+        return std::unexpected {elem_bytes.error()};
+    }
+
+    const auto header {byte::r::ReadHeader(*elem_bytes)};
+    if (!header.has_value()) [[unlikely]] {
+        return std::unexpected {header.error()};
+    } else if (header->type != format_code<T>) [[unlikely]] {
+        return std::unexpected {
+            err::MakeMismatchedTypeError(format_code<T>, header->type)};
+    }
+
+    byte::r::LoadContext ctx;
+    auto loaded {byte::r::LoadMsgBytes(*elem_bytes, ctx)};
+    if (!loaded.has_value()) [[unlikely]] {
+        return std::unexpected {std::move(loaded).error()};
+    }
+
+    const auto val {GetItemPtr<T>(loaded->first)};
+    assert(val != nullptr);
+    return std::move(*val);
+}
+
+#define INSTANTIATE_EXTRACT(type)                                              \
+    template std::expected<type, Error> Extract<type>(                         \
+        std::span<const std::byte>, std::span<const std::size_t>) noexcept;
+
+INSTANTIATE_EXTRACT(List)
+INSTANTIATE_EXTRACT(Binary)
+INSTANTIATE_EXTRACT(ASCII)
+INSTANTIATE_EXTRACT(Boolean)
+INSTANTIATE_EXTRACT(I1)
+INSTANTIATE_EXTRACT(I2)
+INSTANTIATE_EXTRACT(I4)
+INSTANTIATE_EXTRACT(I8)
+INSTANTIATE_EXTRACT(U1)
+INSTANTIATE_EXTRACT(U2)
+INSTANTIATE_EXTRACT(U4)
+INSTANTIATE_EXTRACT(U8)
+INSTANTIATE_EXTRACT(F4)
+INSTANTIATE_EXTRACT(F8)
+
+MessageIndex::MessageIndex(std::vector<IndexNode> nodes) noexcept :
+    nodes_ {std::move(nodes)} {}
+
+std::expected<MessageIndex, Error> MessageIndex::Build(
+    const std::span<const std::byte> bytes) noexcept {
+    std::vector<IndexNode> nodes;
+    std::vector<Frame> frames;
+    std::size_t byte_size {0};
+    do {
+        const auto header {byte::r::ReadHeader(bytes.subspan(byte_size))};
+        if (!header.has_value()) [[unlikely]] {
+            return std::unexpected {header.error()};
+        }
+
+        IndexNode node {.type = header->type,
+                        .offset = byte_size,
+                        .header_size = header->size,
+                        .len = header->len};
+        byte_size += header->size;
+        if (header->type == Type::List) {
+            if (header->len != 0) {
+                frames.push_back({.node = nodes.size(),
+                                  .pending_count = header->len});
+                nodes.push_back(node);
+                continue;
+            }
+        } else {
+            if (bytes.size() - byte_size < header->len) [[unlikely]] {
+                return std::unexpected {
+                    byte::r::err::MakeIncompleteDataError()};
+            } else if (const auto align {GetElemSize(header->type)};
+                       header->len % align != 0) [[unlikely]] {
+                return std::unexpected {byte::r::err::MakeUnalignedLengthError(
+                    header->len, header->type, align)};
+            }
+
+            byte_size += header->len;
+        }
+
+        node.byte_size = byte_size - node.offset;
+        node.end = nodes.size() + 1;
+        nodes.push_back(node);
+
+        // An element is complete, which may also complete its parent lists.
+        while (!frames.empty() && --frames.back().pending_count == 0) {
+            auto& list {nodes[frames.back().node]};
+            list.byte_size = byte_size - list.offset;
+            list.end = nodes.size();
+            frames.pop_back();
+        }
+    } while (!frames.empty());
+
+    return MessageIndex {std::move(nodes)};
+}
+
+std::span<const IndexNode> MessageIndex::GetNodes() const noexcept {
+    return nodes_;
+}
+
+std::size_t MessageIndex::GetByteSize() const noexcept {
+    assert(!nodes_.empty());
+    return nodes_.front().byte_size;
+}
+
+std::optional<std::size_t> MessageIndex::GetElem(
+    const std::size_t node, const std::size_t idx) const noexcept {
+    assert(node < nodes_.size());
+    if (nodes_[node].type != Type::List || idx >= nodes_[node].len) {
+        return std::nullopt;
+    }
+
+    auto elem {node + 1};
+    for (std::size_t i {0}; i != idx; ++i) {
+        elem = nodes_[elem].end;
+    }
+    return elem;
+}
+
+std::optional<std::size_t> MessageIndex::Find(
+    const std::span<const std::size_t> path) const noexcept {
+    std::optional<std::size_t> node {0};
+    for (const auto idx : path) {
+        node = GetElem(*node, idx);
+        if (!node.has_value()) {
+            break;
+        }
+    }
+    return node;
+}
+
+}  // namespace secs2
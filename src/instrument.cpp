@@ -0,0 +1,263 @@
+#include "instrument.h"
+
+#ifdef SECS2_INSTRUMENTATION
+
+#include <algorithm>
+#include <cassert>
+#include <format>
+#include <iterator>
+#include <string_view>
+
+namespace secs2::instrument {
+
+namespace {
+
+std::atomic<Hooks*> installed_hooks {nullptr};
+
+//! Raise an atomic maximum to a value.
+void RaiseMax(std::atomic<std::size_t>& max, const std::size_t val) noexcept {
+    auto curr {max.load(std::memory_order_relaxed)};
+    while (curr < val
+           && !max.compare_exchange_weak(curr, val,
+                                         std::memory_order_relaxed)) {
+    }
+}
+
+//! Get the index of the bucket of a latency.
+std::size_t GetBucket(const std::uint64_t latency) noexcept {
+    return static_cast<std::size_t>(
+        std::ranges::lower_bound(Metrics::latency_bounds, latency)
+        - Metrics::latency_bounds.begin());
+}
+
+//! Append a metric family header in the Prometheus text exposition format.
+void AppendFamily(std::string& buf, const std::string_view name,
+                  const std::string_view type,
+                  const std::string_view help) noexcept {
+    std::format_to(std::back_inserter(buf), "# HELP {} {}\n# TYPE {} {}\n",
+                   name, help, name, type);
+}
+
+}  // namespace
+
+std::string to_string(const Operation op) noexcept {
+    static constexpr std::array<std::string_view, operation_count> names {
+        "ToBytes", "BuildFromBytes", "ToSml"};
+    assert(static_cast<std::size_t>(op) < names.size());
+    return std::string {names[static_cast<std::size_t>(op)]};
+}
+
+std::string to_string(const ErrorKind kind) noexcept {
+    static constexpr std::array<std::string_view, error_kind_count> names {
+        "None",
+        "IncompleteData",
+        "UnalignedLength",
+        "UnknownType",
+        "InvalidLengthByteCount",
+        "ExceededLength",
+        "InsufficientBuffer",
+        "ExceededDepth",
+        "ExceededElemCount",
+        "ExceededAllocSize",
+        "Other"};
+    assert(static_cast<std::size_t>(kind) < names.size());
+    return std::string {names[static_cast<std::size_t>(kind)]};
+}
+
+Hooks* SetHooks(Hooks* const hooks) noexcept {
+    return installed_hooks.exchange(hooks, std::memory_order_acq_rel);
+}
+
+Hooks* GetHooks() noexcept {
+    return installed_hooks.load(std::memory_order_acquire);
+}
+
+void Metrics::Add(AtomicElemStats& stats, const std::size_t byte_size) noexcept {
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    stats.byte_size.fetch_add(byte_size, std::memory_order_relaxed);
+}
+
+Metrics::ElemStats Metrics::Load(const AtomicElemStats& stats) noexcept {
+    return {.count = stats.count.load(std::memory_order_relaxed),
+            .byte_size = stats.byte_size.load(std::memory_order_relaxed)};
+}
+
+void Metrics::OnEncodeElem(const Type type, const std::size_t byte_size,
+                           const std::size_t depth) noexcept {
+    Add(encoded_[static_cast<std::size_t>(type)], byte_size);
+    RaiseMax(max_encode_depth_, depth);
+}
+
+void Metrics::OnDecodeElem(const Type type, const std::size_t byte_size,
+                           const std::size_t depth) noexcept {
+    Add(decoded_[static_cast<std::size_t>(type)], byte_size);
+    RaiseMax(max_decode_depth_, depth);
+}
+
+void Metrics::OnDecodeAlloc(const Type type, const std::size_t size) noexcept {
+    Add(decode_allocs_[static_cast<std::size_t>(type)], size);
+}
+
+void Metrics::OnOperation(const Operation op,
+                          const std::chrono::nanoseconds latency,
+                          const std::error_code& err,
+                          const ErrorKind kind) noexcept {
+    const auto ns {static_cast<std::uint64_t>(latency.count())};
+    auto& stats {latencies_[static_cast<std::size_t>(op)]};
+    stats.buckets[GetBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    stats.sum.fetch_add(ns, std::memory_order_relaxed);
+    stats.count.fetch_add(1, std::memory_order_relaxed);
+    if (err) [[unlikely]] {
+        const auto idx {kind != ErrorKind::None ? kind : ErrorKind::Other};
+        errs_[static_cast<std::size_t>(op)][static_cast<std::size_t>(idx)]
+            .fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+Metrics::ElemStats Metrics::GetEncoded(const Type type) const noexcept {
+    return Load(encoded_[static_cast<std::size_t>(type)]);
+}
+
+Metrics::ElemStats Metrics::GetDecoded(const Type type) const noexcept {
+    return Load(decoded_[static_cast<std::size_t>(type)]);
+}
+
+Metrics::ElemStats Metrics::GetDecodeAllocs(const Type type) const noexcept {
+    return Load(decode_allocs_[static_cast<std::size_t>(type)]);
+}
+
+std::size_t Metrics::GetMaxEncodeDepth() const noexcept {
+    return max_encode_depth_.load(std::memory_order_relaxed);
+}
+
+std::size_t Metrics::GetMaxDecodeDepth() const noexcept {
+    return max_decode_depth_.load(std::memory_order_relaxed);
+}
+
+Metrics::LatencyStats Metrics::GetLatency(const Operation op) const noexcept {
+    const auto& stats {latencies_[static_cast<std::size_t>(op)]};
+    LatencyStats loaded {.sum = stats.sum.load(std::memory_order_relaxed),
+                         .count = stats.count.load(std::memory_order_relaxed)};
+    std::ranges::transform(stats.buckets, loaded.buckets.begin(),
+                           [](const auto& bucket) noexcept {
+                               return bucket.load(std::memory_order_relaxed);
+                           });
+    return loaded;
+}
+
+std::uint64_t Metrics::GetErrorCount(const Operation op,
+                                     const ErrorKind kind) const noexcept {
+    return errs_[static_cast<std::size_t>(op)][static_cast<std::size_t>(kind)]
+        .load(std::memory_order_relaxed);
+}
+
+std::string Metrics::ToPrometheus() const noexcept {
+    std::string buf;
+    const auto append_elems {
+        [&buf](const std::array<AtomicElemStats, type_count>& stats,
+               const std::string_view name, const std::string_view help,
+               const bool bytes) noexcept {
+            AppendFamily(buf, name, "counter", help);
+            for (std::size_t code {0}; code != stats.size(); ++code) {
+                const auto loaded {Load(stats[code])};
+                if (loaded.count != 0) {
+                    std::format_to(std::back_inserter(buf),
+                                   "{}{{type=\"{}\"}} {}\n", name,
+                                   secs2::to_string(static_cast<Type>(code)),
+                                   bytes ? loaded.byte_size : loaded.count);
+                }
+            }
+        }};
+
+    append_elems(encoded_, "secs2_encoded_elements_total",
+                 "Items and lists serialized.", false);
+    append_elems(encoded_, "secs2_encoded_bytes_total",
+                 "Bytes of serialized items and lists.", true);
+    append_elems(decoded_, "secs2_decoded_elements_total",
+                 "Items and lists deserialized.", false);
+    append_elems(decoded_, "secs2_decoded_bytes_total",
+                 "Bytes of deserialized items and lists.", true);
+    append_elems(decode_allocs_, "secs2_decode_allocations_total",
+                 "Memory reservations for deserialized values.", false);
+    append_elems(decode_allocs_, "secs2_decode_allocated_bytes_total",
+                 "Bytes reserved for deserialized values.", true);
+
+    AppendFamily(buf, "secs2_max_depth", "gauge",
+                 "The maximum number of lists enclosing an element.");
+    std::format_to(std::back_inserter(buf),
+                   "secs2_max_depth{{dir=\"encode\"}} {}\n"
+                   "secs2_max_depth{{dir=\"decode\"}} {}\n",
+                   GetMaxEncodeDepth(), GetMaxDecodeDepth());
+
+    constexpr std::string_view latency_name {"secs2_operation_duration_seconds"};
+    AppendFamily(buf, latency_name, "histogram", "Latencies of operations.");
+    for (std::size_t i {0}; i != operation_count; ++i) {
+        const auto op {static_cast<Operation>(i)};
+        const auto stats {GetLatency(op)};
+        std::uint64_t accumulated {0};
+        for (std::size_t j {0}; j != latency_bounds.size(); ++j) {
+            accumulated += stats.buckets[j];
+            std::format_to(std::back_inserter(buf),
+                           "{}_bucket{{op=\"{}\",le=\"{}\"}} {}\n",
+                           latency_name, to_string(op),
+                           static_cast<double>(latency_bounds[j]) / 1e9,
+                           accumulated);
+        }
+
+        // The total is summed from the loaded buckets rather than the count,
+        // which is loaded separately and may fall below a finite bucket.
+        const auto total {accumulated + stats.buckets.back()};
+        std::format_to(std::back_inserter(buf),
+                       "{0}_bucket{{op=\"{1}\",le=\"+Inf\"}} {2}\n"
+                       "{0}_sum{{op=\"{1}\"}} {3}\n"
+                       "{0}_count{{op=\"{1}\"}} {2}\n",
+                       latency_name, to_string(op), total,
+                       static_cast<double>(stats.sum) / 1e9);
+    }
+
+    AppendFamily(buf, "secs2_operation_errors_total", "counter",
+                 "Failed operations by error kind.");
+    for (std::size_t i {0}; i != operation_count; ++i) {
+        for (std::size_t j {0}; j != error_kind_count; ++j) {
+            const auto op {static_cast<Operation>(i)};
+            const auto kind {static_cast<ErrorKind>(j)};
+            if (const auto count {GetErrorCount(op, kind)}; count != 0) {
+                std::format_to(std::back_inserter(buf),
+                               "secs2_operation_errors_total{{op=\"{}\","
+                               "kind=\"{}\"}} {}\n",
+                               to_string(op), to_string(kind), count);
+            }
+        }
+    }
+    return buf;
+}
+
+void Metrics::Reset() noexcept {
+    for (auto* const stats : {&encoded_, &decoded_, &decode_allocs_}) {
+        for (auto& elem : *stats) {
+            elem.count.store(0, std::memory_order_relaxed);
+            elem.byte_size.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    max_encode_depth_.store(0, std::memory_order_relaxed);
+    max_decode_depth_.store(0, std::memory_order_relaxed);
+    for (auto& stats : latencies_) {
+        for (auto& bucket : stats.buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+
+        stats.sum.store(0, std::memory_order_relaxed);
+        stats.count.store(0, std::memory_order_relaxed);
+    }
+
+    for (auto& counts : errs_) {
+        for (auto& count : counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+}  // namespace secs2::instrument
+
+#endif
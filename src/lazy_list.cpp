@@ -0,0 +1,124 @@
+#include "lazy_list.h"
+#include "byte/read.h"
+
+#include <cassert>
+#include <format>
+#include <system_error>
+#include <utility>
+
+namespace secs2 {
+
+namespace {
+
+namespace err {
+
+//! Make an error indicating that a message is not a list.
+Error MakeNotListError(const Type type) noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            std::format("The message is {} rather than a list",
+                        to_string(type))};
+}
+
+}  // namespace err
+
+}  // namespace
+
+LazyList::LazyList(const std::span<const std::byte> bytes,
+                   const std::size_t count, const std::size_t header_size,
+                   const DecodeOptions& opts) noexcept :
+    bytes_ {bytes},
+    remaining_count_ {count},
+    count_ {count},
+    byte_size_ {header_size},
+    opts_ {opts} {}
+
+std::expected<LazyList, Error> LazyList::BuildFromBytes(
+    const std::span<const std::byte> bytes, const DecodeOptions& opts) noexcept {
+    const auto header {byte::r::ReadHeader(bytes)};
+    if (!header.has_value()) [[unlikely]] {
+        return std::unexpected {header.error()};
+    } else if (header->type != Type::List) [[unlikely]] {
+        return std::unexpected {err::MakeNotListError(header->type)};
+    } else if (opts.max_depth == 0) [[unlikely]] {
+        return std::unexpected {byte::r::err::MakeExceededDepthError(0)};
+    }
+
+    return LazyList {bytes, header->len, header->size, opts};
+}
+
+std::size_t LazyList::GetSize() const noexcept {
+    return count_;
+}
+
+std::size_t LazyList::GetByteSize() const noexcept {
+    return byte_size_;
+}
+
+std::optional<LazyList::Elem> LazyList::Next() noexcept {
+    if (remaining_count_ == 0) {
+        return std::nullopt;
+    }
+
+    // Each element is loaded as if it were inside the list.
+    byte::r::LoadContext ctx {.opts = opts_, .depth = 1, .elem_count = 1};
+    auto loaded {byte::r::LoadMsgBytes(bytes_.subspan(byte_size_), ctx)};
+    if (!loaded.has_value()) [[unlikely]] {
+        remaining_count_ = 0;
+        return std::unexpected {std::move(loaded).error()};
+    }
+
+    --remaining_count_;
+    byte_size_ += loaded->second;
+    return std::move(loaded->first);
+}
+
+LazyList::Iterator LazyList::begin() noexcept {
+    return Iterator {*this};
+}
+
+std::default_sentinel_t LazyList::end() const noexcept {
+    return std::default_sentinel;
+}
+
+LazyList::Iterator::Iterator(LazyList& list) noexcept :
+    list_ {&list}, curr_ {list.Next()} {}
+
+LazyList::Elem& LazyList::Iterator::operator*() const noexcept {
+    assert(curr_.has_value());
+    return *curr_;
+}
+
+LazyList::Elem* LazyList::Iterator::operator->() const noexcept {
+    return &**this;
+}
+
+LazyList::Iterator& LazyList::Iterator::operator++() noexcept {
+    assert(list_ != nullptr);
+    curr_ = list_->Next();
+    return *this;
+}
+
+void LazyList::Iterator::operator++(int) noexcept {
+    ++*this;
+}
+
+bool LazyList::Iterator::operator==(std::default_sentinel_t) const noexcept {
+    return !curr_.has_value();
+}
+
+#ifdef __cpp_lib_generator
+std::generator<LazyList::Elem> GenerateListElems(
+    const std::span<const std::byte> bytes, const DecodeOptions opts) {
+    auto list {LazyList::BuildFromBytes(bytes, opts)};
+    if (!list.has_value()) [[unlikely]] {
+        co_yield LazyList::Elem {std::unexpect, std::move(list).error()};
+        co_return;
+    }
+
+    for (auto& elem : *list) {
+        co_yield std::move(elem);
+    }
+}
+#endif
+
+}  // namespace secs2
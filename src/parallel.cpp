@@ -0,0 +1,231 @@
+#include "parallel.h"
+#include "byte/length.h"
+#include "byte/read.h"
+#include "byte/write.h"
+
+#include <cassert>
+#include <optional>
+#include <utility>
+
+namespace secs2 {
+
+namespace {
+
+//! The pool whose tasks the current thread is running, or @p nullptr.
+thread_local const ThreadPool* running_pool {nullptr};
+
+}  // namespace
+
+ThreadPool::ThreadPool(const std::size_t thread_count) {
+    workers_.reserve(thread_count);
+    try {
+        for (std::size_t i {0}; i != thread_count; ++i) {
+            workers_.emplace_back([this] { Work(); });
+        }
+    } catch (...) {
+        // The destructor is not run, so started threads are joined here.
+        Stop();
+        throw;
+    }
+}
+
+ThreadPool::~ThreadPool() noexcept {
+    Stop();
+}
+
+void ThreadPool::Stop() noexcept {
+    {
+        const std::scoped_lock lock {mtx_};
+        stopped_ = true;
+    }
+
+    job_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::GetThreadCount() const noexcept {
+    return workers_.size();
+}
+
+void ThreadPool::RunJob(Job& job) noexcept {
+    const auto prev_pool {std::exchange(running_pool, this)};
+    for (auto i {job.next++}; i < job.count; i = job.next++) {
+        (*job.task)(i);
+    }
+
+    running_pool = prev_pool;
+}
+
+void ThreadPool::Work() noexcept {
+    std::size_t generation {0};
+    while (true) {
+        Job* job {nullptr};
+        {
+            std::unique_lock lock {mtx_};
+            job_cv_.wait(lock, [this, generation] {
+                return stopped_ || generation_ != generation;
+            });
+            if (stopped_) {
+                return;
+            }
+
+            generation = generation_;
+            job = job_;
+            if (job == nullptr) {
+                continue;
+            }
+
+            ++active_count_;
+        }
+
+        RunJob(*job);
+        {
+            const std::scoped_lock lock {mtx_};
+            --active_count_;
+        }
+        done_cv_.notify_all();
+    }
+}
+
+void ThreadPool::operator()(
+    const std::size_t count,
+    const std::function<void(std::size_t)>& task) noexcept {
+    if (count == 0) [[unlikely]] {
+        return;
+    } else if (running_pool == this) {
+        // Waiting for the pool from one of its own tasks would never end.
+        for (std::size_t i {0}; i != count; ++i) {
+            task(i);
+        }
+
+        return;
+    }
+
+    const std::scoped_lock run_lock {run_mtx_};
+    Job job {.task = &task, .count = count};
+    {
+        const std::scoped_lock lock {mtx_};
+        job_ = &job;
+        ++generation_;
+    }
+
+    job_cv_.notify_all();
+    RunJob(job);
+
+    // Workers may still be running the last tasks they have taken.
+    std::unique_lock lock {mtx_};
+    job_ = nullptr;
+    done_cv_.wait(lock, [this] { return active_count_ == 0; });
+}
+
+std::optional<std::vector<std::byte>> EncodeParallel(
+    const Message& msg, const Executor& exec) noexcept {
+    const auto* const list {std::get_if<List>(&msg.GetValue())};
+    if (list == nullptr || list->empty()) {
+        return msg.ToBytes();
+    }
+
+    const auto header_size {codec::CalcHeaderSize(list->size())};
+    if (!header_size.has_value()) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    std::vector<std::optional<std::size_t>> elem_sizes(list->size());
+    exec(list->size(), [list, &elem_sizes](const std::size_t i) noexcept {
+        elem_sizes[i] = CalcEncodedSize((*list)[i]);
+    });
+
+    // Each element is written to the region after the elements before it.
+    std::vector<std::size_t> offsets;
+    offsets.reserve(list->size());
+    auto size {*header_size};
+    for (const auto& elem_size : elem_sizes) {
+        if (!elem_size.has_value()) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        offsets.push_back(size);
+        size += *elem_size;
+    }
+
+    std::vector<std::byte> buf(size);
+    [[maybe_unused]] const auto written {
+        byte::w::WriteHeaderBytes(Type::List, list->size(), buf)};
+    assert(written == offsets.front());
+    exec(list->size(), [list, &offsets, &buf](const std::size_t i) noexcept {
+        byte::w::WriteMsgBytes((*list)[i], std::span {buf}.subspan(offsets[i]));
+    });
+
+    return buf;
+}
+
+std::expected<DeserializedMessage, Error> DecodeParallel(
+    const std::span<const std::byte> bytes, const Executor& exec,
+    const DecodeOptions& opts) noexcept {
+    const auto header {byte::r::ReadHeader(bytes)};
+    if (!header.has_value()) [[unlikely]] {
+        return std::unexpected {header.error()};
+    } else if (header->type != Type::List || header->len == 0) {
+        return BuildMsgFromBytes(bytes, opts);
+    } else if (opts.max_depth == 0) [[unlikely]] {
+        return std::unexpected {
+            byte::r::err::MakeExceededDepthError(opts.max_depth)};
+    } else if (header->len >= opts.max_elem_count) [[unlikely]] {
+        // The top-level list and its direct elements are counted.
+        return std::unexpected {
+            byte::r::err::MakeExceededElemCountError(opts.max_elem_count)};
+    }
+
+    // Only headers are read to find where each element begins.
+    std::vector<std::span<const std::byte>> elem_bytes;
+    elem_bytes.reserve(codec::CapListCapacity(header->len,
+                                              bytes.size() - header->size));
+    auto byte_size {header->size};
+    for (std::size_t i {0}; i != header->len; ++i) {
+        const auto remaining {bytes.subspan(byte_size)};
+        const auto elem_size {byte::r::CheckMsgBytes(remaining)};
+        if (!elem_size.has_value()) [[unlikely]] {
+            return std::unexpected {elem_size.error()};
+        }
+
+        elem_bytes.push_back(remaining.first(*elem_size));
+        byte_size += *elem_size;
+    }
+
+    // Elements share the counters of the whole message,
+    // so the limits are enforced while they are loaded concurrently.
+    byte::r::SharedCounters counters {.elem_count = 1};
+    byte::r::LoadContext list_ctx {.opts = opts, .shared = &counters};
+    if (const auto added {byte::r::AddAllocSize(
+            list_ctx, Type::List, header->len * sizeof(ListElem))};
+        !added.has_value()) [[unlikely]] {
+        return std::unexpected {added.error()};
+    }
+
+    // Each task assigns its own element, so they are decoded in place.
+    std::optional<Error> first_err;
+    List list;
+    list.resize(header->len);
+    exec(header->len, [&elem_bytes, &opts, &counters, &first_err,
+                       &list](const std::size_t i) noexcept {
+        byte::r::LoadContext ctx {
+            .opts = opts, .depth = 1, .shared = &counters};
+        auto loaded {byte::r::LoadMsgBytes(elem_bytes[i], ctx)};
+        if (loaded.has_value()) [[likely]] {
+            list[i] = std::move(loaded->first);
+        } else if (!counters.failed.exchange(true)) {
+            // Only the first failure is kept. The others stop loading.
+            first_err = std::move(loaded).error();
+        }
+    });
+
+    if (first_err.has_value()) [[unlikely]] {
+        return std::unexpected {std::move(*first_err)};
+    }
+
+    return DeserializedMessage {Message {std::move(list)}, byte_size};
+}
+
+}  // namespace secs2
@@ -0,0 +1,160 @@
+/**
+ * @file probe.h
+ * @brief Calls to instrumentation hooks, which are empty unless @p SECS2_INSTRUMENTATION is defined.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include "instrument.h"
+#include "secs2.h"
+
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#ifdef SECS2_INSTRUMENTATION
+#include <chrono>
+#endif
+
+namespace secs2::probe {
+
+#ifdef SECS2_INSTRUMENTATION
+
+//! The number of lists enclosing the element being serialized on the current thread.
+inline thread_local std::size_t encode_depth {0};
+
+//! The kind of the last error made on the current thread.
+inline thread_local instrument::ErrorKind error_kind {
+    instrument::ErrorKind::None};
+
+//! Get the error code of the result of an operation.
+template <typename T>
+std::error_code GetErrorCode(const std::optional<T>& result) noexcept {
+    return result.has_value()
+               ? std::error_code {}
+               : std::make_error_code(std::errc::value_too_large);
+}
+
+//! @overload
+template <typename T>
+std::error_code GetErrorCode(const std::expected<T, Error>& result) noexcept {
+    return result.has_value() ? std::error_code {} : result.error().first;
+}
+
+//! @overload
+inline std::error_code GetErrorCode(const std::string&) noexcept {
+    return {};
+}
+
+//! Get the error kind of the failed result of an operation.
+template <typename T>
+instrument::ErrorKind GetErrorKind(const std::optional<T>&) noexcept {
+    return instrument::ErrorKind::ExceededLength;
+}
+
+//! @overload
+template <typename T>
+instrument::ErrorKind GetErrorKind(const T&) noexcept {
+    return error_kind != instrument::ErrorKind::None
+               ? error_kind
+               : instrument::ErrorKind::Other;
+}
+
+#endif
+
+//! Increase the depth of serialized elements while a list is being serialized.
+class EncodeListScope {
+public:
+#ifdef SECS2_INSTRUMENTATION
+    EncodeListScope() noexcept {
+        ++encode_depth;
+    }
+
+    ~EncodeListScope() noexcept {
+        --encode_depth;
+    }
+#else
+    EncodeListScope() noexcept = default;
+#endif
+
+    EncodeListScope(const EncodeListScope&) = delete;
+
+    EncodeListScope& operator=(const EncodeListScope&) = delete;
+};
+
+//! Report a serialized element.
+inline void EncodeElem([[maybe_unused]] const Type type,
+                       [[maybe_unused]] const std::size_t byte_size) noexcept {
+#ifdef SECS2_INSTRUMENTATION
+    if (const auto hooks {instrument::GetHooks()}; hooks != nullptr) {
+        hooks->OnEncodeElem(type, byte_size, encode_depth);
+    }
+#endif
+}
+
+//! Report a deserialized element.
+inline void DecodeElem([[maybe_unused]] const Type type,
+                       [[maybe_unused]] const std::size_t byte_size,
+                       [[maybe_unused]] const std::size_t depth) noexcept {
+#ifdef SECS2_INSTRUMENTATION
+    if (const auto hooks {instrument::GetHooks()}; hooks != nullptr) {
+        hooks->OnDecodeElem(type, byte_size, depth);
+    }
+#endif
+}
+
+//! Report memory reserved for a deserialized element.
+inline void DecodeAlloc([[maybe_unused]] const Type type,
+                        [[maybe_unused]] const std::size_t size) noexcept {
+#ifdef SECS2_INSTRUMENTATION
+    if (size == 0) {
+        return;
+    }
+
+    if (const auto hooks {instrument::GetHooks()}; hooks != nullptr) {
+        hooks->OnDecodeAlloc(type, size);
+    }
+#endif
+}
+
+//! Record the kind of an error being made, which is reported with the operation that fails with it.
+inline void ReportError(
+    [[maybe_unused]] const instrument::ErrorKind kind) noexcept {
+#ifdef SECS2_INSTRUMENTATION
+    error_kind = kind;
+#endif
+}
+
+//! Run an operation and report its latency and error.
+template <typename F>
+auto Time([[maybe_unused]] const instrument::Operation op, F&& run) noexcept {
+#ifdef SECS2_INSTRUMENTATION
+    const auto hooks {instrument::GetHooks()};
+    if (hooks == nullptr) {
+        return std::forward<F>(run)();
+    }
+
+    error_kind = instrument::ErrorKind::None;
+    const auto begin {std::chrono::steady_clock::now()};
+    auto result {std::forward<F>(run)()};
+    const auto latency {std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - begin)};
+    const auto err {GetErrorCode(result)};
+    hooks->OnOperation(
+        op, latency, err,
+        err ? GetErrorKind(result) : instrument::ErrorKind::None);
+    return result;
+#else
+    return std::forward<F>(run)();
+#endif
+}
+
+}  // namespace secs2::probe
@@ -0,0 +1,145 @@
+#include "schema.h"
+#include "byte/length.h"
+#include "byte/read.h"
+#include "byte/swap.h"
+#include "byte/write.h"
+#include "traits.h"
+
+#include <format>
+#include <system_error>
+#include <utility>
+
+namespace secs2::schema::detail {
+
+namespace {
+
+//! Make an error indicating that an element is not of the expected type.
+Error MakeMismatchedTypeError(const Type expected, const Type actual) noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            std::format("The element is {} rather than {}", to_string(actual),
+                        to_string(expected))};
+}
+
+}  // namespace
+
+std::expected<MsgHeader, Error> ReadHeader(
+    const std::span<const std::byte> bytes, const Type type) noexcept {
+    const auto header {byte::r::ReadHeader(bytes)};
+    if (!header.has_value()) [[unlikely]] {
+        return std::unexpected {header.error()};
+    } else if (header->type != type) [[unlikely]] {
+        return std::unexpected {MakeMismatchedTypeError(type, header->type)};
+    }
+
+    if (type != Type::List) {
+        if (bytes.size() - header->size < header->len) [[unlikely]] {
+            return std::unexpected {byte::r::err::MakeIncompleteDataError()};
+        } else if (const auto align {GetElemSize(type)};
+                   header->len % align != 0) [[unlikely]] {
+            return std::unexpected {
+                byte::r::err::MakeUnalignedLengthError(header->len, type, align)};
+        }
+    }
+
+    return *header;
+}
+
+Error MakeMismatchedLengthError(const Type type, const std::size_t expected,
+                                const std::size_t actual) noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            std::format("The {} element has a length of {} rather than {}",
+                        to_string(type), actual, expected)};
+}
+
+Error MakeExceededLengthError() noexcept {
+    return byte::w::err::MakeExceededLengthError();
+}
+
+Error MakeInsufficientBufferError(const std::size_t required,
+                                  const std::size_t provided) noexcept {
+    return byte::w::err::MakeInsufficientBufferError(required, provided);
+}
+
+template <typename T>
+    requires std::is_arithmetic_v<T>
+void StoreBigEndian(const std::span<const T> src,
+                    const std::span<std::byte> dst) noexcept {
+    byte::StoreBigEndian(src, dst);
+}
+
+template <typename T>
+    requires std::is_arithmetic_v<T>
+void LoadBigEndian(const std::span<const std::byte> src,
+                   const std::span<T> dst) noexcept {
+    byte::LoadBigEndian(src, dst);
+}
+
+#define INSTANTIATE_BIG_ENDIAN(type)                                           \
+    template void StoreBigEndian<type>(std::span<const type>,                  \
+                                       std::span<std::byte>) noexcept;         \
+    template void LoadBigEndian<type>(std::span<const std::byte>,              \
+                                      std::span<type>) noexcept;
+
+INSTANTIATE_BIG_ENDIAN(std::int8_t)
+INSTANTIATE_BIG_ENDIAN(std::int16_t)
+INSTANTIATE_BIG_ENDIAN(std::int32_t)
+INSTANTIATE_BIG_ENDIAN(std::int64_t)
+INSTANTIATE_BIG_ENDIAN(std::uint8_t)
+INSTANTIATE_BIG_ENDIAN(std::uint16_t)
+INSTANTIATE_BIG_ENDIAN(std::uint32_t)
+INSTANTIATE_BIG_ENDIAN(std::uint64_t)
+INSTANTIATE_BIG_ENDIAN(float)
+INSTANTIATE_BIG_ENDIAN(double)
+
+std::optional<std::size_t> CalcEncodedSize(const Message::Value& val) noexcept {
+    return secs2::CalcEncodedSize(val);
+}
+
+std::size_t WriteMsgBytes(const Message::Value& val,
+                          const std::span<std::byte> buf) noexcept {
+    return byte::w::WriteMsgBytes(val, buf);
+}
+
+std::expected<void, Error> AddElem(ReadContext& ctx) noexcept {
+    if (ctx.elem_count == ctx.opts.max_elem_count) [[unlikely]] {
+        return std::unexpected {
+            byte::r::err::MakeExceededElemCountError(ctx.opts.max_elem_count)};
+    }
+
+    ++ctx.elem_count;
+    return {};
+}
+
+std::expected<void, Error> AddAllocSize(ReadContext& ctx, const Type type,
+                                        const std::size_t size) noexcept {
+    byte::r::LoadContext load_ctx {.opts = ctx.opts,
+                                   .alloc_size = ctx.alloc_size};
+    const auto added {byte::r::AddAllocSize(load_ctx, type, size)};
+    ctx.alloc_size = load_ctx.alloc_size;
+    return added;
+}
+
+std::expected<void, Error> EnterList(ReadContext& ctx) noexcept {
+    if (ctx.depth == ctx.opts.max_depth) [[unlikely]] {
+        return std::unexpected {
+            byte::r::err::MakeExceededDepthError(ctx.opts.max_depth)};
+    }
+
+    ++ctx.depth;
+    return {};
+}
+
+std::expected<std::pair<Message::Value, std::size_t>, Error> LoadMsgBytes(
+    const std::span<const std::byte> bytes, ReadContext& ctx) noexcept {
+    // A dynamic value is counted within the totals of the whole message.
+    byte::r::LoadContext load_ctx {.opts = ctx.opts,
+                                   .depth = ctx.depth,
+                                   .elem_count = ctx.elem_count,
+                                   .alloc_size = ctx.alloc_size};
+    auto loaded {byte::r::LoadMsgBytes(bytes, load_ctx)};
+    ctx.elem_count = load_ctx.elem_count;
+    ctx.alloc_size = load_ctx.alloc_size;
+    return loaded;
+}
+
+}  // namespace secs2::schema::detail
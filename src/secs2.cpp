@@ -1,11 +1,14 @@
 #include "secs2.h"
+#include "byte/length.h"
 #include "byte/read.h"
 #include "byte/write.h"
+#include "probe.h"
 #include "sml.h"
+#include "sml_parser.h"
 #include "traits.h"
 
-#include <sstream>
-#include <unordered_map>
+#include <cassert>
+#include <string_view>
 
 namespace secs2 {
 
@@ -30,20 +33,87 @@ const Message::Value& Message::GetValue() const noexcept {
     return val_;
 }
 
+const Message::Value* Message::FindElem(
+    const std::span<const std::size_t> path) const noexcept {
+    return secs2::FindElem(val_, path);
+}
+
+const Message::Value* Message::FindElem(
+    const std::initializer_list<std::size_t> path) const noexcept {
+    return secs2::FindElem(val_, path);
+}
+
+std::optional<std::size_t> Message::GetEncodedSize() const noexcept {
+    return CalcEncodedSize(val_);
+}
+
 std::optional<std::vector<std::byte>> Message::ToBytes() const noexcept {
-    std::vector<std::byte> buf;
-    buf.reserve(GetSize());
-    if (byte::w::BuildMsgBytes(val_, buf).has_value()) [[likely]] {
-        return buf;
-    } else {
-        return std::nullopt;
+    return probe::Time(instrument::Operation::ToBytes, [this]() noexcept {
+        return GetEncodedSize().transform([this](const auto size) noexcept {
+            std::vector<std::byte> buf(size);
+            [[maybe_unused]] const auto written {
+                byte::w::WriteMsgBytes(val_, buf)};
+            assert(written == size);
+            return buf;
+        });
+    });
+}
+
+std::expected<std::size_t, Error> Message::SerializeInto(
+    const std::span<std::byte> buf) const noexcept {
+    const auto size {GetEncodedSize()};
+    if (!size.has_value()) [[unlikely]] {
+        return std::unexpected {byte::w::err::MakeExceededLengthError()};
+    } else if (buf.size() < *size) [[unlikely]] {
+        return std::unexpected {
+            byte::w::err::MakeInsufficientBufferError(*size, buf.size())};
     }
+
+    return byte::w::WriteMsgBytes(val_, buf);
+}
+
+std::expected<std::size_t, Error> Message::SerializeInto(
+    const ByteSink& sink) const noexcept {
+    return CheckEncodedSize().transform(
+        [this, &sink]() noexcept { return byte::w::EmitMsgBytes(val_, sink); });
+}
+
+void detail::EmitMsgBytes(const ListElem& val, const ChunkSink sink,
+                          void* const ctx) noexcept {
+    auto consumer {[sink, ctx](const std::span<const std::byte> bytes) noexcept {
+        sink(ctx, bytes);
+    }};
+    byte::w::EmitMsgBytes(val, consumer);
+}
+
+std::expected<void, Error> Message::CheckEncodedSize() const noexcept {
+    if (!GetEncodedSize().has_value()) [[unlikely]] {
+        return std::unexpected {byte::w::err::MakeExceededLengthError()};
+    }
+
+    return {};
 }
 
 std::string Message::ToSml(const std::size_t indent_width) const noexcept {
-    std::ostringstream os;
-    sml::BuildSml(os, val_, 0, indent_width);
-    return os.str();
+    return ToSml({.indent_width = indent_width});
+}
+
+std::string Message::ToSml(const SmlOptions& opts) const noexcept {
+    return probe::Time(instrument::Operation::ToSml, [this, &opts]() noexcept {
+        std::string sml;
+        AppendSml(sml, opts);
+        return sml;
+    });
+}
+
+void Message::AppendSml(std::string& buf,
+                        const std::size_t indent_width) const noexcept {
+    AppendSml(buf, {.indent_width = indent_width});
+}
+
+void Message::AppendSml(std::string& buf,
+                        const SmlOptions& opts) const noexcept {
+    sml::BuildSml(buf, val_, opts);
 }
 
 std::expected<DeserializedMessage, Error> Message::BuildFromBytes(
@@ -53,8 +123,85 @@ std::expected<DeserializedMessage, Error> Message::BuildFromBytes(
 
 std::expected<DeserializedMessage, Error> BuildMsgFromBytes(
     const std::span<const std::byte> bytes) noexcept {
-    return byte::r::LoadMsgBytes(bytes).transform([](const auto& val) noexcept {
-        return std::pair {Message {val.first}, val.second};
+    return BuildMsgFromBytes(bytes, DecodeOptions {});
+}
+
+std::expected<DeserializedMessage, Error> Message::BuildFromBytes(
+    const std::span<const std::byte> bytes, const DecodeOptions& opts) noexcept {
+    return BuildMsgFromBytes(bytes, opts);
+}
+
+std::expected<DeserializedMessage, Error> BuildMsgFromBytes(
+    const std::span<const std::byte> bytes, const DecodeOptions& opts) noexcept {
+    return probe::Time(
+        instrument::Operation::BuildFromBytes, [bytes, &opts]() noexcept {
+            byte::r::LoadContext ctx {.opts = opts};
+            return byte::r::LoadMsgBytes(bytes, ctx)
+                .transform([](byte::r::Loaded&& val) noexcept {
+                    return DeserializedMessage {Message {std::move(val.first)},
+                                                val.second};
+                });
+        });
+}
+
+#ifdef SECS2_USE_PMR
+std::expected<DeserializedMessage, Error> Message::BuildFromBytes(
+    const std::span<const std::byte> bytes,
+    std::pmr::memory_resource* const resource,
+    const DecodeOptions& opts) noexcept {
+    return BuildMsgFromBytes(bytes, resource, opts);
+}
+
+std::expected<DeserializedMessage, Error> BuildMsgFromBytes(
+    const std::span<const std::byte> bytes,
+    std::pmr::memory_resource* const resource,
+    const DecodeOptions& opts) noexcept {
+    assert(resource != nullptr);
+    return probe::Time(
+        instrument::Operation::BuildFromBytes,
+        [bytes, resource, &opts]() noexcept {
+            byte::r::LoadContext ctx {.resource = resource, .opts = opts};
+            return byte::r::LoadMsgBytes(bytes, ctx)
+                .transform([](byte::r::Loaded&& val) noexcept {
+                    return DeserializedMessage {Message {std::move(val.first)},
+                                                val.second};
+                });
+        });
+}
+#endif
+
+std::expected<std::size_t, Error> Message::Validate(
+    const std::span<const std::byte> bytes) noexcept {
+    return ValidateMsgBytes(bytes);
+}
+
+std::expected<std::size_t, Error> ValidateMsgBytes(
+    const std::span<const std::byte> bytes) noexcept {
+    return byte::r::CheckMsgBytes(bytes);
+}
+
+std::expected<std::string, Error> BuildSmlFromBytes(
+    const std::span<const std::byte> bytes,
+    const std::size_t indent_width) noexcept {
+    return BuildSmlFromBytes(bytes, {.indent_width = indent_width});
+}
+
+std::expected<std::string, Error> BuildSmlFromBytes(
+    const std::span<const std::byte> bytes, const SmlOptions& opts) noexcept {
+    std::string sml;
+    return sml::BuildSmlFromBytes(sml, bytes, opts)
+        .transform([&sml](std::size_t) noexcept { return std::move(sml); });
+}
+
+std::expected<Message, Error> Message::BuildFromSml(
+    const std::string_view sml) noexcept {
+    return BuildMsgFromSml(sml);
+}
+
+std::expected<Message, Error> BuildMsgFromSml(
+    const std::string_view sml) noexcept {
+    return sml::ParseSml(sml).transform([](Message::Value&& val) noexcept {
+        return Message {std::move(val)};
     });
 }
 
@@ -73,39 +220,50 @@ std::string to_string(const Message& msg) noexcept {
 }
 
 std::string to_string(const Type type) noexcept {
-    static const std::unordered_map<Type, std::string_view> types {
-        {Type::List, "List"},       {Type::Binary, "Binary"},
-        {Type::Boolean, "Boolean"}, {Type::ASCII, "ASCII"},
-        {Type::F4, "F4"},           {Type::F8, "F8"},
-        {Type::I1, "I1"},           {Type::I2, "I2"},
-        {Type::I4, "I4"},           {Type::I8, "I8"},
-        {Type::U1, "U1"},           {Type::U2, "U2"},
-        {Type::U4, "U4"},           {Type::U8, "U8"},
-        {Type::Unknown, "Unknown"}};
-    assert(types.contains(type));
-    [[assume(types.contains(type))]];
-    return types.contains(type) ? types.at(type).data()
-                                : types.at(Type::Unknown).data();
+    static constexpr auto names {BuildFormatCodeTable<std::string_view>(
+        []<typename T>(std::type_identity<T>) noexcept {
+            return format_name<T>;
+        })};
+
+    // A type is a byte, so it can be out of the range of format codes.
+    const auto code {static_cast<std::size_t>(type)};
+    if (code >= names.size() || names[code].empty()) [[unlikely]] {
+        return "Unknown";
+    }
+
+    return std::string {names[code]};
 }
 
 void Message::swap(Message& msg) noexcept {
     std::ranges::swap(val_, msg.val_);
 }
 
+const ListElem* FindElem(const ListElem& elem,
+                         const std::span<const std::size_t> path) noexcept {
+    auto found {&elem};
+    for (const auto idx : path) {
+        const auto list {GetItemPtr<List>(*found)};
+        if (list == nullptr || idx >= list->size()) {
+            return nullptr;
+        }
+
+        found = &(*list)[idx];
+    }
+    return found;
+}
+
 void swap(Message& lhs, Message& rhs) noexcept {
     lhs.swap(rhs);
 }
 
 }  // namespace secs2
 
-auto std::formatter<secs2::Message>::format(
+std::format_context::iterator std::formatter<secs2::Message>::format(
     const secs2::Message& msg, std::format_context& ctx) const noexcept {
-    return std::formatter<std::string>::format(
-        indent_width_.has_value() ? msg.ToSml(*indent_width_) : msg.ToSml(),
-        ctx);
+    return std::formatter<std::string>::format(msg.ToSml(opts_), ctx);
 }
 
-auto std::formatter<secs2::Type>::format(
+std::format_context::iterator std::formatter<secs2::Type>::format(
     const secs2::Type type, std::format_context& ctx) const noexcept {
     return std::formatter<std::string>::format(secs2::to_string(type), ctx);
 }
\ No newline at end of file
@@ -1,86 +1,300 @@
 #include "sml.h"
+#include "byte/read.h"
 #include "traits.h"
 
-#include <algorithm>
-#include <format>
+#include <bit>
+#include <cassert>
 #include <ranges>
 #include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace secs2::sml {
 
-std::ostream& BuildSml(std::ostream& os, const ASCII& vals,
-                       const std::size_t indent_lvl,
-                       const std::size_t indent_width) noexcept {
-    const auto spaces {BuildIndent(indent_lvl, indent_width)};
-    const auto tag {format_tag<ASCII>};
-    if (!vals.empty()) [[likely]] {
-        os << std::format("{}<{} [{}] \"{}\">", spaces, tag, vals.size(), vals);
+namespace {
+
+//! Read a single element of an item from its value bytes.
+template <typename T>
+std::ranges::range_value_t<T> ReadElem(const std::span<const std::byte> bytes,
+                                       const std::size_t idx) noexcept {
+    using Value = std::ranges::range_value_t<T>;
+    if constexpr (std::same_as<T, Boolean>) {
+        return bytes[idx] != std::byte {0};
+    } else if constexpr (sizeof(Value) <= sizeof(std::byte)) {
+        return static_cast<Value>(bytes[idx]);
+    } else {
+        return codec::LoadScalar<Value>(bytes.subspan(idx * sizeof(Value)));
+    }
+}
+
+/**
+ * @brief Format an item from its value bytes.
+ *
+ * @details
+ * Elements are read lazily, so elided elements are never decoded.
+ *
+ * @param writer A writer.
+ * @param bytes The value bytes of the item, excluding its header.
+ * @param indent_lvl The indentation level.
+ */
+template <typename T>
+void WriteItemFromBytes(Writer& writer, const std::span<const std::byte> bytes,
+                        const std::size_t indent_lvl) noexcept {
+    if constexpr (std::same_as<T, ASCII>) {
+        writer.WriteAscii(
+            std::string_view {reinterpret_cast<const char*>(bytes.data()),
+                              bytes.size()},
+            indent_lvl);
+    } else {
+        using Value = std::ranges::range_value_t<T>;
+        const auto count {bytes.size() / sizeof(Value)};
+        writer.WriteItem<T>(
+            std::views::iota(static_cast<std::size_t>(0), count)
+                | std::views::transform([bytes](const auto i) noexcept {
+                      return ReadElem<T>(bytes, i);
+                  }),
+            indent_lvl);
+    }
+}
+
+//! A list whose elements have not all been formatted yet.
+struct Frame {
+    //! The number of elements.
+    std::size_t size {0};
+    //! The index of the next element.
+    std::size_t idx {0};
+};
+
+}  // namespace
+
+Writer::Writer(std::string& buf, const SmlOptions& opts) noexcept :
+    buf_ {buf}, opts_ {opts}, init_buf_size_ {buf.size()} {}
+
+std::size_t Writer::GetRemainingSize() const noexcept {
+    const auto size {buf_.size() - init_buf_size_};
+    return size < opts_.max_size ? opts_.max_size - size : 0;
+}
+
+bool Writer::IsElemElided(const std::size_t idx) const noexcept {
+    return idx >= opts_.max_elem_count || GetRemainingSize() == 0;
+}
+
+bool Writer::IsListElided(const std::size_t indent_lvl) const noexcept {
+    return indent_lvl >= opts_.max_depth;
+}
+
+void Writer::WriteNewLine() noexcept {
+    buf_ += '\n';
+}
+
+void Writer::WriteIndent(const std::size_t lvl) noexcept {
+    buf_.append(lvl * opts_.indent_width, ' ');
+}
+
+void Writer::WriteElision(const std::size_t count) noexcept {
+    buf_ += " ... (";
+    AppendNumber(buf_, count);
+    buf_ += " more)";
+}
+
+void Writer::WriteElidedLine(const std::size_t count,
+                             const std::size_t indent_lvl) noexcept {
+    WriteIndent(indent_lvl);
+    buf_ += "... (";
+    AppendNumber(buf_, count);
+    buf_ += " more)\n";
+}
+
+void Writer::WriteAscii(const std::string_view vals,
+                        const std::size_t indent_lvl) noexcept {
+    WriteIndent(indent_lvl);
+    buf_ += '<';
+    buf_ += format_tag<ASCII>;
+    buf_ += " [";
+    AppendNumber(buf_, vals.size());
+    buf_ += ']';
+    const auto count {
+        std::min({vals.size(), opts_.max_elem_count, GetRemainingSize()})};
+    if (count != 0) [[likely]] {
+        buf_ += " \"";
+        buf_ += vals.substr(0, count);
+        buf_ += '"';
+    }
+
+    if (count != vals.size()) [[unlikely]] {
+        WriteElision(vals.size() - count);
+    }
+    buf_ += '>';
+}
+
+bool Writer::WriteListBegin(const std::size_t size,
+                            const std::size_t indent_lvl) noexcept {
+    WriteIndent(indent_lvl);
+    buf_ += "<L [";
+    AppendNumber(buf_, size);
+    buf_ += ']';
+    if (size == 0) {
+        WriteNewLine();
+        WriteListEnd(indent_lvl);
+        return false;
+    } else if (IsListElided(indent_lvl)) [[unlikely]] {
+        WriteElision(size);
+        buf_ += '>';
+        return false;
     } else {
-        os << std::format("{}<{} [{}]>", spaces, tag, 0);
+        WriteNewLine();
+        return true;
     }
-    return os;
-}
-
-std::ostream& BuildSml(std::ostream& os, const Binary& vals,
-                       const std::size_t indent_lvl,
-                       const std::size_t indent_width) noexcept {
-    return BuildSml<std::string>(
-        os, vals,
-        [](const auto val) noexcept {
-            return std::format("0x{:02X}", static_cast<std::uint8_t>(val));
-        },
-        indent_lvl, indent_width);
-}
-
-std::ostream& BuildSml(std::ostream& os, const Boolean& vals,
-                       const std::size_t indent_lvl,
-                       const std::size_t indent_width) noexcept {
-    return BuildSml<std::string_view>(
-        os, vals,
-        [](const auto val) noexcept -> std::string_view {
-            return val ? "true" : "false";
-        },
-        indent_lvl, indent_width);
-}
-
-std::ostream& BuildSml(std::ostream& os, const Message::Value& val,
-                       const std::size_t indent_lvl,
-                       const std::size_t indent_width) noexcept {
-    std::visit(
-        [&os, indent_lvl, indent_width](const auto& raw) noexcept {
-            BuildSml(os, raw, indent_lvl, indent_width);
-        },
-        val);
-    return os;
-}
-
-std::ostream& BuildSml(std::ostream& os, const Item& item,
-                       const std::size_t indent_lvl,
-                       const std::size_t indent_width) noexcept {
-    std::visit(
-        [&os, indent_lvl, indent_width](const auto& raw) noexcept {
-            BuildSml(os, raw, indent_lvl, indent_width);
-        },
-        item);
-    return os;
-}
-
-std::ostream& BuildSml(std::ostream& os, const List& list,
-                       const std::size_t indent_lvl,
-                       const std::size_t indent_width) noexcept {
-    const auto spaces {BuildIndent(indent_lvl, indent_width)};
-    os << std::format("{}<L [{}]\n", spaces, list.size());
-    std::ranges::for_each(
-        list, [&os, indent_lvl, indent_width](const auto& val) noexcept {
-            std::visit(
-                [&os, indent_lvl, indent_width](const auto& raw) noexcept {
-                    BuildSml(os, raw, indent_lvl + 1, indent_width);
-                    os << '\n';
-                },
-                val);
-        });
-    os << std::format("{}>", spaces);
-    return os;
-}
-
-}  // namespace secs2::sml
\ No newline at end of file
+}
+
+void Writer::WriteListEnd(const std::size_t indent_lvl) noexcept {
+    WriteIndent(indent_lvl);
+    buf_ += '>';
+}
+
+void Writer::Write(const ASCII& vals, const std::size_t indent_lvl) noexcept {
+    WriteAscii(vals, indent_lvl);
+}
+
+void Writer::Write(const Message::Value& val,
+                   const std::size_t indent_lvl) noexcept {
+    std::visit([this, indent_lvl](
+                   const auto& raw) noexcept { Write(raw, indent_lvl); },
+               val);
+}
+
+void Writer::Write(const Item& item, const std::size_t indent_lvl) noexcept {
+    std::visit([this, indent_lvl](
+                   const auto& raw) noexcept { Write(raw, indent_lvl); },
+               item);
+}
+
+void Writer::Write(const List& list, const std::size_t indent_lvl) noexcept {
+    if (!WriteListBegin(list.size(), indent_lvl)) {
+        return;
+    }
+
+    for (std::size_t i {0}; i != list.size(); ++i) {
+        if (IsElemElided(i)) [[unlikely]] {
+            WriteElidedLine(list.size() - i, indent_lvl + 1);
+            break;
+        }
+
+        Write(list[i], indent_lvl + 1);
+        WriteNewLine();
+    }
+    WriteListEnd(indent_lvl);
+}
+
+void BuildSml(std::string& buf, const Message::Value& val,
+              const SmlOptions& opts) noexcept {
+    Writer {buf, opts}.Write(val, 0);
+}
+
+std::expected<std::size_t, Error> BuildSmlFromBytes(
+    std::string& buf, const std::span<const std::byte> bytes,
+    const SmlOptions& opts) noexcept {
+    using ItemWriter = void (*)(Writer&, std::span<const std::byte>,
+                                std::size_t) noexcept;
+    static constexpr auto item_writers {BuildFormatCodeTable<ItemWriter>(
+        []<typename T>(std::type_identity<T>) noexcept -> ItemWriter {
+            if constexpr (std::same_as<T, List>) {
+                return nullptr;
+            } else {
+                return WriteItemFromBytes<T>;
+            }
+        })};
+
+    const auto init_buf_size {buf.size()};
+    const auto fail {[&buf, init_buf_size](Error err) noexcept {
+        buf.resize(init_buf_size);
+        return std::unexpected {std::move(err)};
+    }};
+
+    Writer writer {buf, opts};
+    std::vector<Frame> frames;
+    std::size_t byte_size {0};
+    // Elided elements are skipped over, but they are still validated.
+    const auto skip {[&bytes, &byte_size]() noexcept {
+        return byte::r::CheckMsgBytes(bytes.subspan(byte_size))
+            .transform([&byte_size](const auto size) noexcept {
+                byte_size += size;
+            });
+    }};
+
+    do {
+        const auto elem_begin {byte_size};
+        const auto header {byte::r::ReadHeader(bytes.subspan(byte_size))};
+        if (!header.has_value()) [[unlikely]] {
+            return fail(header.error());
+        }
+
+        byte_size += header->size;
+        const auto indent_lvl {frames.size()};
+        bool opened {false};
+        if (header->type == Type::List) {
+            if (writer.WriteListBegin(header->len, indent_lvl)) {
+                frames.push_back({.size = header->len, .idx = 0});
+                opened = true;
+            } else if (header->len != 0) {
+                byte_size = elem_begin;
+                if (const auto skipped {skip()}; !skipped.has_value())
+                    [[unlikely]] {
+                    return fail(skipped.error());
+                }
+            }
+        } else {
+            if (bytes.size() - byte_size < header->len) [[unlikely]] {
+                return fail(byte::r::err::MakeIncompleteDataError());
+            } else if (const auto align {GetElemSize(header->type)};
+                       header->len % align != 0) [[unlikely]] {
+                return fail(byte::r::err::MakeUnalignedLengthError(
+                    header->len, header->type, align));
+            }
+
+            const auto item_writer {
+                item_writers[static_cast<std::size_t>(header->type)]};
+            assert(item_writer != nullptr);
+            item_writer(writer, bytes.subspan(byte_size, header->len),
+                        indent_lvl);
+            byte_size += header->len;
+        }
+
+        if (!opened && !frames.empty()) {
+            writer.WriteNewLine();
+            ++frames.back().idx;
+        }
+
+        // An element is complete or a list is opened,
+        // which may elide the remaining elements and complete parent lists.
+        while (!frames.empty()) {
+            auto& frame {frames.back()};
+            if (frame.idx != frame.size && writer.IsElemElided(frame.idx))
+                [[unlikely]] {
+                writer.WriteElidedLine(frame.size - frame.idx, frames.size());
+                for (; frame.idx != frame.size; ++frame.idx) {
+                    if (const auto skipped {skip()}; !skipped.has_value())
+                        [[unlikely]] {
+                        return fail(skipped.error());
+                    }
+                }
+            }
+
+            if (frame.idx != frame.size) {
+                break;
+            }
+
+            frames.pop_back();
+            writer.WriteListEnd(frames.size());
+            if (!frames.empty()) {
+                writer.WriteNewLine();
+                ++frames.back().idx;
+            }
+        }
+    } while (!frames.empty());
+
+    return byte_size;
+}
+
+}  // namespace secs2::sml
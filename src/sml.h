@@ -12,50 +12,55 @@
 
 #include "secs2.h"
 
-#include <format>
-#include <functional>
-#include <iostream>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
 #include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
+#include <system_error>
+#include <type_traits>
 
 namespace secs2::sml {
 
-//! @overload
-std::ostream& BuildSml(std::ostream& os, const Item& item,
-                       std::size_t indent_lvl,
-                       std::size_t indent_width) noexcept;
-
-//! @overload
-std::ostream& BuildSml(std::ostream& os, const List& list,
-                       std::size_t indent_lvl,
-                       std::size_t indent_width) noexcept;
-
-//! @overload
-std::ostream& BuildSml(std::ostream& os, const ASCII& vals,
-                       std::size_t indent_lvl,
-                       std::size_t indent_width) noexcept;
-
-//! @overload
-std::ostream& BuildSml(std::ostream& os, const Binary& vals,
-                       std::size_t indent_lvl,
-                       std::size_t indent_width) noexcept;
-//! @overload
-std::ostream& BuildSml(std::ostream& os, const Boolean& vals,
-                       std::size_t indent_lvl,
-                       std::size_t indent_width) noexcept;
-
 /**
- * @brief Format a message to a SML (SECS Message Language) string and output it to a stream.
+ * @brief Format a message to a SML (SECS Message Language) string and append it to a buffer.
  *
- * @param os An output stream.
+ * @details
+ * Characters are written directly to the buffer, so no temporary string is created
+ * and a reused buffer only allocates memory when it has to grow.
+ *
+ * @param buf A buffer.
  * @param val A message.
- * @param indent_lvl The indentation level.
- * @param indent_width The number of spaces per indentation level.
+ * @param opts Formatting options.
  */
-std::ostream& BuildSml(std::ostream& os, const Message::Value& val,
-                       std::size_t indent_lvl,
-                       std::size_t indent_width) noexcept;
+void BuildSml(std::string& buf, const Message::Value& val,
+              const SmlOptions& opts) noexcept;
+
+/**
+ * @brief Format the bytes of a message to a SML (SECS Message Language) string and append it to a buffer.
+ *
+ * @details
+ * Headers and values are read and formatted in a single pass without deserializing the message,
+ * and the result is the same as formatting the deserialized message.
+ * Elided elements are skipped over without being formatted.
+ *
+ * @param buf A buffer, which is left unchanged if the bytes are invalid.
+ * @param bytes A buffer starting from a message.
+ * @param opts Formatting options.
+ * @return
+ * The number of bytes consumed by the message if successful,
+ * otherwise the same errors as @ref Message::BuildFromBytes.
+ */
+std::expected<std::size_t, Error> BuildSmlFromBytes(
+    std::string& buf, std::span<const std::byte> bytes,
+    const SmlOptions& opts) noexcept;
 
 //! Map types to string tags.
 template <typename T>
@@ -81,60 +86,156 @@ MAP_FORMAT_TYPE_TO_TAG(F4, "F4")
 MAP_FORMAT_TYPE_TO_TAG(F8, "F8")
 
 /**
- * @brief Build an indentation string.
+ * @brief Append the shortest decimal representation of a number to a buffer.
  *
- * @param lvl The indentation level.
- * @param width The number of spaces per indentation level.
+ * @details
+ * It produces the same characters as formatting the number with @p std::format("{}").
  */
-constexpr std::string BuildIndent(const std::size_t lvl,
-                                  const std::size_t width) noexcept {
-    return std::string(lvl * width, ' ');
+template <typename T>
+    requires std::is_arithmetic_v<T> && (!std::same_as<T, bool>)
+void AppendNumber(std::string& buf, const T val) noexcept {
+    // It is large enough for any integer and the shortest round-trip floating point.
+    std::array<char, 32> chars;
+    const auto [end, ec] {
+        std::to_chars(chars.data(), chars.data() + chars.size(), val)};
+    assert(ec == std::errc {});
+    buf.append(chars.data(), end);
+}
+
+//! @overload
+inline void AppendElem(std::string& buf, const std::byte val) noexcept {
+    constexpr std::string_view digits {"0123456789ABCDEF"};
+    const auto num {static_cast<std::uint8_t>(val)};
+    const std::array<char, 4> chars {'0', 'x', digits[num >> 4],
+                                     digits[num & 0xF]};
+    buf.append(chars.data(), chars.size());
+}
+
+//! @overload
+inline void AppendElem(std::string& buf, const bool val) noexcept {
+    buf += val ? "true" : "false";
+}
+
+//! Append a single element of an item to a buffer.
+template <typename T>
+    requires std::is_arithmetic_v<T> && (!std::same_as<T, bool>)
+void AppendElem(std::string& buf, const T val) noexcept {
+    AppendNumber(buf, val);
 }
 
 /**
- * @brief
- * Format an item to a SML (SECS Message Language) string using a custom formatter
- * and output it to a stream.
- *
- * @tparam To The return type of the formatter function (e.g., @p std::string).
- * @tparam From The type of the item.
+ * @brief A writer appending SML (SECS Message Language) strings to a buffer within the limits of options.
  *
- * @param os An output stream.
- * @param vals An item
- * @param formatter A formatter that transforms each element into a formatted representation.
- * @param indent_lvl The indentation level.
- * @param indent_width The number of spaces per indentation level.
+ * @details
+ * Limits are checked before each element is formatted,
+ * so elided elements are never formatted and are printed as @p "... (N more)".
  */
-template <typename To, typename From>
-    requires(!std::same_as<From, ASCII> && !std::same_as<From, List>)
-std::ostream& BuildSml(
-    std::ostream& os, const From& vals,
-    std::function<To(std::ranges::range_value_t<From>)> formatter,
-    const std::size_t indent_lvl, const std::size_t indent_width) noexcept {
-    const auto spaces {BuildIndent(indent_lvl, indent_width)};
-    const auto tag {format_tag<From>};
-    if (!vals.empty()) [[likely]] {
-        const auto val_strs {vals | std::views::transform(formatter)};
-        const auto str {std::ranges::to<std::string>(
-            val_strs | std::views::join_with(' '))};
-        os << std::format("{}<{} [{}] {}>", spaces, tag, vals.size(), str);
-    } else {
-        os << std::format("{}<{} [{}]>", spaces, tag, 0);
+class Writer {
+public:
+    /**
+     * @param buf A buffer, whose existing characters are not counted towards the size limit.
+     * @param opts Formatting options, which must outlive the writer.
+     */
+    Writer(std::string& buf, const SmlOptions& opts) noexcept;
+
+    //! @overload
+    void Write(const Item& item, std::size_t indent_lvl) noexcept;
+
+    //! @overload
+    void Write(const List& list, std::size_t indent_lvl) noexcept;
+
+    //! @overload
+    void Write(const ASCII& vals, std::size_t indent_lvl) noexcept;
+
+    //! Format a message at an indentation level.
+    void Write(const Message::Value& val, std::size_t indent_lvl) noexcept;
+
+    //! @overload
+    template <std::ranges::sized_range T>
+        requires(!std::same_as<T, ASCII> && !std::same_as<T, List>)
+    void Write(const T& vals, const std::size_t indent_lvl) noexcept {
+        WriteItem<T>(vals, indent_lvl);
     }
 
-    return os;
-}
+    /**
+     * @brief Format the elements of an item.
+     *
+     * @tparam T The type of the item, which determines the tag.
+     * @param vals A sized range of elements, such as the item itself.
+     * Elements are only read until a limit is reached.
+     * @param indent_lvl The indentation level.
+     */
+    template <typename T, std::ranges::sized_range R>
+        requires(!std::same_as<T, ASCII> && !std::same_as<T, List>)
+    void WriteItem(R&& vals, const std::size_t indent_lvl) noexcept {
+        const auto size {static_cast<std::size_t>(std::ranges::size(vals))};
+        WriteIndent(indent_lvl);
+        buf_ += '<';
+        buf_ += format_tag<T>;
+        buf_ += " [";
+        AppendNumber(buf_, size);
+        buf_ += ']';
+        std::size_t count {0};
+        for (const auto val : vals) {
+            if (IsElemElided(count)) {
+                WriteElision(size - count);
+                break;
+            }
+
+            buf_ += ' ';
+            AppendElem(buf_, val);
+            ++count;
+        }
+        buf_ += '>';
+    }
 
-//! @overload
-template <typename T>
-    requires std::is_arithmetic_v<std::ranges::range_value_t<T>>
-std::ostream& BuildSml(std::ostream& os, const T& vals,
-                       const std::size_t indent_lvl,
-                       const std::size_t indent_width) noexcept {
-    return BuildSml<std::string>(
-        os, vals,
-        [](const auto val) noexcept { return std::format("{}", val); },
-        indent_lvl, indent_width);
-}
+    //! Format the characters of an ASCII item.
+    void WriteAscii(std::string_view vals, std::size_t indent_lvl) noexcept;
+
+    /**
+     * @brief Format the header of a list.
+     *
+     * @return
+     * Whether elements should be written on the following lines,
+     * or @p false if the list is empty or too deep and has been closed.
+     */
+    bool WriteListBegin(std::size_t size, std::size_t indent_lvl) noexcept;
+
+    //! Format the closing angle bracket of a list that has elements.
+    void WriteListEnd(std::size_t indent_lvl) noexcept;
+
+    /**
+     * @brief Format a line for the elided elements of a list.
+     *
+     * @param count The number of elided elements.
+     * @param indent_lvl The indentation level of the elements.
+     */
+    void WriteElidedLine(std::size_t count, std::size_t indent_lvl) noexcept;
+
+    /**
+     * @brief Check whether an element of an item or list should be elided.
+     *
+     * @param idx The index of the element.
+     */
+    bool IsElemElided(std::size_t idx) const noexcept;
+
+    //! Check whether the elements of a list at an indentation level should be elided.
+    bool IsListElided(std::size_t indent_lvl) const noexcept;
+
+    void WriteNewLine() noexcept;
+
+private:
+    //! Get the number of characters that can still be written.
+    std::size_t GetRemainingSize() const noexcept;
+
+    void WriteIndent(std::size_t lvl) noexcept;
+
+    //! Format the number of elided elements.
+    void WriteElision(std::size_t count) noexcept;
+
+    std::string& buf_;
+    const SmlOptions& opts_;
+    std::size_t init_buf_size_;
+};
 
-}  // namespace secs2::sml
\ No newline at end of file
+}  // namespace secs2::sml
@@ -0,0 +1,351 @@
+#include "sml_parser.h"
+#include "sml.h"
+#include "traits.h"
+
+#include <cassert>
+#include <charconv>
+#include <format>
+#include <optional>
+#include <ranges>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace secs2::sml {
+
+namespace err {
+
+Error MakeInvalidSmlError(const std::size_t pos,
+                          const std::string_view reason) noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            std::format("Invalid SML at offset {}: {}", pos, reason)};
+}
+
+}  // namespace err
+
+namespace {
+
+constexpr bool IsSpace(const char c) noexcept {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+//! Whether a character ends a tag or a value.
+constexpr bool IsDelimiter(const char c) noexcept {
+    return IsSpace(c) || c == '<' || c == '>' || c == '[' || c == ']'
+           || c == '"';
+}
+
+//! A forward-only cursor over a SML string.
+class Cursor {
+public:
+    explicit Cursor(const std::string_view sml) noexcept : sml_ {sml} {}
+
+    std::size_t GetPos() const noexcept {
+        return pos_;
+    }
+
+    bool IsEnd() const noexcept {
+        return pos_ == sml_.size();
+    }
+
+    //! Get the current character, or a null character at the end.
+    char Peek() const noexcept {
+        return IsEnd() ? '\0' : sml_[pos_];
+    }
+
+    void SkipSpaces() noexcept {
+        while (!IsEnd() && IsSpace(sml_[pos_])) {
+            ++pos_;
+        }
+    }
+
+    //! Skip spaces and consume a character if it is the expected one.
+    bool Consume(const char c) noexcept {
+        SkipSpaces();
+        if (Peek() == c) {
+            ++pos_;
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    //! Skip spaces and read characters until a delimiter.
+    std::string_view ReadWord() noexcept {
+        SkipSpaces();
+        const auto begin {pos_};
+        while (!IsEnd() && !IsDelimiter(sml_[pos_])) {
+            ++pos_;
+        }
+        return sml_.substr(begin, pos_ - begin);
+    }
+
+    /**
+     * @brief Read characters until a closing double quote, which is consumed.
+     *
+     * @return The characters, or @p std::nullopt if there is no closing double quote.
+     */
+    std::optional<std::string_view> ReadQuoted() noexcept {
+        const auto end {sml_.find('"', pos_)};
+        if (end == std::string_view::npos) [[unlikely]] {
+            return std::nullopt;
+        }
+
+        const auto str {sml_.substr(pos_, end - pos_)};
+        pos_ = end + 1;
+        return str;
+    }
+
+    std::unexpected<Error> Fail(const std::string_view reason) const noexcept {
+        return std::unexpected {err::MakeInvalidSmlError(pos_, reason)};
+    }
+
+    std::unexpected<Error> Fail(const std::size_t pos,
+                                const std::string_view reason) const noexcept {
+        return std::unexpected {err::MakeInvalidSmlError(pos, reason)};
+    }
+
+private:
+    std::string_view sml_;
+    std::size_t pos_ {0};
+};
+
+/**
+ * @brief Parse a number.
+ *
+ * @details
+ * Integers can be decimal or hexadecimal with a @p 0x prefix.
+ */
+template <typename T>
+    requires std::is_arithmetic_v<T>
+std::optional<T> ParseNumber(std::string_view word) noexcept {
+    T val {};
+    std::from_chars_result res {};
+    if constexpr (std::is_integral_v<T>) {
+        auto base {10};
+        if (word.starts_with("0x") || word.starts_with("0X")) {
+            word.remove_prefix(2);
+            base = 16;
+        }
+        res = std::from_chars(word.data(), word.data() + word.size(), val,
+                              base);
+    } else {
+        res = std::from_chars(word.data(), word.data() + word.size(), val);
+    }
+
+    if (word.empty() || res.ec != std::errc {}
+        || res.ptr != word.data() + word.size()) [[unlikely]] {
+        return std::nullopt;
+    }
+    return val;
+}
+
+//! Parse a single element of an item.
+template <typename T>
+std::optional<std::ranges::range_value_t<T>> ParseElem(
+    const std::string_view word) noexcept {
+    using Value = std::ranges::range_value_t<T>;
+    if constexpr (std::same_as<T, Binary>) {
+        return ParseNumber<std::uint8_t>(word).transform(
+            [](const auto num) noexcept { return static_cast<Value>(num); });
+    } else if constexpr (std::same_as<T, Boolean>) {
+        if (word == "true") {
+            return Value {true};
+        } else if (word == "false") {
+            return Value {false};
+        } else {
+            return std::nullopt;
+        }
+    } else {
+        return ParseNumber<Value>(word);
+    }
+}
+
+/**
+ * @brief Parse the elements of an item until its closing angle bracket.
+ *
+ * @details
+ * The closing angle bracket is not consumed.
+ */
+template <typename T>
+    requires(!std::same_as<T, List>)
+std::expected<T, Error> ParseItemElems(Cursor& cur) noexcept {
+    T vals;
+    if constexpr (std::same_as<T, ASCII>) {
+        if (cur.Consume('"')) {
+            const auto quote_pos {cur.GetPos() - 1};
+            if (const auto str {cur.ReadQuoted()}; str.has_value())
+                [[likely]] {
+                vals = *str;
+            } else {
+                return cur.Fail(quote_pos, "Unterminated string");
+            }
+        }
+    } else {
+        while (true) {
+            cur.SkipSpaces();
+            const auto pos {cur.GetPos()};
+            const auto word {cur.ReadWord()};
+            if (word.empty()) {
+                break;
+            }
+
+            if (const auto val {ParseElem<T>(word)}; val.has_value())
+                [[likely]] {
+                vals.push_back(*val);
+            } else {
+                return cur.Fail(
+                    pos, std::format("Invalid {} value", format_tag<T>));
+            }
+        }
+    }
+
+    return vals;
+}
+
+//! Parse the elements of an item of the specified type.
+std::expected<Item, Error> ParseItemElems(const Type type,
+                                          Cursor& cur) noexcept {
+    std::optional<std::expected<Item, Error>> parsed;
+    ForEachFormatType([type, &cur, &parsed]<typename T>(std::type_identity<T>) {
+        if constexpr (!std::same_as<T, List>) {
+            if (type == format_code<T>) {
+                parsed = ParseItemElems<T>(cur).transform(
+                    [](T&& vals) noexcept { return Item {std::move(vals)}; });
+            }
+        }
+    });
+
+    assert(parsed.has_value());
+    return std::move(*parsed);
+}
+
+//! Parse a tag and map it to a type.
+std::optional<Type> ParseTag(const std::string_view tag) noexcept {
+    std::optional<Type> type;
+    ForEachFormatType([tag, &type]<typename T>(std::type_identity<T>) {
+        if (tag == format_tag<T>) {
+            type = format_code<T>;
+        }
+    });
+    return type;
+}
+
+/**
+ * @brief Parse the optional number of elements after a tag, such as @p [3].
+ *
+ * @return
+ * The number of elements if it is specified, @p std::nullopt if it is omitted,
+ * or an error if it is malformed.
+ */
+std::expected<std::optional<std::size_t>, Error> ParseElemCount(
+    Cursor& cur) noexcept {
+    if (!cur.Consume('[')) {
+        return std::nullopt;
+    }
+
+    cur.SkipSpaces();
+    const auto pos {cur.GetPos()};
+    const auto count {ParseNumber<std::size_t>(cur.ReadWord())};
+    if (!count.has_value()) [[unlikely]] {
+        return cur.Fail(pos, "Invalid number of elements");
+    } else if (!cur.Consume(']')) [[unlikely]] {
+        return cur.Fail("Expected ']'");
+    }
+    return count;
+}
+
+//! A list whose closing angle bracket has not been parsed yet.
+struct Frame {
+    List list;
+    //! The number of elements specified after the tag.
+    std::optional<std::size_t> count;
+    //! The offset of the opening angle bracket.
+    std::size_t pos {0};
+};
+
+//! Check whether the number of elements matches the specified one.
+bool IsElemCountMatched(const std::optional<std::size_t> count,
+                        const std::size_t size) noexcept {
+    return !count.has_value() || *count == size;
+}
+
+std::size_t GetElemCount(const Item& item) noexcept {
+    return std::visit(
+        [](const auto& raw) noexcept {
+            return static_cast<std::size_t>(raw.size());
+        },
+        item);
+}
+
+}  // namespace
+
+std::expected<Message::Value, Error> ParseSml(
+    const std::string_view sml) noexcept {
+    Cursor cur {sml};
+    // Partially parsed lists are kept on an explicit stack to support deep nesting.
+    std::vector<Frame> frames;
+    std::optional<Message::Value> root;
+    while (!root.has_value()) {
+        std::optional<Message::Value> val;
+        if (!frames.empty() && cur.Consume('>')) {
+            auto& frame {frames.back()};
+            if (!IsElemCountMatched(frame.count, frame.list.size()))
+                [[unlikely]] {
+                return cur.Fail(frame.pos, "Mismatched number of elements");
+            }
+
+            val = std::move(frame.list);
+            frames.pop_back();
+        } else {
+            if (!cur.Consume('<')) [[unlikely]] {
+                return cur.Fail(cur.IsEnd() ? "Unexpected end"
+                                            : "Expected '<' or '>'");
+            }
+
+            const auto pos {cur.GetPos() - 1};
+            const auto type {ParseTag(cur.ReadWord())};
+            if (!type.has_value()) [[unlikely]] {
+                return cur.Fail(pos + 1, "Unknown tag");
+            }
+
+            auto count {ParseElemCount(cur)};
+            if (!count.has_value()) [[unlikely]] {
+                return std::unexpected {std::move(count).error()};
+            }
+
+            if (*type == Type::List) {
+                frames.push_back({.list = {}, .count = *count, .pos = pos});
+                continue;
+            }
+
+            auto item {ParseItemElems(*type, cur)};
+            if (!item.has_value()) [[unlikely]] {
+                return std::unexpected {std::move(item).error()};
+            } else if (!cur.Consume('>')) [[unlikely]] {
+                return cur.Fail("Expected '>'");
+            } else if (!IsElemCountMatched(*count, GetElemCount(*item)))
+                [[unlikely]] {
+                return cur.Fail(pos, "Mismatched number of elements");
+            }
+
+            val = std::move(*item);
+        }
+
+        if (frames.empty()) {
+            root = std::move(val);
+        } else {
+            frames.back().list.push_back(std::move(*val));
+        }
+    }
+
+    cur.SkipSpaces();
+    if (!cur.IsEnd()) [[unlikely]] {
+        return cur.Fail("Unexpected characters after the message");
+    }
+
+    return std::move(*root);
+}
+
+}  // namespace secs2::sml
@@ -0,0 +1,36 @@
+/**
+ * @file sml_parser.h
+ * @brief Parsing SECS-II data from SML (SECS Message Language) strings.
+ *
+ * @par GitHub
+ * https://github.com/Zhuagenborn
+ *
+ * @date 2026-10-14
+ */
+
+#pragma once
+
+#include "secs2.h"
+
+#include <cstddef>
+#include <expected>
+#include <string_view>
+
+namespace secs2::sml {
+
+namespace err {
+
+/**
+ * @brief Make an error indicating that a SML string is invalid.
+ *
+ * @param pos The offset of the invalid character.
+ * @param reason Why the string is invalid.
+ */
+Error MakeInvalidSmlError(std::size_t pos, std::string_view reason) noexcept;
+
+}  // namespace err
+
+//! Same as @ref Message::BuildFromSml.
+std::expected<Message::Value, Error> ParseSml(std::string_view sml) noexcept;
+
+}  // namespace secs2::sml
@@ -0,0 +1,224 @@
+#include "template.h"
+#include "byte/length.h"
+#include "byte/read.h"
+#include "byte/swap.h"
+#include "byte/write.h"
+#include "index.h"
+#include "traits.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <format>
+#include <system_error>
+#include <utility>
+
+namespace secs2 {
+
+namespace {
+
+namespace err {
+
+//! Make an error indicating that a slot refers to a list.
+Error MakeListSlotError() noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            "A slot must be an item rather than a list"};
+}
+
+//! Make an error indicating that a value is not of the type of a slot.
+Error MakeMismatchedTypeError(const Type expected,
+                              const Type actual) noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            std::format("The slot is {} rather than {}", to_string(expected),
+                        to_string(actual))};
+}
+
+//! Make an error indicating that a slot does not exist.
+Error MakeUnknownSlotError(const std::size_t idx,
+                           const std::size_t count) noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            std::format("The slot {} does not exist in {} slots", idx, count)};
+}
+
+}  // namespace err
+
+}  // namespace
+
+MessageTemplate::MessageTemplate(std::vector<std::byte> bytes) noexcept :
+    bytes_ {std::move(bytes)} {}
+
+std::expected<MessageTemplate, Error> MessageTemplate::Build(
+    const Message& msg) noexcept {
+    auto bytes {msg.ToBytes()};
+    if (!bytes.has_value()) [[unlikely]] {
+        return std::unexpected {byte::w::err::MakeExceededLengthError()};
+    }
+
+    return MessageTemplate {std::move(*bytes)};
+}
+
+std::expected<MessageTemplate, Error> MessageTemplate::BuildFromBytes(
+    const std::span<const std::byte> bytes) noexcept {
+    const auto size {byte::r::CheckMsgBytes(bytes)};
+    if (!size.has_value()) [[unlikely]] {
+        return std::unexpected {size.error()};
+    }
+
+    const auto msg_bytes {bytes.first(*size)};
+    return MessageTemplate {
+        std::vector<std::byte> {msg_bytes.begin(), msg_bytes.end()}};
+}
+
+std::expected<std::size_t, Error> MessageTemplate::AddSlot(
+    const std::span<const std::size_t> path) noexcept {
+    const auto elem_bytes {FindElemBytes(bytes_, path)};
+    if (!elem_bytes.has_value()) [[unlikely]] {
+        return std::unexpected {elem_bytes.error()};
+    }
+
+    const auto header {byte::r::ReadHeader(*elem_bytes)};
+    assert(header.has_value());
+    if (header->type == Type::List) [[unlikely]] {
+        return std::unexpected {err::MakeListSlotError()};
+    }
+
+    // Slots refer to distinct items, so that each of them follows the changes
+    // of the bytes after it.
+    const auto offset {
+        static_cast<std::size_t>(elem_bytes->data() - bytes_.data())};
+    if (const auto it {std::ranges::find(slots_, offset, &Slot::offset)};
+        it != slots_.cend()) {
+        return static_cast<std::size_t>(it - slots_.cbegin());
+    }
+
+    slots_.push_back({.type = header->type,
+                      .offset = offset,
+                      .header_size = header->size,
+                      .len = header->len});
+    return slots_.size() - 1;
+}
+
+std::size_t MessageTemplate::GetSlotCount() const noexcept {
+    return slots_.size();
+}
+
+std::span<const std::byte> MessageTemplate::GetBytes() const noexcept {
+    return bytes_;
+}
+
+template <typename F>
+std::expected<void, Error> MessageTemplate::Replace(const std::size_t idx,
+                                                    const Type type,
+                                                    const std::size_t len,
+                                                    F&& write) noexcept {
+    if (idx >= slots_.size()) [[unlikely]] {
+        return std::unexpected {err::MakeUnknownSlotError(idx, slots_.size())};
+    }
+
+    auto& slot {slots_[idx]};
+    if (slot.type != type) [[unlikely]] {
+        return std::unexpected {err::MakeMismatchedTypeError(slot.type, type)};
+    }
+
+    if (len == slot.len) [[likely]] {
+        write(std::span {bytes_}.subspan(slot.offset + slot.header_size, len));
+        return {};
+    }
+
+    const auto header_size {codec::CalcHeaderSize(len)};
+    if (!header_size.has_value()) [[unlikely]] {
+        return std::unexpected {byte::w::err::MakeExceededLengthError()};
+    }
+
+    // The bytes after the slot are moved for the new header and value.
+    const auto old_size {slot.header_size + slot.len};
+    const auto new_size {*header_size + len};
+    const auto old_end {slot.offset + old_size};
+    if (new_size > old_size) {
+        bytes_.insert(bytes_.begin() + old_end, new_size - old_size,
+                      std::byte {0});
+    } else {
+        bytes_.erase(bytes_.begin() + (slot.offset + new_size),
+                     bytes_.begin() + old_end);
+    }
+
+    slot.header_size = byte::w::WriteHeaderBytes(
+        type, len, std::span {bytes_}.subspan(slot.offset));
+    slot.len = len;
+    write(std::span {bytes_}.subspan(slot.offset + slot.header_size, len));
+
+    for (auto& other : slots_) {
+        if (other.offset > slot.offset) {
+            other.offset = other.offset + new_size - old_size;
+        }
+    }
+    return {};
+}
+
+std::expected<void, Error> MessageTemplate::Fill(const std::size_t slot,
+                                                 const Item& item) noexcept {
+    return Replace(slot, GetType(item), CalcLength(item),
+                   [&item](const std::span<std::byte> buf) noexcept {
+                       byte::w::WriteValBytes(item, buf);
+                   });
+}
+
+template <typename T>
+    requires(!std::same_as<T, List> && !std::same_as<T, ASCII>
+             && !std::same_as<T, Boolean>)
+std::expected<void, Error> MessageTemplate::Fill(
+    const std::size_t slot,
+    const std::span<const std::ranges::range_value_t<T>> vals) noexcept {
+    return Replace(slot, format_code<T>, vals.size_bytes(),
+                   [vals](const std::span<std::byte> buf) noexcept {
+                       if constexpr (std::same_as<T, Binary>) {
+                           std::ranges::copy(vals, buf.begin());
+                       } else {
+                           byte::StoreBigEndian(vals, buf);
+                       }
+                   });
+}
+
+#define INSTANTIATE_FILL(type)                                                 \
+    template std::expected<void, Error> MessageTemplate::Fill<type>(           \
+        std::size_t,                                                           \
+        std::span<const std::ranges::range_value_t<type>>) noexcept;
+
+INSTANTIATE_FILL(Binary)
+INSTANTIATE_FILL(I1)
+INSTANTIATE_FILL(I2)
+INSTANTIATE_FILL(I4)
+INSTANTIATE_FILL(I8)
+INSTANTIATE_FILL(U1)
+INSTANTIATE_FILL(U2)
+INSTANTIATE_FILL(U4)
+INSTANTIATE_FILL(U8)
+INSTANTIATE_FILL(F4)
+INSTANTIATE_FILL(F8)
+
+std::expected<void, Error> MessageTemplate::FillAscii(
+    const std::size_t slot, const std::string_view chars) noexcept {
+    return Replace(slot, Type::ASCII, chars.size(),
+                   [chars](const std::span<std::byte> buf) noexcept {
+                       std::ranges::copy(std::as_bytes(std::span {chars}),
+                                         buf.begin());
+                   });
+}
+
+std::expected<void, Error> MessageTemplate::FillBoolean(
+    const std::size_t slot, const std::span<const bool> vals) noexcept {
+    return Replace(slot, Type::Boolean, vals.size(),
+                   [vals](const std::span<std::byte> buf) noexcept {
+                       std::ranges::transform(
+                           vals, buf.begin(), [](const bool val) noexcept {
+                               return static_cast<std::byte>(val);
+                           });
+                   });
+}
+
+std::expected<void, Error> MessageTemplate::FillBoolean(
+    const std::size_t slot, const bool val) noexcept {
+    return FillBoolean(slot, std::span {&val, 1});
+}
+
+}  // namespace secs2
@@ -12,46 +12,100 @@
 
 #include "secs2.h"
 
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <ranges>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <variant>
 
 namespace secs2 {
 
-//! A function object combining multiple callable types.
-template <typename... Fs>
-struct Overload : Fs... {
-    template <typename... Ts>
-    explicit Overload(Ts&&... ts) : Fs {std::forward<Ts>(ts)}... {}
+//! The number of possible format codes.
+inline constexpr std::size_t format_code_count {0b111111 + 1};
 
-    using Fs::operator()...;
-};
-
-template <typename... Ts>
-Overload(Ts&&...) -> Overload<std::remove_reference_t<Ts>...>;
-
-//! Map types to format codes.
+//! Map types to their names.
 template <typename T>
-inline constexpr Type format_code {Type::Unknown};
+inline constexpr std::string_view format_name {};
 
-#define MAP_FORMAT_TYPE_TO_CODE(type) \
+#define MAP_FORMAT_TYPE_TO_NAME(type) \
     template <>                       \
-    inline constexpr Type format_code<type> {Type::type};
-
-MAP_FORMAT_TYPE_TO_CODE(Binary)
-MAP_FORMAT_TYPE_TO_CODE(ASCII)
-MAP_FORMAT_TYPE_TO_CODE(List)
-MAP_FORMAT_TYPE_TO_CODE(Boolean)
-MAP_FORMAT_TYPE_TO_CODE(I1)
-MAP_FORMAT_TYPE_TO_CODE(I2)
-MAP_FORMAT_TYPE_TO_CODE(I4)
-MAP_FORMAT_TYPE_TO_CODE(I8)
-MAP_FORMAT_TYPE_TO_CODE(U1)
-MAP_FORMAT_TYPE_TO_CODE(U2)
-MAP_FORMAT_TYPE_TO_CODE(U4)
-MAP_FORMAT_TYPE_TO_CODE(U8)
-MAP_FORMAT_TYPE_TO_CODE(F4)
-MAP_FORMAT_TYPE_TO_CODE(F8)
+    inline constexpr std::string_view format_name<type> {#type};
+
+MAP_FORMAT_TYPE_TO_NAME(Binary)
+MAP_FORMAT_TYPE_TO_NAME(ASCII)
+MAP_FORMAT_TYPE_TO_NAME(List)
+MAP_FORMAT_TYPE_TO_NAME(Boolean)
+MAP_FORMAT_TYPE_TO_NAME(I1)
+MAP_FORMAT_TYPE_TO_NAME(I2)
+MAP_FORMAT_TYPE_TO_NAME(I4)
+MAP_FORMAT_TYPE_TO_NAME(I8)
+MAP_FORMAT_TYPE_TO_NAME(U1)
+MAP_FORMAT_TYPE_TO_NAME(U2)
+MAP_FORMAT_TYPE_TO_NAME(U4)
+MAP_FORMAT_TYPE_TO_NAME(U8)
+MAP_FORMAT_TYPE_TO_NAME(F4)
+MAP_FORMAT_TYPE_TO_NAME(F8)
+
+#undef MAP_FORMAT_TYPE_TO_NAME
+
+//! Invoke a function with a @p std::type_identity tag for each SECS-II type, including lists.
+template <typename F>
+constexpr void ForEachFormatType(F&& f) noexcept {
+    f(std::type_identity<List> {});
+    [&f]<std::size_t... Is>(std::index_sequence<Is...>) noexcept {
+        (f(std::type_identity<std::variant_alternative_t<Is, Item>> {}), ...);
+    }(std::make_index_sequence<std::variant_size_v<Item>> {});
+}
+
+/**
+ * @brief Build a table indexed by format codes.
+ *
+ * @param make
+ * A function returning the entry for a @p std::type_identity tag of a SECS-II type.
+ * Entries for unknown format codes are value-initialized.
+ */
+template <typename Entry, typename F>
+constexpr std::array<Entry, format_code_count> BuildFormatCodeTable(
+    F&& make) noexcept {
+    std::array<Entry, format_code_count> table {};
+    ForEachFormatType([&table, &make]<typename T>(std::type_identity<T> tag) {
+        table[static_cast<std::size_t>(format_code<T>)] = make(tag);
+    });
+    return table;
+}
+
+//! Whether each format code is a known SECS-II type.
+inline constexpr auto known_types {BuildFormatCodeTable<bool>(
+    [](auto) noexcept { return true; })};
+
+//! The size of a single element of each SECS-II item, or zero for lists.
+inline constexpr auto elem_sizes {BuildFormatCodeTable<std::size_t>(
+    []<typename T>(std::type_identity<T>) noexcept -> std::size_t {
+        if constexpr (std::same_as<T, List>) {
+            return 0;
+        } else {
+            return sizeof(std::ranges::range_value_t<T>);
+        }
+    })};
+
+//! Check whether a format code is a known SECS-II type.
+constexpr bool IsKnownType(const Type type) noexcept {
+    const auto code {static_cast<std::size_t>(type)};
+    return code < known_types.size() && known_types[code];
+}
+
+/**
+ * @brief Get the size of a single element of a SECS-II item in bytes.
+ *
+ * @return The size of an element, or zero for lists and unknown types.
+ */
+constexpr std::size_t GetElemSize(const Type type) noexcept {
+    const auto code {static_cast<std::size_t>(type)};
+    return code < elem_sizes.size() ? elem_sizes[code] : 0;
+}
 
 //! @overload
 constexpr Type GetType(const List&) noexcept {
@@ -0,0 +1,284 @@
+#include "view.h"
+#include "byte/read.h"
+#include "sml.h"
+#include "traits.h"
+
+#include <array>
+#include <cassert>
+
+namespace secs2 {
+
+namespace {
+
+/**
+ * @brief Check that lists are not nested deeper than the default limit of deserialization.
+ *
+ * @warning The bytes must have been checked by @ref byte::r::CheckMsgBytes.
+ */
+std::expected<void, Error> CheckMsgDepth(
+    const std::span<const std::byte> bytes) noexcept {
+    constexpr auto max_depth {DecodeOptions {}.max_depth};
+    // The number of elements that still have to be read at each level.
+    std::array<std::size_t, max_depth + 1> pending_counts;
+    pending_counts[0] = 1;
+    std::size_t depth {0};
+    std::size_t byte_size {0};
+    while (true) {
+        const auto header {byte::r::ReadHeader(bytes.subspan(byte_size))};
+        assert(header.has_value());
+        byte_size += header->size;
+        --pending_counts[depth];
+        if (header->type != Type::List) {
+            byte_size += header->len;
+        } else if (depth == max_depth) [[unlikely]] {
+            return std::unexpected {
+                byte::r::err::MakeExceededDepthError(max_depth)};
+        } else if (header->len != 0) {
+            pending_counts[++depth] = header->len;
+        }
+
+        while (pending_counts[depth] == 0) {
+            if (depth == 0) {
+                return {};
+            }
+
+            --depth;
+        }
+    }
+}
+
+}  // namespace
+
+ItemView::ItemView(const std::span<const std::byte> bytes,
+                   const std::size_t byte_size) noexcept :
+    bytes_ {bytes.first(byte_size)} {
+    const auto header {byte::r::ReadHeader(bytes_)};
+    assert(header.has_value());
+    [[assume(header.has_value())]];
+    type_ = header->type;
+    len_ = header->len;
+    header_size_ = header->size;
+}
+
+Type ItemView::GetType() const noexcept {
+    return type_;
+}
+
+std::size_t ItemView::GetSize() const noexcept {
+    if (type_ == Type::List) {
+        return len_;
+    } else if (const auto elem_size {GetElemSize(type_)}; elem_size != 0)
+        [[likely]] {
+        return len_ / elem_size;
+    } else {
+        return 0;
+    }
+}
+
+std::span<const std::byte> ItemView::GetBytes() const noexcept {
+    return bytes_;
+}
+
+std::span<const std::byte> ItemView::GetBodyBytes() const noexcept {
+    return bytes_.subspan(header_size_);
+}
+
+std::optional<ItemView> ItemView::GetElem(const std::size_t idx) const noexcept {
+    if (type_ != Type::List || idx >= len_) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    return *std::ranges::next(begin(), static_cast<std::ptrdiff_t>(idx));
+}
+
+ItemView::Iterator ItemView::begin() const noexcept {
+    return type_ == Type::List ? Iterator {GetBodyBytes(), len_} : Iterator {};
+}
+
+ItemView::Iterator ItemView::end() const noexcept {
+    return Iterator {};
+}
+
+template <typename T>
+    requires(!std::same_as<T, List>)
+std::optional<std::ranges::range_value_t<T>> ItemView::GetElemValue(
+    const std::size_t idx) const noexcept {
+    using Value = std::ranges::range_value_t<T>;
+    if (type_ != format_code<T> || idx >= GetSize()) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    const auto bytes {GetBodyBytes().subspan(idx * sizeof(Value))};
+    if constexpr (std::same_as<T, Boolean>) {
+        return Value {bytes.front() != std::byte {0}};
+    } else if constexpr (sizeof(Value) <= sizeof(std::byte)) {
+        return static_cast<Value>(bytes.front());
+    } else {
+        return codec::LoadScalar<Value>(bytes);
+    }
+}
+
+std::optional<std::string_view> ItemView::GetASCII() const noexcept {
+    if (type_ != Type::ASCII) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    const auto bytes {GetBodyBytes()};
+    return std::string_view {reinterpret_cast<const char*>(bytes.data()),
+                             bytes.size()};
+}
+
+std::optional<std::span<const std::byte>> ItemView::GetBinary()
+    const noexcept {
+    if (type_ != Type::Binary) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    return GetBodyBytes();
+}
+
+template <typename T>
+std::optional<T> ItemView::GetValue() const noexcept {
+    if (type_ != format_code<T>) [[unlikely]] {
+        return std::nullopt;
+    }
+
+    if constexpr (std::same_as<T, List>) {
+        return std::get<List>(ToValue());
+    } else {
+        return std::get<T>(std::get<Item>(ToValue()));
+    }
+}
+
+Message::Value ItemView::ToValue() const noexcept {
+    byte::r::LoadContext ctx;
+    auto loaded {byte::r::LoadMsgBytes(bytes_, ctx)};
+    assert(loaded.has_value());
+    [[assume(loaded.has_value())]];
+    return std::move(loaded->first);
+}
+
+Message ItemView::ToMessage() const noexcept {
+    return Message {ToValue()};
+}
+
+#define INSTANTIATE_ITEM_VIEW_GETTERS(type)                                    \
+    template std::optional<std::ranges::range_value_t<type>>                   \
+    ItemView::GetElemValue<type>(std::size_t) const noexcept;                  \
+    template std::optional<type> ItemView::GetValue<type>() const noexcept;
+
+INSTANTIATE_ITEM_VIEW_GETTERS(Binary)
+INSTANTIATE_ITEM_VIEW_GETTERS(ASCII)
+INSTANTIATE_ITEM_VIEW_GETTERS(Boolean)
+INSTANTIATE_ITEM_VIEW_GETTERS(I1)
+INSTANTIATE_ITEM_VIEW_GETTERS(I2)
+INSTANTIATE_ITEM_VIEW_GETTERS(I4)
+INSTANTIATE_ITEM_VIEW_GETTERS(I8)
+INSTANTIATE_ITEM_VIEW_GETTERS(U1)
+INSTANTIATE_ITEM_VIEW_GETTERS(U2)
+INSTANTIATE_ITEM_VIEW_GETTERS(U4)
+INSTANTIATE_ITEM_VIEW_GETTERS(U8)
+INSTANTIATE_ITEM_VIEW_GETTERS(F4)
+INSTANTIATE_ITEM_VIEW_GETTERS(F8)
+
+template std::optional<List> ItemView::GetValue<List>() const noexcept;
+
+ItemView::Iterator::Iterator(const std::span<const std::byte> bytes,
+                             const std::size_t count) noexcept :
+    bytes_ {bytes}, count_ {count} {
+    if (count_ != 0) {
+        curr_ = ItemView {bytes_, byte::r::SkipMsgBytes(bytes_)};
+    }
+}
+
+const ItemView& ItemView::Iterator::operator*() const noexcept {
+    assert(count_ != 0);
+    return curr_;
+}
+
+const ItemView* ItemView::Iterator::operator->() const noexcept {
+    assert(count_ != 0);
+    return &curr_;
+}
+
+ItemView::Iterator& ItemView::Iterator::operator++() noexcept {
+    assert(count_ != 0);
+    bytes_ = bytes_.subspan(curr_.GetBytes().size());
+    if (--count_ != 0) {
+        curr_ = ItemView {bytes_, byte::r::SkipMsgBytes(bytes_)};
+    } else {
+        bytes_ = {};
+        curr_ = {};
+    }
+    return *this;
+}
+
+ItemView::Iterator ItemView::Iterator::operator++(int) noexcept {
+    auto old {*this};
+    ++*this;
+    return old;
+}
+
+bool ItemView::Iterator::operator==(const Iterator& other) const noexcept {
+    return count_ == other.count_
+           && curr_.GetBytes().data() == other.curr_.GetBytes().data();
+}
+
+MessageView::MessageView(ItemView root) noexcept : root_ {std::move(root)} {}
+
+std::expected<MessageView, Error> MessageView::BuildFromBytes(
+    const std::span<const std::byte> bytes) noexcept {
+    const auto byte_size {byte::r::CheckMsgBytes(bytes)};
+    if (!byte_size.has_value()) [[unlikely]] {
+        return std::unexpected {byte_size.error()};
+    } else if (const auto checked {CheckMsgDepth(bytes.first(*byte_size))};
+               !checked.has_value()) [[unlikely]] {
+        return std::unexpected {checked.error()};
+    }
+
+    return MessageView {ItemView {bytes, *byte_size}};
+}
+
+const ItemView& MessageView::GetRoot() const noexcept {
+    return root_;
+}
+
+Type MessageView::GetType() const noexcept {
+    return root_.GetType();
+}
+
+std::size_t MessageView::GetSize() const noexcept {
+    return root_.GetSize();
+}
+
+std::size_t MessageView::GetByteSize() const noexcept {
+    return root_.GetBytes().size();
+}
+
+Message MessageView::ToMessage() const noexcept {
+    return root_.ToMessage();
+}
+
+std::string MessageView::ToSml(const std::size_t indent_width) const noexcept {
+    return ToSml({.indent_width = indent_width});
+}
+
+std::string MessageView::ToSml(const SmlOptions& opts) const noexcept {
+    std::string sml;
+    AppendSml(sml, opts);
+    return sml;
+}
+
+void MessageView::AppendSml(std::string& buf,
+                            const std::size_t indent_width) const noexcept {
+    AppendSml(buf, {.indent_width = indent_width});
+}
+
+void MessageView::AppendSml(std::string& buf,
+                            const SmlOptions& opts) const noexcept {
+    [[maybe_unused]] const auto byte_size {
+        sml::BuildSmlFromBytes(buf, root_.GetBytes(), opts)};
+    assert(byte_size.has_value());
+}
+
+}  // namespace secs2
@@ -0,0 +1,281 @@
+#include "writer.h"
+#include "byte/length.h"
+#include "byte/write.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <format>
+#include <system_error>
+#include <utility>
+
+namespace secs2 {
+
+namespace {
+
+namespace err {
+
+//! Make an error indicating that the number of elements written to a list does not match the declared one.
+Error MakeMismatchedElemCountError(const std::size_t declared,
+                                   const std::size_t written) noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            std::format("A list declared with {} elements has {} elements",
+                        declared, written)};
+}
+
+//! Make an error indicating that a list is closed without being started.
+Error MakeUnopenedListError() noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            "No list is started"};
+}
+
+//! Make an error indicating that lists are not closed.
+Error MakeUnclosedListError(const std::size_t count) noexcept {
+    return {std::make_error_code(std::errc::invalid_argument),
+            std::format("{} lists are not closed", count)};
+}
+
+}  // namespace err
+
+//! The size of chunks for converting values to big-endian on the stack.
+constexpr std::size_t chunk_size {256};
+
+}  // namespace
+
+MessageWriter::MessageWriter(std::vector<std::byte>& buf) noexcept :
+    buf_ {&buf}, init_buf_size_ {buf.size()} {}
+
+MessageWriter::MessageWriter(ByteSink sink) noexcept :
+    sink_ {std::move(sink)} {
+    assert(sink_);
+}
+
+void MessageWriter::Fail(Error err) noexcept {
+    assert(!err_.has_value());
+    err_ = std::move(err);
+    if (buf_ != nullptr) {
+        buf_->resize(init_buf_size_);
+    }
+}
+
+void MessageWriter::WriteBytes(
+    const std::span<const std::byte> bytes) noexcept {
+    if (buf_ != nullptr) {
+        buf_->insert(buf_->end(), bytes.begin(), bytes.end());
+    } else {
+        sink_(bytes);
+    }
+
+    byte_size_ += bytes.size();
+}
+
+template <typename T>
+    requires std::is_arithmetic_v<T>
+void MessageWriter::WriteBigEndian(const std::span<const T> vals) noexcept {
+    if (buf_ != nullptr) {
+        const auto offset {buf_->size()};
+        buf_->resize(offset + vals.size_bytes());
+        byte::StoreBigEndian(vals, std::span {*buf_}.subspan(offset));
+        byte_size_ += vals.size_bytes();
+        return;
+    }
+
+    constexpr auto chunk_count {chunk_size / sizeof(T)};
+    std::array<std::byte, chunk_count * sizeof(T)> chunk;
+    for (std::size_t i {0}; i < vals.size(); i += chunk_count) {
+        const auto count {std::min(chunk_count, vals.size() - i)};
+        const auto bytes {std::span {chunk}.first(count * sizeof(T))};
+        byte::StoreBigEndian(vals.subspan(i, count), bytes);
+        WriteBytes(bytes);
+    }
+}
+
+void MessageWriter::WriteHeader(const Type type,
+                                const std::size_t len) noexcept {
+    std::array<std::byte, codec::max_header_size> header;
+    const auto size {byte::w::WriteHeaderBytes(type, len, header)};
+    WriteBytes(std::span<const std::byte> {header}.first(size));
+}
+
+bool MessageWriter::BeginElem() noexcept {
+    if (err_.has_value()) [[unlikely]] {
+        return false;
+    } else if (frames_.empty()) {
+        return true;
+    }
+
+    auto& frame {frames_.back()};
+    if (frame.written == frame.count) [[unlikely]] {
+        Fail(err::MakeMismatchedElemCountError(frame.count, frame.count + 1));
+        return false;
+    }
+
+    ++frame.written;
+    return true;
+}
+
+bool MessageWriter::WriteItemHeader(const Type type,
+                                    const std::size_t len) noexcept {
+    if (!BeginElem()) [[unlikely]] {
+        return false;
+    } else if (IsExceedMaxLength(len)) [[unlikely]] {
+        Fail(byte::w::err::MakeExceededLengthError());
+        return false;
+    }
+
+    WriteHeader(type, len);
+    return true;
+}
+
+MessageWriter& MessageWriter::BeginList(const std::size_t count) noexcept {
+    if (!WriteItemHeader(Type::List, count)) [[unlikely]] {
+        return *this;
+    }
+
+    frames_.push_back({.count = count});
+    return *this;
+}
+
+MessageWriter& MessageWriter::EndList() noexcept {
+    if (err_.has_value()) [[unlikely]] {
+        return *this;
+    }
+
+    if (frames_.empty()) [[unlikely]] {
+        Fail(err::MakeUnopenedListError());
+        return *this;
+    } else if (const auto frame {frames_.back()};
+               frame.written != frame.count) [[unlikely]] {
+        Fail(err::MakeMismatchedElemCountError(frame.count, frame.written));
+        return *this;
+    }
+
+    frames_.pop_back();
+    return *this;
+}
+
+template <typename T>
+    requires(!std::same_as<T, List> && !std::same_as<T, ASCII>
+             && !std::same_as<T, Boolean>)
+MessageWriter& MessageWriter::WriteItem(
+    const std::span<const std::ranges::range_value_t<T>> vals) noexcept {
+    if (!WriteItemHeader(format_code<T>, vals.size_bytes())) [[unlikely]] {
+        return *this;
+    }
+
+    if constexpr (std::same_as<T, Binary>) {
+        WriteBytes(vals);
+    } else {
+        WriteBigEndian(vals);
+    }
+    return *this;
+}
+
+#define INSTANTIATE_WRITE_ITEM(type)                                           \
+    template MessageWriter& MessageWriter::WriteItem<type>(                    \
+        std::span<const std::ranges::range_value_t<type>>) noexcept;
+
+INSTANTIATE_WRITE_ITEM(Binary)
+INSTANTIATE_WRITE_ITEM(I1)
+INSTANTIATE_WRITE_ITEM(I2)
+INSTANTIATE_WRITE_ITEM(I4)
+INSTANTIATE_WRITE_ITEM(I8)
+INSTANTIATE_WRITE_ITEM(U1)
+INSTANTIATE_WRITE_ITEM(U2)
+INSTANTIATE_WRITE_ITEM(U4)
+INSTANTIATE_WRITE_ITEM(U8)
+INSTANTIATE_WRITE_ITEM(F4)
+INSTANTIATE_WRITE_ITEM(F8)
+
+MessageWriter& MessageWriter::Write(const Message::Value& val) noexcept {
+    if (!BeginElem()) [[unlikely]] {
+        return *this;
+    }
+
+    const auto size {CalcEncodedSize(val)};
+    if (!size.has_value()) [[unlikely]] {
+        Fail(byte::w::err::MakeExceededLengthError());
+        return *this;
+    }
+
+    if (buf_ != nullptr) {
+        const auto offset {buf_->size()};
+        buf_->resize(offset + *size);
+        byte_size_ += byte::w::WriteMsgBytes(
+            val, std::span {*buf_}.subspan(offset, *size));
+    } else {
+        byte_size_ += byte::w::EmitMsgBytes(val, sink_);
+    }
+    return *this;
+}
+
+MessageWriter& MessageWriter::WriteAscii(
+    const std::string_view chars) noexcept {
+    if (WriteItemHeader(Type::ASCII, chars.size())) [[likely]] {
+        WriteBytes(std::as_bytes(std::span {chars}));
+    }
+    return *this;
+}
+
+MessageWriter& MessageWriter::WriteBinary(
+    const std::span<const std::byte> vals) noexcept {
+    return WriteItem<Binary>(vals);
+}
+
+MessageWriter& MessageWriter::WriteBoolean(
+    const std::span<const bool> vals) noexcept {
+    if (!WriteItemHeader(Type::Boolean, vals.size())) [[unlikely]] {
+        return *this;
+    }
+
+    std::array<std::byte, chunk_size> chunk;
+    for (std::size_t i {0}; i < vals.size(); i += chunk.size()) {
+        const auto count {std::min(chunk.size(), vals.size() - i)};
+        const auto bytes {std::span {chunk}.first(count)};
+        std::ranges::transform(vals.subspan(i, count), bytes.begin(),
+                               [](const bool val) noexcept {
+                                   return static_cast<std::byte>(val);
+                               });
+        WriteBytes(bytes);
+    }
+    return *this;
+}
+
+MessageWriter& MessageWriter::WriteBoolean(const bool val) noexcept {
+    return WriteBoolean(std::span {&val, 1});
+}
+
+#define DEFINE_WRITE_NUMBERS(type)                                             \
+    MessageWriter& MessageWriter::Write##type(                                 \
+        const std::span<const std::ranges::range_value_t<type>>                \
+            vals) noexcept {                                                   \
+        return WriteItem<type>(vals);                                          \
+    }                                                                          \
+                                                                               \
+    MessageWriter& MessageWriter::Write##type(                                 \
+        const std::ranges::range_value_t<type> val) noexcept {                 \
+        return WriteItem<type>(std::span {&val, 1});                           \
+    }
+
+DEFINE_WRITE_NUMBERS(I1)
+DEFINE_WRITE_NUMBERS(I2)
+DEFINE_WRITE_NUMBERS(I4)
+DEFINE_WRITE_NUMBERS(I8)
+DEFINE_WRITE_NUMBERS(U1)
+DEFINE_WRITE_NUMBERS(U2)
+DEFINE_WRITE_NUMBERS(U4)
+DEFINE_WRITE_NUMBERS(U8)
+DEFINE_WRITE_NUMBERS(F4)
+DEFINE_WRITE_NUMBERS(F8)
+
+std::expected<std::size_t, Error> MessageWriter::Finish() const noexcept {
+    if (err_.has_value()) [[unlikely]] {
+        return std::unexpected {*err_};
+    } else if (!frames_.empty()) [[unlikely]] {
+        return std::unexpected {err::MakeUnclosedListError(frames_.size())};
+    }
+
+    return byte_size_;
+}
+
+}  // namespace secs2
@@ -1,12 +1,102 @@
 #include "secs2/secs2.h"
+#include "secs2/archive.h"
+#include "secs2/batch.h"
+#include "secs2/codec.h"
+#include "secs2/decoder.h"
+#include "secs2/encoded.h"
+#include "secs2/hash.h"
+#include "secs2/index.h"
+#include "secs2/instrument.h"
+#include "secs2/lazy_list.h"
+#include "secs2/parallel.h"
+#include "secs2/schema.h"
+#include "secs2/small_vector.h"
+#include "secs2/template.h"
+#include "secs2/view.h"
+#include "secs2/writer.h"
 
 #include <bit_manip/bit_manip.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <limits>
+#include <new>
 #include <system_error>
+#include <unordered_set>
+
+#if __has_include(<sys/mman.h>)
+#include <unistd.h>
+#endif
 
 using namespace secs2;
 
+namespace {
+
+//! The number of allocations made through the global @p operator new.
+std::atomic<std::size_t> alloc_count {0};
+
+//! The size of the largest allocation made through the global @p operator new.
+std::atomic<std::size_t> max_alloc_size {0};
+
+//! The total size of allocations made through the global @p operator new.
+std::atomic<std::size_t> total_alloc_size {0};
+
+//! Record the size of an allocation.
+void RecordAllocSize(const std::size_t size) noexcept {
+    total_alloc_size += size;
+    auto curr {max_alloc_size.load(std::memory_order_relaxed)};
+    while (curr < size && !max_alloc_size.compare_exchange_weak(curr, size)) {
+    }
+}
+
+}  // namespace
+
+void* operator new(const std::size_t size) {
+    ++alloc_count;
+    RecordAllocSize(size);
+    if (const auto ptr {std::malloc(size != 0 ? size : 1)}) {
+        return ptr;
+    } else {
+        throw std::bad_alloc {};
+    }
+}
+
+void operator delete(void* const ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* const ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+// The default memory resource of polymorphic allocators uses aligned allocations.
+void* operator new(const std::size_t size, const std::align_val_t align) {
+    ++alloc_count;
+    RecordAllocSize(size);
+    const auto alignment {static_cast<std::size_t>(align)};
+    const auto aligned_size {(size + alignment - 1) / alignment * alignment};
+    if (const auto ptr {std::aligned_alloc(
+            alignment, aligned_size != 0 ? aligned_size : alignment)}) {
+        return ptr;
+    } else {
+        throw std::bad_alloc {};
+    }
+}
+
+void operator delete(void* const ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* const ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
 TEST(Secs2Message, GetType) {
     const Boolean bools {true, false};
     EXPECT_EQ(Message {bools}.GetType(), Type::Boolean);
@@ -20,6 +110,20 @@ TEST(Secs2Message, GetType) {
     EXPECT_EQ(Message {list}.GetType(), Type::List);
 }
 
+TEST(Secs2Message, TypeToString) {
+    EXPECT_EQ(to_string(Type::List), "List");
+    EXPECT_EQ(to_string(Type::Binary), "Binary");
+    EXPECT_EQ(to_string(Type::Boolean), "Boolean");
+    EXPECT_EQ(to_string(Type::ASCII), "ASCII");
+    EXPECT_EQ(to_string(Type::I1), "I1");
+    EXPECT_EQ(to_string(Type::I8), "I8");
+    EXPECT_EQ(to_string(Type::U2), "U2");
+    EXPECT_EQ(to_string(Type::F4), "F4");
+    EXPECT_EQ(to_string(Type::F8), "F8");
+    EXPECT_EQ(to_string(Type::Unknown), "Unknown");
+    EXPECT_EQ(to_string(static_cast<Type>(0b000001)), "Unknown");
+}
+
 TEST(Secs2Message, GetValue) {
     {
         const Boolean bools {true, false};
@@ -39,6 +143,78 @@ TEST(Secs2Message, GetValue) {
     }
 }
 
+TEST(Secs2Message, GetValuePtr) {
+    List sub_list;
+    sub_list.push_back(U4 {7});
+    sub_list.push_back(ASCII {"lot"});
+
+    List list;
+    list.push_back(U4 {1});
+    list.push_back(sub_list);
+    const Message msg {list};
+
+    // Pointers refer to the stored values instead of copies.
+    const auto stored {msg.GetValuePtr<List>()};
+    ASSERT_NE(stored, nullptr);
+    EXPECT_EQ(stored, std::get_if<List>(&msg.GetValue()));
+    EXPECT_EQ(msg.GetValuePtr<U4>(), nullptr);
+
+    const auto ceid {GetItemPtr<U4>(stored->front())};
+    ASSERT_NE(ceid, nullptr);
+    EXPECT_EQ(*ceid, U4 {1});
+    EXPECT_EQ(GetItemPtr<U2>(stored->front()), nullptr);
+    EXPECT_EQ(GetItemPtr<List>(stored->front()), nullptr);
+
+    ListElem elem {U1 {1}};
+    ASSERT_NE(GetItemPtr<U1>(elem), nullptr);
+    GetItemPtr<U1>(elem)->push_back(2);
+    EXPECT_EQ(GetItemValue<U1>(elem), (U1 {1, 2}));
+
+    const auto found {msg.FindElem({1, 1})};
+    ASSERT_NE(found, nullptr);
+    EXPECT_EQ(found, &(*GetItemPtr<List>((*stored)[1]))[1]);
+    EXPECT_EQ(GetItemValue<ASCII>(*found), ASCII {"lot"});
+    EXPECT_EQ(msg.FindElem({}), &msg.GetValue());
+    EXPECT_EQ(msg.FindElem({2}), nullptr);
+    EXPECT_EQ(msg.FindElem({0, 0}), nullptr);
+}
+
+TEST(Secs2Message, VisitValue) {
+    const Binary bins(1024, std::byte {0xAB});
+    const Message msg {bins};
+
+    // Spans refer to the stored elements.
+    const auto span {msg.GetValueSpan<Binary>()};
+    ASSERT_TRUE(span.has_value());
+    EXPECT_EQ(span->data(), msg.GetValuePtr<Binary>()->data());
+    EXPECT_EQ(span->size(), bins.size());
+    EXPECT_EQ(msg.GetValueSpan<U1>(), std::nullopt);
+    EXPECT_EQ(GetMsgValuePtr<Binary>(msg.GetValue()),
+              msg.GetValuePtr<Binary>());
+
+    const ListElem nums {U4 {1, 2, 3}};
+    const auto num_span {GetItemSpan<U4>(nums)};
+    ASSERT_TRUE(num_span.has_value());
+    EXPECT_TRUE(std::ranges::equal(*num_span, U4 {1, 2, 3}));
+
+    List list;
+    list.push_back(nums);
+    list.push_back(ASCII {"abc"});
+    const auto size_of {[](const ListElem& elem) {
+        return VisitValue(
+            elem,
+            Overload {[](const List& list) { return list.size() * 100; },
+                      [](const auto& item) { return item.size(); }});
+    }};
+    EXPECT_EQ(size_of(nums), 3);
+    EXPECT_EQ(size_of(list.back()), 3);
+    EXPECT_EQ(size_of(ListElem {list}), 200);
+
+    const auto type {Message {list}.Visit(
+        []<typename T>(const T&) { return std::same_as<T, List>; })};
+    EXPECT_TRUE(type);
+}
+
 TEST(Secs2Message, ToSml) {
     const I1 nums;
     EXPECT_EQ(Message {nums}.ToSml(), "<I1 [0]>");
@@ -77,6 +253,201 @@ TEST(Secs2Message, ToSml) {
 >)");
 }
 
+TEST(Secs2Message, AppendSml) {
+    const I1 i1s {-128, 0, 127};
+    const U8 u8s {0, std::numeric_limits<std::uint64_t>::max()};
+    const F4 f4s {0.1F, -1.5F, 1e-10F};
+    const F8 f8s {0.1, -0.0, 1e300, std::numeric_limits<double>::min()};
+
+    std::string buf {"prefix "};
+    Message {i1s}.AppendSml(buf);
+    EXPECT_EQ(buf, "prefix <I1 [3] -128 0 127>");
+
+    buf.clear();
+    Message {u8s}.AppendSml(buf);
+    EXPECT_EQ(buf, std::format("<U8 [2] 0 {}>", u8s.back()));
+
+    // Floating points are the shortest representations that round-trip.
+    buf.clear();
+    Message {f4s}.AppendSml(buf);
+    EXPECT_EQ(buf, std::format("<F4 [3] {} {} {}>", f4s[0], f4s[1], f4s[2]));
+
+    buf.clear();
+    Message {f8s}.AppendSml(buf);
+    EXPECT_EQ(buf, std::format("<F8 [4] {} {} {} {}>", f8s[0], f8s[1], f8s[2],
+                               f8s[3]));
+    EXPECT_EQ(buf, Message {f8s}.ToSml());
+}
+
+TEST(Secs2Message, BuildFromSml) {
+    List sub_list;
+    sub_list.push_back(I1 {-128, 127});
+    sub_list.push_back(Binary {std::byte {0x00}, std::byte {0xFF}});
+    sub_list.push_back(Boolean {true, false});
+
+    List list;
+    list.push_back(sub_list);
+    list.push_back(ASCII {"hello world"});
+    list.push_back(ASCII {});
+    list.push_back(List {});
+    list.push_back(U8 {std::numeric_limits<std::uint64_t>::max()});
+    list.push_back(F4 {0.1F, -1.5F});
+    list.push_back(F8 {1e300, -0.25});
+    list.push_back(U2 {});
+
+    // It parses the output of formatting.
+    const Message msg {list};
+    EXPECT_EQ(Message::BuildFromSml(msg.ToSml()), msg);
+    EXPECT_EQ(Message::BuildFromSml(msg.ToSml(0)), msg);
+
+    // Element counts are optional, and integers can be hexadecimal.
+    List hex_list;
+    hex_list.push_back(U4 {16, 16});
+    hex_list.push_back(ASCII {"a b"});
+    EXPECT_EQ(BuildMsgFromSml(" <L\n\t<U4 0x10 16>\r\n<A \"a b\">  > "),
+              Message {hex_list});
+
+    const auto expect_invalid {[](const std::string_view sml) {
+        const auto msg {Message::BuildFromSml(sml)};
+        ASSERT_FALSE(msg.has_value()) << sml;
+        EXPECT_EQ(msg.error().first, std::errc::invalid_argument) << sml;
+    }};
+
+    expect_invalid("");
+    expect_invalid("<X [0]>");
+    expect_invalid("<L [1]\n>");
+    expect_invalid("<U1 [1] 1 2>");
+    expect_invalid("<U1 256>");
+    expect_invalid("<I1 -129>");
+    expect_invalid("<U4 1.5>");
+    expect_invalid("<Boolean yes>");
+    expect_invalid("<A \"unterminated>");
+    expect_invalid("<L <U1 1>");
+    expect_invalid("<U1 1> <U1 2>");
+    expect_invalid("<U1 [x] 1>");
+}
+
+TEST(Secs2Message, BuildSmlFromBytes) {
+    List sub_list;
+    sub_list.push_back(I2 {-1, 2});
+    sub_list.push_back(List {});
+    sub_list.push_back(Binary {std::byte {0xAB}});
+
+    List list;
+    list.push_back(sub_list);
+    list.push_back(Boolean {true, false});
+    list.push_back(ASCII {"hello"});
+    list.push_back(ASCII {});
+    list.push_back(F4 {0.1F});
+    list.push_back(F8 {-2.5, 1e300});
+    list.push_back(U8 {std::numeric_limits<std::uint64_t>::max()});
+    list.push_back(sub_list);
+
+    for (const auto& msg : {Message {list}, Message {List {}}, Message {U1 {}},
+                            Message {ASCII {"a"}}}) {
+        const auto bytes {msg.ToBytes().value_or(std::vector<std::byte> {})};
+        EXPECT_EQ(BuildSmlFromBytes(bytes), msg.ToSml());
+        EXPECT_EQ(BuildSmlFromBytes(bytes, 0), msg.ToSml(0));
+
+        const auto view {MessageView::BuildFromBytes(bytes)};
+        ASSERT_TRUE(view.has_value());
+        EXPECT_EQ(view->ToSml(2), msg.ToSml(2));
+    }
+
+    const auto bytes {
+        Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto sml {
+        BuildSmlFromBytes(std::span {bytes}.first(bytes.size() - 1))};
+    ASSERT_FALSE(sml.has_value());
+    EXPECT_EQ(sml.error().first, std::errc::message_size);
+}
+
+TEST(Secs2Message, ToSmlWithLimits) {
+    List sub_list;
+    sub_list.push_back(U1 {1, 2, 3});
+    sub_list.push_back(List {});
+
+    List list;
+    list.push_back(sub_list);
+    list.push_back(ASCII {"hello"});
+    list.push_back(Boolean {true});
+    list.push_back(I2 {-1, 2});
+    const Message msg {list};
+
+    // Without limits, it is the same as the default formatting.
+    EXPECT_EQ(msg.ToSml(SmlOptions {}), msg.ToSml());
+
+    EXPECT_EQ(msg.ToSml({.indent_width = 2, .max_elem_count = 2}),
+              R"(<L [4]
+  <L [2]
+    <U1 [3] 1 2 ... (1 more)>
+    <L [0]
+    >
+  >
+  <A [5] "he" ... (3 more)>
+  ... (2 more)
+>)");
+
+    EXPECT_EQ(msg.ToSml({.indent_width = 2, .max_depth = 1}),
+              R"(<L [4]
+  <L [2] ... (2 more)>
+  <A [5] "hello">
+  <Boolean [1] true>
+  <I2 [2] -1 2>
+>)");
+
+    EXPECT_EQ(Message {List {}}.ToSml({.max_depth = 0}), "<L [0]\n>");
+    EXPECT_EQ(msg.ToSml({.max_depth = 0}), "<L [4] ... (4 more)>");
+
+    // The size limit is checked before each element.
+    EXPECT_EQ(msg.ToSml({.indent_width = 2, .max_size = 30}),
+              R"(<L [4]
+  <L [2]
+    <U1 [3] 1 2 ... (1 more)>
+    ... (1 more)
+  >
+  ... (3 more)
+>)");
+    EXPECT_EQ(Message {ASCII {"hello"}}.ToSml({.max_size = 10}),
+              "<A [5] \"hell\" ... (1 more)>");
+    EXPECT_EQ(Message {ASCII {"hello"}}.ToSml({.max_size = 0}),
+              "<A [5] ... (5 more)>");
+
+    // Huge items are formatted in bounded size.
+    const Message huge {U4(1'000'000)};
+    EXPECT_LT(huge.ToSml({.max_size = 100}).size(), 200);
+
+    // The bytes and the message are formatted the same.
+    const auto bytes {msg.ToBytes().value_or(std::vector<std::byte> {})};
+    for (const auto& opts :
+         {SmlOptions {.max_elem_count = 1}, SmlOptions {.max_depth = 1},
+          SmlOptions {.max_elem_count = 2, .max_depth = 1},
+          SmlOptions {.max_size = 0}, SmlOptions {.max_size = 30},
+          SmlOptions {.max_size = 60}}) {
+        EXPECT_EQ(BuildSmlFromBytes(bytes, opts), msg.ToSml(opts));
+
+        const auto view {MessageView::BuildFromBytes(bytes)};
+        ASSERT_TRUE(view.has_value());
+        EXPECT_EQ(view->ToSml(opts), msg.ToSml(opts));
+    }
+
+    // Elided elements are skipped over but still validated.
+    const auto sml {BuildSmlFromBytes(std::span {bytes}.first(bytes.size() - 1),
+                                      {.max_elem_count = 1})};
+    ASSERT_FALSE(sml.has_value());
+    EXPECT_EQ(sml.error().first, std::errc::message_size);
+
+    // The format specification has the form {indent_width}{e}{d}{b}.
+    EXPECT_EQ(std::format("{}", msg), msg.ToSml());
+    EXPECT_EQ(std::format("{:2}", msg), msg.ToSml(2));
+    EXPECT_EQ(std::format("{:2e2}", msg),
+              msg.ToSml({.indent_width = 2, .max_elem_count = 2}));
+    EXPECT_EQ(std::format("{:d1e2}", msg),
+              msg.ToSml({.max_elem_count = 2, .max_depth = 1}));
+    EXPECT_EQ(std::format("{:0b30}", msg),
+              msg.ToSml({.indent_width = 0, .max_size = 30}));
+}
+
 TEST(Secs2Message, GetSize) {
     {
         const I4 nums;
@@ -232,6 +603,40 @@ TEST(Secs2Message, ToBytes) {
     }
 }
 
+TEST(Secs2Message, GetEncodedSize) {
+    {
+        const ASCII str {"msg"};
+        EXPECT_EQ(Message {str}.GetEncodedSize(), 2 + str.size());
+    }
+    {
+        const U4 nums(std::numeric_limits<std::uint8_t>::max() + 1, 0);
+        const Message msg {nums};
+        EXPECT_EQ(msg.GetEncodedSize(),
+                  3 + nums.size() * sizeof(std::uint32_t));
+        EXPECT_EQ(msg.GetEncodedSize(), msg.ToBytes()->size());
+    }
+    {
+        const U1 nums(std::numeric_limits<std::uint16_t>::max() + 1, 0);
+        EXPECT_EQ(Message {nums}.GetEncodedSize(), 4 + nums.size());
+    }
+    {
+        List list;
+        EXPECT_EQ(Message {list}.GetEncodedSize(), 2);
+
+        list.push_back(U2 {1, 2});
+        list.push_back(list);
+        list.push_back(Boolean {true});
+        const Message msg {list};
+        EXPECT_EQ(msg.GetEncodedSize(), 2 + 6 + (2 + 6) + 3);
+        EXPECT_EQ(msg.GetEncodedSize(), msg.ToBytes()->size());
+    }
+    {
+        List list;
+        list.push_back(U1(Message::max_length + 1, 0));
+        EXPECT_FALSE(Message {list}.GetEncodedSize().has_value());
+    }
+}
+
 TEST(Secs2Message, BuildMsgFromBytes) {
     {
         const auto loaded {BuildMsgFromBytes({})};
@@ -372,4 +777,1830 @@ TEST(Secs2Message, BuildMsgFromBytes) {
         EXPECT_EQ(loaded->first, Message {target});
         EXPECT_EQ(loaded->second, bytes.size());
     }
-}
\ No newline at end of file
+}
+
+TEST(Secs2Message, SerializeInto) {
+    List list;
+    list.push_back(U2(300, 0x0102));
+    list.push_back(Boolean(300, true));
+    list.push_back(ASCII {"msg"});
+    list.push_back(list);
+    const Message msg {list};
+    const auto target {msg.ToBytes().value_or(std::vector<std::byte> {})};
+    {
+        constexpr std::size_t offset {10};
+        std::vector<std::byte> buf(offset + target.size() + 1,
+                                   static_cast<std::byte>(0xFF));
+        const auto size {msg.SerializeInto(std::span {buf}.subspan(offset))};
+        EXPECT_EQ(size, target.size());
+        EXPECT_TRUE(std::ranges::equal(
+            std::span {buf}.subspan(offset, target.size()), target));
+        EXPECT_EQ(buf.back(), static_cast<std::byte>(0xFF));
+    }
+    {
+        std::vector<std::byte> buf(target.size() - 1);
+        const auto size {msg.SerializeInto(std::span {buf})};
+        EXPECT_FALSE(size.has_value());
+        EXPECT_EQ(size.error().first, std::errc::no_buffer_space);
+    }
+    {
+        std::vector<std::byte> buf;
+        EXPECT_TRUE(msg.SerializeInto(std::back_inserter(buf)).has_value());
+        EXPECT_EQ(buf, target);
+    }
+    {
+        List values;
+        values.push_back(F4 {-1.5F});
+        values.push_back(F8 {0.25});
+        values.push_back(I8 {-2});
+        values.push_back(U1(70'000, 7));
+        const Message other {values};
+        std::vector<std::byte> buf;
+        EXPECT_TRUE(other.SerializeInto(std::back_inserter(buf)).has_value());
+        EXPECT_EQ(buf, other.ToBytes());
+    }
+    {
+        std::vector<std::byte> buf(target.size());
+        const auto last {msg.SerializeInto(buf.data())};
+        ASSERT_TRUE(last.has_value());
+        EXPECT_EQ(*last, buf.data() + buf.size());
+        EXPECT_EQ(buf, target);
+    }
+    {
+        std::size_t chunk_count {0};
+        std::vector<std::byte> buf;
+        const auto size {msg.SerializeInto(
+            [&chunk_count, &buf](const std::span<const std::byte> bytes) {
+                ++chunk_count;
+                buf.insert(buf.end(), bytes.begin(), bytes.end());
+            })};
+        EXPECT_EQ(size, target.size());
+        EXPECT_GT(chunk_count, 1);
+        EXPECT_EQ(buf, target);
+    }
+    {
+        const Message oversized {U1(Message::max_length + 1, 0)};
+        std::vector<std::byte> buf(Message::max_length + 4);
+        const auto size {oversized.SerializeInto(std::span {buf})};
+        EXPECT_FALSE(size.has_value());
+        EXPECT_EQ(size.error().first, std::errc::value_too_large);
+
+        const auto last {oversized.SerializeInto(buf.begin())};
+        EXPECT_FALSE(last.has_value());
+        EXPECT_EQ(last.error().first, std::errc::value_too_large);
+    }
+}
+
+TEST(Secs2Message, BuildMsgFromBytesAllocations) {
+    // Strings are long enough to avoid the small string optimization.
+    List sub_list;
+    sub_list.push_back(U4(100, 1));
+    sub_list.push_back(ASCII(100, 'a'));
+
+    List list;
+    list.push_back(sub_list);
+    list.push_back(F8(100, 1));
+    list.push_back(list);
+    list.push_back(I2 {});
+
+    // Each non-empty container is allocated exactly once, without copies.
+    constexpr std::size_t container_count {1 + (1 + 2) + 1 + (1 + (1 + 2) + 1)};
+    const auto bytes {
+        Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto init_alloc_count {alloc_count.load()};
+    const auto loaded {BuildMsgFromBytes(bytes)};
+    EXPECT_EQ(alloc_count.load() - init_alloc_count, container_count);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->first, Message {list});
+}
+
+TEST(Secs2Message, BuildMsgFromBytesWithLimits) {
+    {
+        // A list declaring the maximum number of elements without any of them.
+        constexpr std::array hostile {std::byte {0x03}, std::byte {0xFF},
+                                      std::byte {0xFF}, std::byte {0xFF}};
+        const auto init_alloc_count {alloc_count.load()};
+        const auto loaded {BuildMsgFromBytes(hostile)};
+        EXPECT_EQ(alloc_count.load() - init_alloc_count, 0);
+        ASSERT_FALSE(loaded.has_value());
+        EXPECT_EQ(loaded.error().first, std::errc::message_size);
+    }
+    {
+        List inner;
+        inner.push_back(U1 {1});
+        List middle;
+        middle.push_back(inner);
+        List outer;
+        outer.push_back(middle);
+        const auto bytes {Message {outer}.ToBytes()};
+        ASSERT_TRUE(bytes.has_value());
+        EXPECT_TRUE(BuildMsgFromBytes(*bytes, {.max_depth = 3}).has_value());
+        const auto loaded {BuildMsgFromBytes(*bytes, {.max_depth = 2})};
+        ASSERT_FALSE(loaded.has_value());
+        EXPECT_EQ(loaded.error().first, std::errc::value_too_large);
+    }
+    {
+        // Deep nesting is rejected before it can exhaust the stack.
+        constexpr std::size_t depth {100'000};
+        std::vector<std::byte> bytes;
+        for (std::size_t i {0}; i != depth; ++i) {
+            bytes.push_back(std::byte {0x01});
+            bytes.push_back(std::byte {0x01});
+        }
+
+        bytes.push_back(std::byte {0x01});
+        bytes.push_back(std::byte {0x00});
+        const auto loaded {BuildMsgFromBytes(bytes)};
+        ASSERT_FALSE(loaded.has_value());
+        EXPECT_EQ(loaded.error().first, std::errc::value_too_large);
+        EXPECT_EQ(DecodeBatch(bytes).error().first,
+                  std::errc::value_too_large);
+        EXPECT_EQ(MessageView::BuildFromBytes(bytes).error().first,
+                  std::errc::value_too_large);
+
+        // Messages within the default depth can be viewed and decoded.
+        const auto shallow {
+            std::span {bytes}.last(DecodeOptions {}.max_depth * 2)};
+        const auto view {MessageView::BuildFromBytes(shallow)};
+        ASSERT_TRUE(view.has_value());
+        EXPECT_EQ(view->ToMessage(), BuildMsgFromBytes(shallow)->first);
+    }
+    {
+        List list;
+        list.push_back(U1 {1});
+        list.push_back(U1 {2});
+        list.push_back(U1 {3});
+        const auto bytes {Message {list}.ToBytes()};
+        ASSERT_TRUE(bytes.has_value());
+        EXPECT_TRUE(
+            BuildMsgFromBytes(*bytes, {.max_elem_count = 4}).has_value());
+        EXPECT_EQ(BuildMsgFromBytes(*bytes, {.max_elem_count = 3})
+                      .error()
+                      .first,
+                  std::errc::value_too_large);
+    }
+    {
+        const auto bytes {Message {U4(100, 1)}.ToBytes()};
+        ASSERT_TRUE(bytes.has_value());
+        const auto loaded {
+            Message::BuildFromBytes(*bytes, {.max_alloc_size = 400})};
+        ASSERT_TRUE(loaded.has_value());
+        EXPECT_EQ(loaded->first, Message {U4(100, 1)});
+        EXPECT_EQ(Message::BuildFromBytes(*bytes, {.max_alloc_size = 399})
+                      .error()
+                      .first,
+                  std::errc::value_too_large);
+    }
+}
+
+TEST(Secs2Message, DecodeWithLimits) {
+    constexpr DecodeOptions opts {.max_depth = 64, .max_elem_count = 3};
+    ThreadPool pool {2};
+    const Executor exec {std::ref(pool)};
+    {
+        // Deep nesting is rejected by every entry point.
+        std::vector<std::byte> bytes;
+        for (std::size_t i {0}; i != 100'000; ++i) {
+            bytes.push_back(std::byte {0x01});
+            bytes.push_back(std::byte {0x01});
+        }
+
+        bytes.push_back(std::byte {0x01});
+        bytes.push_back(std::byte {0x00});
+        const DecodeOptions deep {.max_depth = 64};
+        EXPECT_EQ(DecodeParallel(bytes, exec, deep).error().first,
+                  std::errc::value_too_large);
+        EXPECT_EQ(DecodeBatch(bytes, deep).error().first,
+                  std::errc::value_too_large);
+        EXPECT_EQ(Schema<schema::Any>::BuildFromBytes(bytes, deep).error().first,
+                  std::errc::value_too_large);
+        MessageDecoder decoder {deep};
+        EXPECT_EQ(decoder.Feed(bytes).error().first,
+                  std::errc::value_too_large);
+    }
+    {
+        List list;
+        list.push_back(U1 {1});
+        list.push_back(U1 {2});
+        const auto bytes {
+            Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+        EXPECT_TRUE(DecodeParallel(bytes, exec, opts).has_value());
+        EXPECT_TRUE(
+            Schema<schema::ListOf<schema::Any>>::BuildFromBytes(bytes, opts)
+                .has_value());
+        MessageDecoder decoder {opts};
+        EXPECT_EQ(decoder.Feed(bytes), bytes.size());
+        EXPECT_EQ(decoder.TakeMessage()->first, Message {list});
+
+        // Limits are applied to each message of a batch.
+        auto batch {bytes};
+        batch.insert(batch.end(), bytes.begin(), bytes.end());
+        EXPECT_EQ(DecodeBatch(batch, opts)->size(), 2);
+
+        list.push_back(U1 {3});
+        const auto longer {
+            Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+        EXPECT_EQ(DecodeParallel(longer, exec, opts).error().first,
+                  std::errc::value_too_large);
+        EXPECT_EQ(DecodeBatch(longer, opts).error().first,
+                  std::errc::value_too_large);
+        EXPECT_EQ(Schema<schema::ListOf<schema::Any>>::BuildFromBytes(longer,
+                                                                       opts)
+                      .error()
+                      .first,
+                  std::errc::value_too_large);
+        EXPECT_EQ(decoder.Feed(longer).error().first,
+                  std::errc::value_too_large);
+    }
+    {
+        // Each element fits, but the whole message does not.
+        List list;
+        list.push_back(U4(100, 1));
+        list.push_back(U4(100, 2));
+        const auto bytes {
+            Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+        EXPECT_TRUE(DecodeParallel(bytes, exec).has_value());
+        EXPECT_EQ(DecodeParallel(bytes, exec, {.max_alloc_size = 500})
+                      .error()
+                      .first,
+                  std::errc::value_too_large);
+
+        // Elements of schemas share the limit of the whole message.
+        using namespace schema;
+        EXPECT_TRUE(Schema<L<Any, Any>>::BuildFromBytes(bytes).has_value());
+        EXPECT_EQ(Schema<L<Any, Any>>::BuildFromBytes(bytes,
+                                                      {.max_alloc_size = 500})
+                      .error()
+                      .first,
+                  std::errc::value_too_large);
+        EXPECT_EQ(Schema<L<Array<U4>, Array<U4>>>::BuildFromBytes(
+                      bytes, {.max_alloc_size = 500})
+                      .error()
+                      .first,
+                  std::errc::value_too_large);
+    }
+    {
+        // Elements loaded concurrently share the limit of the whole message.
+        constexpr std::size_t limit {250'000};
+        List list;
+        for (std::size_t i {0}; i != 8; ++i) {
+            list.push_back(U1(100'000, static_cast<std::uint8_t>(i)));
+        }
+
+        const auto bytes {
+            Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+        const auto prev_alloc_size {total_alloc_size.load()};
+        EXPECT_EQ(DecodeParallel(bytes, exec, {.max_alloc_size = limit})
+                      .error()
+                      .first,
+                  std::errc::value_too_large);
+        // Besides values, only small bookkeeping is allocated.
+        EXPECT_LT(total_alloc_size - prev_alloc_size, limit + limit / 10);
+    }
+    {
+        // The body of an item is not buffered beyond the limit.
+        const auto bytes {Message {U1(100'000, 1)}.ToBytes()};
+        ASSERT_TRUE(bytes.has_value());
+        MessageDecoder decoder {DecodeOptions {.max_alloc_size = 1'000}};
+        const auto prev_alloc_size {total_alloc_size.load()};
+        EXPECT_EQ(decoder.Feed(std::span {*bytes}.first(10)).error().first,
+                  std::errc::value_too_large);
+        EXPECT_LT(total_alloc_size - prev_alloc_size, 1'000);
+    }
+    {
+        // The elements stored in lists are counted.
+        List list;
+        for (std::size_t i {0}; i != 100; ++i) {
+            list.push_back(U1 {});
+        }
+
+        const auto bytes {Message {list}.ToBytes()};
+        ASSERT_TRUE(bytes.has_value());
+        MessageDecoder decoder {
+            DecodeOptions {.max_alloc_size = 10 * sizeof(ListElem)}};
+        EXPECT_EQ(decoder.Feed(*bytes).error().first,
+                  std::errc::value_too_large);
+        MessageDecoder enough {
+            DecodeOptions {.max_alloc_size = 100 * sizeof(ListElem)}};
+        EXPECT_EQ(enough.Feed(*bytes), bytes->size());
+    }
+}
+
+TEST(Secs2Message, Validate) {
+    List list;
+    list.push_back(U4(100, 1));
+    list.push_back(list);
+    list.push_back(ASCII(100, 'a'));
+    const auto bytes {
+        Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+
+    // It allocates no memory.
+    const auto init_alloc_count {alloc_count.load()};
+    EXPECT_EQ(Message::Validate(bytes), bytes.size());
+    EXPECT_EQ(alloc_count.load(), init_alloc_count);
+
+    // Errors are the same as deserialization.
+    const std::vector<std::vector<std::byte>> invalid_bytes {
+        {},
+        {std::byte {0x05}, std::byte {0x00}},
+        {std::byte {0x00}},
+        {std::byte {0xA9}, std::byte {0x03}, std::byte {0x00},
+         std::byte {0x01}, std::byte {0x02}},
+        {std::byte {0xA5}, std::byte {0x02}, std::byte {0x01}},
+        {std::byte {0x01}, std::byte {0x02}, std::byte {0xA5},
+         std::byte {0x00}},
+        {bytes.begin(), bytes.end() - 1},
+    };
+    for (const auto& invalid : invalid_bytes) {
+        const auto checked {ValidateMsgBytes(invalid)};
+        const auto loaded {BuildMsgFromBytes(invalid)};
+        ASSERT_FALSE(checked.has_value());
+        ASSERT_FALSE(loaded.has_value());
+        EXPECT_EQ(checked.error(), loaded.error());
+    }
+
+    // Deeply nested lists do not overflow the stack.
+    constexpr std::size_t depth {1'000'000};
+    std::vector<std::byte> nested;
+    for (std::size_t i {0}; i != depth; ++i) {
+        nested.push_back(std::byte {0x01});
+        nested.push_back(std::byte {0x01});
+    }
+    nested.push_back(std::byte {0xA5});
+    nested.push_back(std::byte {0x00});
+    EXPECT_EQ(ValidateMsgBytes(nested), nested.size());
+    nested.pop_back();
+    EXPECT_FALSE(ValidateMsgBytes(nested).has_value());
+}
+
+#ifdef SECS2_USE_PMR
+TEST(Secs2Message, BuildMsgFromBytesWithMemoryResource) {
+    List sub_list;
+    sub_list.push_back(U4(100, 1));
+    sub_list.push_back(ASCII(100, 'a'));
+
+    List list;
+    list.push_back(sub_list);
+    list.push_back(F8(100, 1));
+    list.push_back(list);
+    list.push_back(I2 {});
+
+    const auto bytes {
+        Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+
+    // All containers are allocated from the arena without falling back.
+    std::array<std::byte, 0x2000> buffer;
+    std::pmr::monotonic_buffer_resource arena {
+        buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+    const auto init_alloc_count {alloc_count.load()};
+    const auto loaded {BuildMsgFromBytes(bytes, &arena)};
+    EXPECT_EQ(alloc_count.load() - init_alloc_count, 0);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->first, Message {list});
+    EXPECT_EQ(
+        std::get<List>(loaded->first.GetValue()).get_allocator().resource(),
+        &arena);
+
+    MessageDecoder decoder {&arena};
+    ASSERT_TRUE(decoder.Feed(bytes).has_value());
+    const auto decoded {decoder.TakeMessage()};
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->first, Message {list});
+    EXPECT_EQ(
+        std::get<List>(decoded->first.GetValue()).get_allocator().resource(),
+        &arena);
+}
+#endif
+
+#ifdef SECS2_SMALL_VECTOR
+TEST(Secs2Message, BuildMsgFromBytesSmallItems) {
+    List list;
+    list.push_back(U4 {1001});
+    list.push_back(U1 {0});
+    list.push_back(F8 {0.5, 1.5});
+    list.push_back(Binary(16, std::byte {0xFF}));
+    list.push_back(I2(8, -1));
+
+    // Only the list is allocated, as each item fits inline.
+    const auto bytes {
+        Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto init_alloc_count {alloc_count.load()};
+    const auto loaded {BuildMsgFromBytes(bytes)};
+    EXPECT_EQ(alloc_count.load() - init_alloc_count, 1);
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->first, Message {list});
+}
+#endif
+
+TEST(Secs2SmallVector, Inline) {
+    using Vector = container::SmallVector<std::uint32_t, 4>;
+    const auto init_alloc_count {alloc_count.load()};
+    Vector vals {1, 2, 3};
+    vals.push_back(4);
+    EXPECT_EQ(alloc_count.load() - init_alloc_count, 0);
+    EXPECT_EQ(vals.capacity(), Vector::inline_capacity);
+    EXPECT_EQ(vals, (Vector {1, 2, 3, 4}));
+
+    auto moved {std::move(vals)};
+    EXPECT_TRUE(vals.empty());
+    EXPECT_EQ(moved, (Vector {1, 2, 3, 4}));
+    EXPECT_EQ(alloc_count.load() - init_alloc_count, 0);
+}
+
+TEST(Secs2SmallVector, Heap) {
+    using Vector = container::SmallVector<std::uint32_t, 4>;
+    Vector vals(4, 7);
+    vals.push_back(8);
+    EXPECT_GT(vals.capacity(), Vector::inline_capacity);
+    EXPECT_EQ(vals, (Vector {7, 7, 7, 7, 8}));
+
+    // Moving a heap vector transfers its memory.
+    const auto data {vals.data()};
+    auto moved {std::move(vals)};
+    EXPECT_EQ(moved.data(), data);
+    EXPECT_TRUE(vals.empty());
+    EXPECT_EQ(vals.capacity(), Vector::inline_capacity);
+
+    auto copied {moved};
+    EXPECT_NE(copied.data(), moved.data());
+    EXPECT_EQ(copied, moved);
+
+    copied.erase(copied.begin() + 1, copied.begin() + 4);
+    EXPECT_EQ(copied, (Vector {7, 8}));
+    copied.insert(copied.begin() + 1, {1, 2});
+    EXPECT_EQ(copied, (Vector {7, 1, 2, 8}));
+    copied.shrink_to_fit();
+    EXPECT_EQ(copied.capacity(), Vector::inline_capacity);
+    EXPECT_EQ(copied, (Vector {7, 1, 2, 8}));
+
+    copied.resize(6);
+    EXPECT_EQ(copied, (Vector {7, 1, 2, 8, 0, 0}));
+    EXPECT_LT(copied, moved);
+}
+
+TEST(Secs2SmallVector, PushOwnElem) {
+    using Vector = container::SmallVector<std::uint32_t, 4>;
+    // Growing from inline storage to the heap.
+    Vector vals {0xAABBCCDD, 2, 3, 4};
+    ASSERT_EQ(vals.size(), vals.capacity());
+    vals.push_back(vals[0]);
+    EXPECT_EQ(vals, (Vector {0xAABBCCDD, 2, 3, 4, 0xAABBCCDD}));
+
+    // Growing from one heap allocation to another.
+    while (vals.size() != vals.capacity()) {
+        vals.push_back(5);
+    }
+
+    const auto size {vals.size()};
+    vals.emplace_back(vals[1]);
+    ASSERT_EQ(vals.size(), size + 1);
+    EXPECT_EQ(vals.back(), 2);
+
+    vals.insert(vals.begin(), vals.back());
+    EXPECT_EQ(vals.front(), 2);
+
+    Vector resized {0xAABBCCDD};
+    resized.resize(Vector::inline_capacity * 4, resized[0]);
+    EXPECT_EQ(resized, Vector(Vector::inline_capacity * 4, 0xAABBCCDD));
+
+    // Inserting a range of its own elements.
+    Vector inserted {1, 2, 3, 4};
+    ASSERT_EQ(inserted.size(), inserted.capacity());
+    inserted.insert(inserted.begin() + 1, inserted.begin(), inserted.end());
+    EXPECT_EQ(inserted, (Vector {1, 1, 2, 3, 4, 2, 3, 4}));
+    inserted.insert(inserted.begin(), inserted.end() - 2, inserted.end());
+    EXPECT_EQ(inserted, (Vector {3, 4, 1, 1, 2, 3, 4, 2, 3, 4}));
+}
+
+TEST(Secs2Message, BooleanRoundTrip) {
+#ifdef SECS2_COMPACT_BOOLEAN
+    static_assert(std::ranges::contiguous_range<Boolean>);
+#endif
+
+    // Any non-zero byte is deserialized as true and serialized as 0x01.
+    const std::vector<std::byte> bytes {std::byte {0b001001'01},
+                                        std::byte {3}, std::byte {0x02},
+                                        std::byte {0x00}, std::byte {0xFF}};
+    const auto loaded {BuildMsgFromBytes(bytes)};
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->second, bytes.size());
+    EXPECT_EQ(loaded->first.GetValue<Boolean>(),
+              (Boolean {true, false, true}));
+
+    const std::vector<std::byte> normalized {
+        std::byte {0b001001'01}, std::byte {3}, std::byte {0x01},
+        std::byte {0x00}, std::byte {0x01}};
+    EXPECT_EQ(loaded->first.ToBytes(), normalized);
+
+    const auto view {MessageView::BuildFromBytes(bytes)};
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(view->GetRoot().GetElemValue<Boolean>(0), true);
+    EXPECT_EQ(view->GetRoot().GetElemValue<Boolean>(1), false);
+}
+
+TEST(Secs2Message, BulkNumericRoundTrip) {
+    const auto round_trip {[]<typename T>(const T& nums) {
+        using Value = std::ranges::range_value_t<T>;
+        const auto bytes {
+            Message {nums}.ToBytes().value_or(std::vector<std::byte> {})};
+        ASSERT_EQ(bytes.size(), 3 + nums.size() * sizeof(Value));
+        for (std::size_t i {0}; i != nums.size(); ++i) {
+            Value val;
+            bit::ReadBytes(std::span {bytes}.subspan(3 + i * sizeof(Value)),
+                           val, std::endian::big);
+            ASSERT_EQ(val, nums[i]);
+        }
+
+        const auto loaded {BuildMsgFromBytes(bytes)};
+        ASSERT_TRUE(loaded.has_value());
+        EXPECT_EQ(loaded->first, Message {nums});
+    }};
+
+    // An odd number of elements covers both vectorized blocks and the scalar tail.
+    constexpr std::size_t count {1001};
+    const auto make_nums {[]<typename T>(std::type_identity<T>) {
+        using Value = std::ranges::range_value_t<T>;
+        T nums;
+        for (std::size_t i {0}; i != count; ++i) {
+            nums.push_back(static_cast<Value>(i * 0x01020304050607 + 1));
+        }
+        return nums;
+    }};
+
+    round_trip(make_nums(std::type_identity<I2> {}));
+    round_trip(make_nums(std::type_identity<I4> {}));
+    round_trip(make_nums(std::type_identity<I8> {}));
+    round_trip(make_nums(std::type_identity<U2> {}));
+    round_trip(make_nums(std::type_identity<U4> {}));
+    round_trip(make_nums(std::type_identity<U8> {}));
+    round_trip(make_nums(std::type_identity<F4> {}));
+    round_trip(make_nums(std::type_identity<F8> {}));
+}
+
+TEST(Secs2Batch, EncodeBatch) {
+    List list;
+    list.push_back(U2 {1, 2});
+    list.push_back(ASCII {"hello"});
+    const std::vector msgs {Message {list}, Message {Boolean {true}},
+                            Message {List {}}, Message {Binary {}}};
+
+    const auto batch {EncodeBatch(msgs)};
+    ASSERT_TRUE(batch.has_value());
+    ASSERT_EQ(batch->GetCount(), msgs.size());
+    std::vector<std::byte> bytes;
+    for (std::size_t i {0}; i != msgs.size(); ++i) {
+        const auto msg_bytes {msgs[i].ToBytes()};
+        ASSERT_TRUE(msg_bytes.has_value());
+        EXPECT_EQ(batch->offsets[i], bytes.size());
+        EXPECT_TRUE(std::ranges::equal(batch->GetMsgBytes(i), *msg_bytes));
+        bytes.insert(bytes.end(), msg_bytes->begin(), msg_bytes->end());
+    }
+    EXPECT_EQ(batch->bytes, bytes);
+
+    // The memory of an existing batch is reused.
+    auto reused {*batch};
+    const auto data {reused.bytes.data()};
+    EXPECT_EQ(EncodeBatchInto(std::span {msgs}.first(2), reused),
+              batch->offsets[2]);
+    EXPECT_EQ(reused.GetCount(), 2);
+    EXPECT_EQ(reused.bytes.data(), data);
+
+    EXPECT_EQ(EncodeBatch({})->GetCount(), 0);
+
+    const std::vector too_long {Message {U1 {}},
+                                Message {Binary(Message::max_length + 1)}};
+    const auto failed {EncodeBatch(too_long)};
+    ASSERT_FALSE(failed.has_value());
+    EXPECT_EQ(failed.error().first, std::errc::value_too_large);
+}
+
+TEST(Secs2Batch, DecodeBatch) {
+    List list;
+    list.push_back(I4 {-1});
+    list.push_back(List {});
+    const std::vector msgs {Message {list}, Message {ASCII {"a"}},
+                            Message {F8 {0.5, 1.5}}};
+
+    const auto batch {EncodeBatch(msgs)};
+    ASSERT_TRUE(batch.has_value());
+    EXPECT_EQ(DecodeBatch(batch->bytes), msgs);
+    EXPECT_EQ(DecodeBatch({}), std::vector<Message> {});
+
+    std::vector prefix {Message {U1 {1}}};
+    EXPECT_EQ(DecodeBatchInto(batch->bytes, prefix), batch->bytes.size());
+    ASSERT_EQ(prefix.size(), msgs.size() + 1);
+    EXPECT_TRUE(std::ranges::equal(std::span {prefix}.subspan(1), msgs));
+
+    // The vector is left unchanged if any message is invalid.
+    std::vector<Message> loaded;
+    const auto failed {DecodeBatchInto(
+        std::span {batch->bytes}.first(batch->bytes.size() - 1), loaded)};
+    ASSERT_FALSE(failed.has_value());
+    EXPECT_EQ(failed.error().first, std::errc::message_size);
+    EXPECT_TRUE(loaded.empty());
+
+#ifdef SECS2_USE_PMR
+    std::pmr::monotonic_buffer_resource arena;
+    std::vector<Message> arena_msgs;
+    EXPECT_EQ(DecodeBatchInto(batch->bytes, arena_msgs, &arena),
+              batch->bytes.size());
+    EXPECT_EQ(arena_msgs, msgs);
+#endif
+}
+
+TEST(Secs2Parallel, ThreadPool) {
+    ThreadPool pool {3};
+    EXPECT_EQ(pool.GetThreadCount(), 3);
+
+    std::vector<std::atomic<std::size_t>> counts(1000);
+    for (std::size_t round {0}; round != 10; ++round) {
+        pool(counts.size(), [&counts](const std::size_t i) { ++counts[i]; });
+    }
+    EXPECT_TRUE(std::ranges::all_of(
+        counts, [](const auto& count) { return count == 10; }));
+
+    // It runs tasks on the calling thread only if it has no worker thread.
+    ThreadPool empty_pool {0};
+    std::size_t sum {0};
+    empty_pool(4, [&sum](const std::size_t i) { sum += i; });
+    EXPECT_EQ(sum, 6);
+
+    // Calls from inside a task are run on the calling thread.
+    std::vector<std::atomic<std::size_t>> nested_counts(8);
+    pool(nested_counts.size(), [&pool, &nested_counts](const std::size_t i) {
+        pool(4, [&nested_counts, i](std::size_t) { ++nested_counts[i]; });
+    });
+    EXPECT_TRUE(std::ranges::all_of(
+        nested_counts, [](const auto& count) { return count == 4; }));
+}
+
+TEST(Secs2Parallel, EncodeAndDecode) {
+    List sub_list;
+    sub_list.push_back(U4 {1, 2});
+    sub_list.push_back(List {});
+
+    List list;
+    for (std::size_t i {0}; i != 300; ++i) {
+        if (i % 3 == 0) {
+            list.push_back(sub_list);
+        } else if (i % 3 == 1) {
+            list.push_back(ASCII {std::to_string(i)});
+        } else {
+            list.push_back(F8(i, 0.5));
+        }
+    }
+
+    ThreadPool pool {4};
+    const Executor exec {std::ref(pool)};
+    for (const auto& msg : {Message {list}, Message {List {}}, Message {U1 {1}},
+                            Message {sub_list}}) {
+        const auto bytes {EncodeParallel(msg, exec)};
+        ASSERT_TRUE(bytes.has_value());
+        EXPECT_EQ(bytes, msg.ToBytes());
+
+        const auto loaded {DecodeParallel(*bytes, exec)};
+        ASSERT_TRUE(loaded.has_value());
+        EXPECT_EQ(loaded->first, msg);
+        EXPECT_EQ(loaded->second, bytes->size());
+    }
+
+    const auto bytes {
+        Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto loaded {
+        DecodeParallel(std::span {bytes}.first(bytes.size() - 1), exec)};
+    ASSERT_FALSE(loaded.has_value());
+    EXPECT_EQ(loaded.error().first, std::errc::message_size);
+
+    // A huge declared length must not be trusted before elements are read.
+    const std::vector<std::byte> huge_list {
+        static_cast<std::byte>(0b000000'11), static_cast<std::byte>(0xFF),
+        static_cast<std::byte>(0xFF), static_cast<std::byte>(0xFF)};
+    max_alloc_size = 0;
+    EXPECT_EQ(DecodeParallel(huge_list, exec).error().first,
+              std::errc::message_size);
+    EXPECT_LT(max_alloc_size.load(), 1024);
+
+    List too_long;
+    too_long.push_back(Binary(Message::max_length + 1));
+    EXPECT_EQ(EncodeParallel(Message {too_long}, exec), std::nullopt);
+}
+
+TEST(Secs2MessageIndex, Build) {
+    List sub_list;
+    sub_list.push_back(U1 {1, 2});
+    sub_list.push_back(List {});
+    sub_list.push_back(ASCII {"abc"});
+
+    List list;
+    list.push_back(I4 {-1});
+    list.push_back(sub_list);
+    list.push_back(F8 {0.5});
+    const auto bytes {
+        Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+
+    const auto index {MessageIndex::Build(bytes)};
+    ASSERT_TRUE(index.has_value());
+    EXPECT_EQ(index->GetByteSize(), bytes.size());
+
+    // Nodes are in pre-order.
+    const auto nodes {index->GetNodes()};
+    ASSERT_EQ(nodes.size(), 7);
+    const std::array types {Type::List, Type::I4,    Type::List, Type::U1,
+                            Type::List, Type::ASCII, Type::F8};
+    const std::array<std::size_t, 7> ends {7, 2, 6, 4, 5, 6, 7};
+    for (std::size_t i {0}; i != nodes.size(); ++i) {
+        EXPECT_EQ(nodes[i].type, types[i]);
+        EXPECT_EQ(nodes[i].end, ends[i]);
+        EXPECT_EQ(Message::Validate(std::span {bytes}.subspan(nodes[i].offset)),
+                  nodes[i].byte_size);
+        EXPECT_EQ(ReadMsgHeader(std::span {bytes}.subspan(nodes[i].offset))
+                      .transform([](const MsgHeader& header) {
+                          return header.size;
+                      }),
+                  nodes[i].header_size);
+    }
+
+    EXPECT_EQ(nodes[2].len, 3);
+    EXPECT_EQ(nodes[3].len, 2);
+    EXPECT_EQ(nodes[2].byte_size, Message {sub_list}.GetEncodedSize());
+
+    EXPECT_EQ(index->GetElem(0, 2), 6);
+    EXPECT_EQ(index->GetElem(2, 2), 5);
+    EXPECT_EQ(index->GetElem(0, 3), std::nullopt);
+    EXPECT_EQ(index->GetElem(1, 0), std::nullopt);
+
+    constexpr std::array<std::size_t, 2> path {1, 2};
+    EXPECT_EQ(index->Find(path), 5);
+    EXPECT_EQ(index->Find({}), 0);
+    constexpr std::array<std::size_t, 3> missing_path {1, 0, 0};
+    EXPECT_EQ(index->Find(missing_path), std::nullopt);
+
+    const auto item_index {MessageIndex::Build(
+        Message {U2 {1}}.ToBytes().value_or(std::vector<std::byte> {}))};
+    ASSERT_TRUE(item_index.has_value());
+    ASSERT_EQ(item_index->GetNodes().size(), 1);
+    EXPECT_EQ(item_index->GetByteSize(), 4);
+
+    const auto invalid {
+        MessageIndex::Build(std::span {bytes}.first(bytes.size() - 1))};
+    ASSERT_FALSE(invalid.has_value());
+    EXPECT_EQ(invalid.error().first, std::errc::message_size);
+}
+
+TEST(Secs2MessageIndex, Extract) {
+    List report;
+    report.push_back(U4 {10});
+    report.push_back(List {});
+    report.push_back(ASCII {"lot"});
+
+    List list;
+    list.push_back(U4 {1});
+    list.push_back(U4 {4001});
+    list.push_back(report);
+    const auto bytes {
+        Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+
+    EXPECT_EQ(Extract<U4>(bytes, {1}), U4 {4001});
+    EXPECT_EQ(Extract<U4>(bytes, {2, 0}), U4 {10});
+    EXPECT_EQ(Extract<ASCII>(bytes, {2, 2}), ASCII {"lot"});
+    EXPECT_EQ(Extract<List>(bytes, {2, 1}), List {});
+    EXPECT_EQ(Extract<List>(bytes, {}), list);
+
+    const auto elem_bytes {
+        FindElemBytes(bytes, std::array<std::size_t, 1> {2})};
+    ASSERT_TRUE(elem_bytes.has_value());
+    const auto report_size {Message {report}.GetEncodedSize().value_or(0)};
+    EXPECT_EQ(elem_bytes->data(), bytes.data() + bytes.size() - report_size);
+
+    const auto expect_error {[](const auto& extracted, const std::errc code) {
+        ASSERT_FALSE(extracted.has_value());
+        EXPECT_EQ(extracted.error().first, code);
+    }};
+
+    expect_error(Extract<U2>(bytes, {1}), std::errc::invalid_argument);
+    expect_error(Extract<U4>(bytes, {3}), std::errc::result_out_of_range);
+    expect_error(Extract<U4>(bytes, {0, 0}), std::errc::result_out_of_range);
+    expect_error(Extract<ASCII>(std::span {bytes}.first(bytes.size() - 1),
+                                {2, 2}),
+                 std::errc::message_size);
+}
+
+TEST(Secs2Codec, HeaderAndScalar) {
+    static_assert(codec::CalcHeaderSize(0xFF) == 2);
+    static_assert(codec::CalcHeaderSize(0x100) == 3);
+    static_assert(codec::CalcHeaderSize(Message::max_length) == 4);
+    static_assert(!codec::CalcHeaderSize(Message::max_length + 1).has_value());
+
+    // The same bytes as serializing a message.
+    const auto bytes {Message {U2(0x100, 0x0102)}.ToBytes()};
+    ASSERT_TRUE(bytes.has_value());
+    std::array<std::byte, codec::max_header_size> header {};
+    const auto header_size {codec::WriteHeader(Type::U2, 0x200, header)};
+    EXPECT_TRUE(std::ranges::equal(std::span {header}.first(header_size),
+                                   std::span {*bytes}.first(header_size)));
+    EXPECT_EQ(codec::LoadScalar<std::uint16_t>(
+                  std::span {*bytes}.subspan(header_size)),
+              0x0102);
+
+    static_assert([] {
+        std::array<std::byte, sizeof(double)> buf {};
+        codec::StoreScalar(-1.5, buf);
+        return codec::LoadScalar<double>(buf) == -1.5;
+    }());
+}
+
+TEST(Secs2Schema, ToBytes) {
+    using namespace schema;
+    {
+        // S1F13: L[2] <A MDLN> <A SOFTREV>
+        using S1F13 = Schema<L<A, A>>;
+        static_assert(!S1F13::fixed_size.has_value());
+        static_assert(S1F13::min_size == 2 + 2 + 2);
+
+        List list;
+        list.push_back(ASCII {"MDLN-A"});
+        list.push_back(ASCII {"1.0.0"});
+        const auto expected {Message {list}.ToBytes()};
+        EXPECT_EQ(S1F13::ToBytes({"MDLN-A", "1.0.0"}), expected);
+        EXPECT_EQ(S1F13::GetEncodedSize({"MDLN-A", "1.0.0"}),
+                  expected->size());
+
+        // Any tuple-like value can be serialized, such as references to fields.
+        const std::string mdln {"MDLN-A"};
+        EXPECT_EQ(S1F13::ToBytes(std::tie(mdln, "1.0.0")), expected);
+    }
+    {
+        using Report = Schema<L<Scalar<U4>, ListOf<Scalar<U2>>, Array<F8>, Any>>;
+
+        List ids;
+        ids.push_back(U2 {1});
+        ids.push_back(U2 {2});
+        List list;
+        list.push_back(U4 {4001});
+        list.push_back(ids);
+        list.push_back(F8 {0.5, -1.5});
+        list.push_back(Binary {std::byte {0xAB}});
+        const auto expected {Message {list}.ToBytes()};
+
+        const Report::Value val {4001, {1, 2}, {0.5, -1.5},
+                                 Binary {std::byte {0xAB}}};
+        const auto bytes {Report::ToBytes(val)};
+        EXPECT_EQ(bytes, expected);
+
+        std::vector<std::byte> buf(bytes->size() - 1);
+        const auto failed {Report::SerializeInto(val, buf)};
+        ASSERT_FALSE(failed.has_value());
+        EXPECT_EQ(failed.error().first, std::errc::no_buffer_space);
+        buf.resize(bytes->size());
+        EXPECT_EQ(Report::SerializeInto(val, buf), bytes->size());
+        EXPECT_EQ(buf, *bytes);
+    }
+    {
+        using Ack = Schema<L<Scalar<U1>, Scalar<Boolean>>>;
+        static_assert(Ack::fixed_size == 2 + 3 + 3);
+        static_assert(Ack::min_size == *Ack::fixed_size);
+
+        List list;
+        list.push_back(U1 {0});
+        list.push_back(Boolean {true});
+        EXPECT_EQ(Ack::ToBytes({0, true}), Message {list}.ToBytes());
+    }
+    {
+        using Bin = Schema<B>;
+        const std::vector<std::byte> too_long(Message::max_length + 1);
+        EXPECT_FALSE(Bin::ToBytes(too_long).has_value());
+        EXPECT_EQ(Bin::SerializeInto(too_long, {}).error().first,
+                  std::errc::value_too_large);
+    }
+}
+
+TEST(Secs2Schema, BuildFromBytes) {
+    using namespace schema;
+    using Report = Schema<L<Scalar<U4>, ListOf<A>, Array<I2>, Any>>;
+
+    List names;
+    names.push_back(ASCII {"a"});
+    names.push_back(ASCII {"bc"});
+    List list;
+    list.push_back(U4 {4001});
+    list.push_back(names);
+    list.push_back(I2 {-1, 2});
+    list.push_back(List {});
+    const auto bytes {
+        Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+
+    const auto loaded {Report::BuildFromBytes(bytes)};
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(loaded->second, bytes.size());
+    const auto& [ceid, ids, vals, any] {loaded->first};
+    EXPECT_EQ(ceid, 4001);
+    EXPECT_EQ(ids, (std::vector<ASCII> {"a", "bc"}));
+    EXPECT_EQ(vals, (I2 {-1, 2}));
+    EXPECT_EQ(any, Message::Value {List {}});
+
+    // Values can be decoded into plain structures.
+    struct Event {
+        std::uint32_t ceid;
+        std::vector<ASCII> names;
+        I2 vals;
+        Message::Value any;
+    };
+
+    const auto event {std::make_from_tuple<Event>(loaded->first)};
+    EXPECT_EQ(event.names.size(), 2);
+
+    // A header with more length bytes than required is also accepted.
+    EXPECT_EQ(Schema<Scalar<U1>>::BuildFromBytes(std::vector {
+                  std::byte {0b101001'10}, std::byte {0}, std::byte {1},
+                  std::byte {7}}),
+              std::pair(std::uint8_t {7}, std::size_t {4}));
+}
+
+TEST(Secs2Schema, BuildFromMismatchedBytes) {
+    using namespace schema;
+    {
+        const auto bytes {
+            Message {U2 {1}}.ToBytes().value_or(std::vector<std::byte> {})};
+        const auto loaded {Schema<Scalar<U4>>::BuildFromBytes(bytes)};
+        ASSERT_FALSE(loaded.has_value());
+        EXPECT_EQ(loaded.error().first, std::errc::invalid_argument);
+    }
+    {
+        const auto bytes {
+            Message {U4 {1, 2}}.ToBytes().value_or(std::vector<std::byte> {})};
+        const auto loaded {Schema<Scalar<U4>>::BuildFromBytes(bytes)};
+        ASSERT_FALSE(loaded.has_value());
+        EXPECT_EQ(loaded.error().first, std::errc::invalid_argument);
+        EXPECT_TRUE(Schema<Array<U4>>::BuildFromBytes(bytes).has_value());
+    }
+    {
+        List list;
+        list.push_back(ASCII {"a"});
+        const auto bytes {
+            Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+        const auto loaded {Schema<L<A, A>>::BuildFromBytes(bytes)};
+        ASSERT_FALSE(loaded.has_value());
+        EXPECT_EQ(loaded.error().first, std::errc::invalid_argument);
+
+        // Unknown shapes can still be deserialized dynamically.
+        EXPECT_EQ(Schema<Any>::BuildFromBytes(bytes)->first,
+                  Message {list}.GetValue());
+        EXPECT_EQ(Schema<ListOf<A>>::BuildFromBytes(bytes)->first,
+                  std::vector<ASCII> {"a"});
+    }
+    {
+        const auto bytes {Schema<L<A, A>>::ToBytes({"a", "b"}).value_or(
+            std::vector<std::byte> {})};
+        const auto loaded {Schema<L<A, A>>::BuildFromBytes(
+            std::span {bytes}.first(bytes.size() - 1))};
+        ASSERT_FALSE(loaded.has_value());
+        EXPECT_EQ(loaded.error().first, std::errc::message_size);
+    }
+    {
+        // A huge declared length reserves at most one element
+        // per smallest encoding of an element.
+        using Pairs = ListOf<L<A, A>>;
+        static_assert(L<A, A>::min_size == 6);
+        std::vector<std::byte> bytes(1024);
+        bytes[0] = static_cast<std::byte>(0b000000'11);
+        std::fill_n(bytes.begin() + 1, 3, static_cast<std::byte>(0xFF));
+        max_alloc_size = 0;
+        EXPECT_FALSE(Schema<Pairs>::BuildFromBytes(bytes).has_value());
+        EXPECT_LE(max_alloc_size.load(),
+                  bytes.size() / L<A, A>::min_size
+                      * sizeof(Pairs::Value::value_type));
+    }
+}
+
+TEST(Secs2MessageTemplate, Fill) {
+    const auto make_bytes {[](const std::uint32_t svid, ASCII status,
+                              const bool online, const float rate) {
+        List list;
+        list.push_back(U4 {svid});
+        list.push_back(List {});
+        list.push_back(std::move(status));
+        list.push_back(Boolean {online});
+        list.push_back(F4 {rate});
+        return Message {std::move(list)}.ToBytes().value_or(
+            std::vector<std::byte> {});
+    }};
+
+    auto tmpl {MessageTemplate::BuildFromBytes(
+        make_bytes(1, "IDLE", false, 0.5F))};
+    ASSERT_TRUE(tmpl.has_value());
+    const auto svid {tmpl->AddSlot({0})};
+    const auto status {tmpl->AddSlot({2})};
+    const auto online {tmpl->AddSlot({3})};
+    const auto rate {tmpl->AddSlot({4})};
+    ASSERT_TRUE(svid.has_value() && status.has_value() && online.has_value()
+                && rate.has_value());
+    EXPECT_EQ(tmpl->GetSlotCount(), 4);
+
+    // Values of the same length are overwritten in place.
+    const auto data {tmpl->GetBytes().data()};
+    EXPECT_TRUE(tmpl->Fill<U4>(*svid, 1001).has_value());
+    EXPECT_TRUE(tmpl->FillAscii(*status, "BUSY").has_value());
+    EXPECT_TRUE(tmpl->FillBoolean(*online, true).has_value());
+    EXPECT_EQ(tmpl->GetBytes().data(), data);
+    EXPECT_TRUE(std::ranges::equal(tmpl->GetBytes(),
+                                   make_bytes(1001, "BUSY", true, 0.5F)));
+
+    // Values of different lengths get new headers and later slots are moved.
+    const ASCII long_status(300, 'a');
+    EXPECT_TRUE(tmpl->FillAscii(*status, long_status).has_value());
+    EXPECT_TRUE(tmpl->Fill(*rate, F4 {1.5F}).has_value());
+    EXPECT_TRUE(std::ranges::equal(tmpl->GetBytes(),
+                                   make_bytes(1001, long_status, true, 1.5F)));
+
+    EXPECT_TRUE(tmpl->FillAscii(*status, "").has_value());
+    EXPECT_TRUE(tmpl->Fill<U4>(*svid, std::vector<std::uint32_t> {1, 2})
+                    .has_value());
+    const auto loaded {Message::BuildFromBytes(tmpl->GetBytes())};
+    ASSERT_TRUE(loaded.has_value());
+    EXPECT_EQ(*loaded->first.FindElem({0}), (Message::Value {U4 {1, 2}}));
+    EXPECT_EQ(*loaded->first.FindElem({2}), Message::Value {ASCII {}});
+    EXPECT_EQ(*loaded->first.FindElem({4}), Message::Value {F4 {1.5F}});
+
+    // Adding a slot for the same item again returns the existing slot.
+    EXPECT_EQ(tmpl->AddSlot({2}), status);
+    EXPECT_EQ(tmpl->GetSlotCount(), 4);
+    EXPECT_TRUE(tmpl->FillAscii(*tmpl->AddSlot({2}), long_status).has_value());
+    EXPECT_TRUE(tmpl->FillAscii(*status, "IDLE").has_value());
+    EXPECT_TRUE(tmpl->Fill<U4>(*svid, 1).has_value());
+    EXPECT_TRUE(std::ranges::equal(tmpl->GetBytes(),
+                                   make_bytes(1, "IDLE", true, 1.5F)));
+}
+
+TEST(Secs2MessageTemplate, FillInvalidValues) {
+    List list;
+    list.push_back(U1 {0});
+    list.push_back(List {});
+    auto tmpl {MessageTemplate::Build(Message {list})};
+    ASSERT_TRUE(tmpl.has_value());
+
+    const auto list_slot {tmpl->AddSlot({1})};
+    ASSERT_FALSE(list_slot.has_value());
+    EXPECT_EQ(list_slot.error().first, std::errc::invalid_argument);
+    EXPECT_EQ(tmpl->AddSlot({2}).error().first, std::errc::result_out_of_range);
+
+    const auto ack {tmpl->AddSlot({0})};
+    ASSERT_TRUE(ack.has_value());
+    const auto bytes {Message {list}.ToBytes()};
+    EXPECT_EQ(tmpl->Fill<U2>(*ack, 1).error().first,
+              std::errc::invalid_argument);
+    EXPECT_EQ(tmpl->Fill(*ack, Binary(Message::max_length + 1)).error().first,
+              std::errc::invalid_argument);
+    EXPECT_EQ(
+        tmpl->Fill<U1>(*ack, std::vector<std::uint8_t>(Message::max_length + 1))
+            .error()
+            .first,
+        std::errc::value_too_large);
+    EXPECT_EQ(tmpl->Fill<U1>(tmpl->GetSlotCount(), 1).error().first,
+              std::errc::invalid_argument);
+    EXPECT_TRUE(std::ranges::equal(tmpl->GetBytes(), *bytes));
+
+    const auto copied {MessageTemplate::BuildFromBytes(*bytes)};
+    ASSERT_TRUE(copied.has_value());
+    EXPECT_TRUE(std::ranges::equal(copied->GetBytes(), *bytes));
+    EXPECT_EQ(MessageTemplate::BuildFromBytes(std::span {*bytes}.first(1))
+                  .error()
+                  .first,
+              std::errc::message_size);
+}
+
+TEST(Secs2EncodedMessage, ToBytes) {
+    List list;
+    list.push_back(U1 {1});
+    list.push_back(ASCII {"ok"});
+    const Message msg {list};
+    const auto expected {msg.ToBytes()};
+    ASSERT_TRUE(expected.has_value());
+
+    const EncodedMessage encoded {msg};
+    EXPECT_EQ(encoded.GetMessage(), msg);
+    EXPECT_EQ(encoded.GetEncodedSize(), expected->size());
+    const auto bytes {encoded.ToBytes()};
+    ASSERT_TRUE(bytes.has_value());
+    EXPECT_TRUE(std::ranges::equal(*bytes, *expected));
+
+    std::vector<std::byte> buf(expected->size());
+    const auto init_alloc_count {alloc_count.load()};
+    const auto again {encoded.ToBytes()};
+    EXPECT_EQ(encoded.SerializeInto(buf), expected->size());
+    EXPECT_EQ(alloc_count.load() - init_alloc_count, 0);
+    EXPECT_EQ(again->data(), bytes->data());
+    EXPECT_EQ(buf, *expected);
+
+    std::vector<std::byte> sunk;
+    EXPECT_EQ(encoded.SerializeInto(
+                  [&sunk](const std::span<const std::byte> chunk) {
+                      sunk.insert(sunk.end(), chunk.begin(), chunk.end());
+                  }),
+              expected->size());
+    EXPECT_EQ(sunk, *expected);
+    EXPECT_EQ(encoded.SerializeInto(std::span {buf}.first(1)).error().first,
+              std::errc::no_buffer_space);
+
+    // Concurrent calls share the same bytes.
+    ThreadPool pool {4};
+    const EncodedMessage shared {msg};
+    std::vector<const std::byte*> datas(16);
+    pool(datas.size(), [&shared, &datas](const std::size_t i) noexcept {
+        datas[i] = shared.ToBytes()->data();
+    });
+    EXPECT_EQ(std::ranges::count(datas, datas.front()), datas.size());
+
+    const EncodedMessage oversized {Message {U1(Message::max_length + 1, 0)}};
+    EXPECT_FALSE(oversized.GetEncodedSize().has_value());
+    EXPECT_FALSE(oversized.ToBytes().has_value());
+    EXPECT_EQ(oversized.SerializeInto(buf).error().first,
+              std::errc::value_too_large);
+}
+
+TEST(Secs2EncodedMessage, Swap) {
+    const Message first {U1 {1}};
+    Message second {ASCII {"second"}};
+    EncodedMessage encoded {first};
+    ASSERT_TRUE(encoded.ToBytes().has_value());
+
+    encoded.swap(second);
+    EXPECT_EQ(second, first);
+    EXPECT_EQ(encoded.GetMessage(), Message {ASCII {"second"}});
+    EXPECT_EQ(encoded.GetEncodedSize(),
+              Message {ASCII {"second"}}.GetEncodedSize());
+    EXPECT_TRUE(std::ranges::equal(*encoded.ToBytes(),
+                                   *Message {ASCII {"second"}}.ToBytes()));
+
+    EncodedMessage other {first};
+    swap(encoded, other);
+    EXPECT_EQ(encoded.GetMessage(), first);
+    EXPECT_TRUE(std::ranges::equal(*encoded.ToBytes(), *first.ToBytes()));
+    EXPECT_TRUE(std::ranges::equal(*other.ToBytes(),
+                                   *Message {ASCII {"second"}}.ToBytes()));
+}
+
+TEST(Secs2Hash, HashMsg) {
+    List inner;
+    inner.push_back(F4 {-0.0F, 1.5F});
+    inner.push_back(Boolean {true, false});
+    List list;
+    list.push_back(ASCII {"LOT-1"});
+    list.push_back(std::move(inner));
+    list.push_back(U4 {1, 2});
+    const Message msg {list};
+    const auto bytes {msg.ToBytes()};
+    ASSERT_TRUE(bytes.has_value());
+    EXPECT_EQ(HashMsgBytes(*bytes), HashMsg(msg));
+    EXPECT_EQ(HashMsg(msg), std::hash<Message> {}(msg));
+
+    EXPECT_EQ(Message {F8 {-0.0}}, Message {F8 {0.0}});
+    EXPECT_EQ(HashMsg(Message {F8 {-0.0}}), HashMsg(Message {F8 {0.0}}));
+    EXPECT_EQ(HashMsgBytes(*Message {F8 {-0.0}}.ToBytes()),
+              HashMsg(Message {F8 {0.0}}));
+
+    EXPECT_NE(HashMsg(Message {U4 {1}}), HashMsg(Message {I4 {1}}));
+    EXPECT_NE(HashMsg(Message {U1 {1, 2}}), HashMsg(Message {U1 {2, 1}}));
+    EXPECT_NE(HashMsg(Message {List {}}), HashMsg(Message {ASCII {}}));
+    List nested;
+    nested.push_back(List {});
+    List flat;
+    flat.push_back(List {});
+    flat.push_back(List {});
+    EXPECT_NE(HashMsg(Message {nested}), HashMsg(Message {flat}));
+
+    std::unordered_set<Message> msgs {msg, Message {U1 {1}}};
+    EXPECT_TRUE(msgs.contains(msg));
+    EXPECT_FALSE(msgs.insert(Message {U1 {1}}).second);
+    EXPECT_FALSE(msgs.contains(Message {U1 {2}}));
+}
+
+TEST(Secs2Hash, EqualMsgBytes) {
+    static_assert(static_cast<std::uint8_t>(Type::U1) == 0b101001);
+
+    const auto bytes {Message {U1 {7}}.ToBytes()};
+    ASSERT_TRUE(bytes.has_value());
+    // The length is encoded with two bytes rather than one.
+    const std::vector<std::byte> longer {static_cast<std::byte>(0b101001'10),
+                                         static_cast<std::byte>(0),
+                                         static_cast<std::byte>(1),
+                                         static_cast<std::byte>(7)};
+    EXPECT_EQ(EqualMsgBytes(*bytes, longer), true);
+    EXPECT_EQ(HashMsgBytes(longer), HashMsgBytes(*bytes));
+
+    EXPECT_EQ(EqualMsgBytes(*Message {F4 {-0.0F}}.ToBytes(),
+                            *Message {F4 {0.0F}}.ToBytes()),
+              true);
+    const Message nan {F8 {std::numeric_limits<double>::quiet_NaN()}};
+    EXPECT_EQ(EqualMsgBytes(*nan.ToBytes(), *nan.ToBytes()), nan == nan);
+    EXPECT_EQ(EqualMsgBytes(*bytes, *Message {U1 {8}}.ToBytes()), false);
+    EXPECT_EQ(EqualMsgBytes(*bytes, *Message {I1 {7}}.ToBytes()), false);
+
+    const std::vector<std::byte> incomplete {
+        static_cast<std::byte>(0b101001'01), static_cast<std::byte>(2),
+        static_cast<std::byte>(7)};
+    EXPECT_EQ(EqualMsgBytes(incomplete, incomplete).error().first,
+              std::errc::message_size);
+    EXPECT_EQ(HashMsgBytes(incomplete).error().first, std::errc::message_size);
+    // Errors after the first difference are not reported.
+    EXPECT_EQ(EqualMsgBytes(*bytes, incomplete), false);
+}
+
+TEST(Secs2MessageWriter, Write) {
+    List inner;
+    inner.push_back(U4 {1, 2});
+    inner.push_back(Boolean {true, false});
+    List list;
+    list.push_back(ASCII {"LOT-1"});
+    list.push_back(std::move(inner));
+    list.push_back(F8 {0.5});
+    list.push_back(Binary {std::byte {0xAB}});
+    list.push_back(List {});
+    const Message msg {list};
+    const auto expected {msg.ToBytes()};
+    ASSERT_TRUE(expected.has_value());
+
+    const std::array<std::uint32_t, 2> u4 {1, 2};
+    const std::array bools {true, false};
+    const std::array binary {std::byte {0xAB}};
+    const auto write {[&](MessageWriter& writer) {
+        writer.BeginList(5)
+            .WriteAscii("LOT-1")
+            .BeginList(2)
+            .WriteU4(u4)
+            .WriteBoolean(bools)
+            .EndList()
+            .WriteF8(0.5)
+            .WriteBinary(binary)
+            .BeginList(0)
+            .EndList()
+            .EndList();
+    }};
+
+    std::vector prefix {std::byte {0xFF}};
+    MessageWriter buf_writer {prefix};
+    write(buf_writer);
+    EXPECT_EQ(buf_writer.Finish(), expected->size());
+    ASSERT_EQ(prefix.size(), expected->size() + 1);
+    EXPECT_TRUE(std::ranges::equal(std::span {prefix}.subspan(1), *expected));
+
+    std::vector<std::byte> sunk;
+    MessageWriter sink_writer {[&sunk](const std::span<const std::byte> bytes) {
+        sunk.insert(sunk.end(), bytes.begin(), bytes.end());
+    }};
+    write(sink_writer);
+    EXPECT_EQ(sink_writer.Finish(), expected->size());
+    EXPECT_EQ(sunk, *expected);
+
+    // Existing values can be embedded and messages can be written back-to-back.
+    std::vector<std::byte> bytes;
+    MessageWriter writer {bytes};
+    writer.BeginList(1).Write(msg.GetValue()).EndList().WriteI2(-1);
+    EXPECT_TRUE(writer.Finish().has_value());
+    List outer;
+    outer.push_back(msg.GetValue());
+    EXPECT_EQ(Message::BuildFromBytes(bytes)->first, Message {outer});
+    EXPECT_EQ(
+        Message::BuildFromBytes(std::span {bytes}.subspan(bytes.size() - 4))
+            ->first,
+        Message {I2 {-1}});
+}
+
+TEST(Secs2MessageWriter, WriteInvalidLists) {
+    std::vector bytes {std::byte {0xFF}};
+    {
+        MessageWriter writer {bytes};
+        writer.BeginList(1).WriteU1(1).WriteU1(2).EndList();
+        const auto size {writer.Finish()};
+        ASSERT_FALSE(size.has_value());
+        EXPECT_EQ(size.error().first, std::errc::invalid_argument);
+        EXPECT_EQ(bytes.size(), 1);
+    }
+    {
+        MessageWriter writer {bytes};
+        writer.BeginList(2).WriteU1(1).EndList();
+        EXPECT_EQ(writer.Finish().error().first, std::errc::invalid_argument);
+        EXPECT_EQ(bytes.size(), 1);
+    }
+    {
+        MessageWriter writer {bytes};
+        const std::string chars(Message::max_length + 1, 'a');
+        writer.WriteAscii(chars).WriteU1(1);
+        EXPECT_EQ(writer.Finish().error().first, std::errc::value_too_large);
+        EXPECT_EQ(bytes.size(), 1);
+    }
+    {
+        MessageWriter writer {bytes};
+        writer.WriteU1(1).EndList();
+        EXPECT_EQ(writer.Finish().error().first, std::errc::invalid_argument);
+        EXPECT_EQ(bytes.size(), 1);
+    }
+    {
+        // Lists that are not closed are reported but their bytes are kept.
+        MessageWriter writer {bytes};
+        writer.BeginList(1).BeginList(0).EndList();
+        EXPECT_EQ(writer.Finish().error().first, std::errc::invalid_argument);
+        EXPECT_EQ(bytes.size(), 5);
+    }
+}
+
+#if __has_include(<sys/mman.h>)
+//! The sizes of the file header and a record header of an archive.
+constexpr std::size_t file_header_size {8};
+constexpr std::size_t record_header_size {16};
+
+TEST(Secs2MessageArchive, AppendAndOpen) {
+    const auto path {std::filesystem::temp_directory_path()
+                     / std::format("secs2_archive_{}.s2ar", ::getpid())};
+    std::filesystem::remove(path);
+
+    List list;
+    list.push_back(U4 {1, 2});
+    list.push_back(ASCII {"archive"});
+    const std::vector msgs {Message {U1 {0}}, Message {list},
+                            Message {List {}}};
+    {
+        auto writer {ArchiveWriter::Open(path)};
+        ASSERT_TRUE(writer.has_value());
+        EXPECT_TRUE(writer->Append(msgs[0], {.tag = 1, .timestamp = 10})
+                        .has_value());
+        EXPECT_TRUE(writer->Append(msgs[1], {.tag = 2, .timestamp = 20})
+                        .has_value());
+    }
+    {
+        // Records are appended after the existing ones.
+        auto writer {ArchiveWriter::Open(path)};
+        ASSERT_TRUE(writer.has_value());
+        const auto bytes {msgs[2].ToBytes()};
+        EXPECT_TRUE(
+            writer->Append(*bytes, {.tag = 3, .timestamp = 30}).has_value());
+        EXPECT_EQ(writer->Append(std::span {*bytes}.first(1)).error().first,
+                  std::errc::message_size);
+        EXPECT_TRUE(writer->Flush().has_value());
+    }
+
+    const auto archive {MessageArchive::Open(path)};
+    ASSERT_TRUE(archive.has_value());
+    ASSERT_EQ(archive->GetCount(), msgs.size());
+    for (std::size_t i {0}; i != msgs.size(); ++i) {
+        const auto record {archive->GetRecord(i)};
+        const RecordMetadata meta {.tag = static_cast<std::uint32_t>(i + 1),
+                                   .timestamp = (i + 1) * 10};
+        EXPECT_EQ(record.meta, meta);
+        EXPECT_TRUE(std::ranges::equal(record.bytes, *msgs[i].ToBytes()));
+    }
+
+    // Records can be decoded concurrently.
+    ThreadPool pool {2};
+    std::vector<std::optional<Message>> decoded(archive->GetCount());
+    pool(archive->GetCount(), [&archive, &decoded](const std::size_t i) {
+        if (const auto view {archive->GetView(i)}; view.has_value()) {
+            decoded[i] = view->ToMessage();
+        }
+    });
+    for (std::size_t i {0}; i != msgs.size(); ++i) {
+        EXPECT_EQ(decoded[i], msgs[i]);
+    }
+
+    std::filesystem::remove(path);
+}
+
+TEST(Secs2MessageArchive, AppendAfterTornRecord) {
+    const auto path {std::filesystem::temp_directory_path()
+                     / std::format("secs2_torn_{}.s2ar", ::getpid())};
+    std::filesystem::remove(path);
+
+    const std::vector msgs {Message {U2 {1, 2}}, Message {ASCII {"torn"}},
+                            Message {Boolean {true}}};
+    {
+        auto writer {ArchiveWriter::Open(path)};
+        ASSERT_TRUE(writer.has_value());
+        EXPECT_TRUE(writer->Append(msgs[0], {.tag = 1}).has_value());
+        EXPECT_TRUE(writer->Append(msgs[1], {.tag = 2}).has_value());
+    }
+
+    // A crash leaves the second record without the end of its message.
+    const auto size {std::filesystem::file_size(path)};
+    std::filesystem::resize_file(path, size - 2);
+    {
+        const auto archive {MessageArchive::Open(path)};
+        ASSERT_TRUE(archive.has_value());
+        ASSERT_EQ(archive->GetCount(), 1);
+        EXPECT_TRUE(std::ranges::equal(archive->GetRecord(0).bytes,
+                                       *msgs[0].ToBytes()));
+        EXPECT_EQ(archive->GetTornSize(),
+                  record_header_size + msgs[1].ToBytes()->size() - 2);
+    }
+
+    {
+        // The torn record is discarded before appending.
+        auto writer {ArchiveWriter::Open(path)};
+        ASSERT_TRUE(writer.has_value());
+        EXPECT_TRUE(writer->Append(msgs[2], {.tag = 3}).has_value());
+    }
+
+    const auto archive {MessageArchive::Open(path)};
+    ASSERT_TRUE(archive.has_value());
+    EXPECT_EQ(archive->GetTornSize(), 0);
+    ASSERT_EQ(archive->GetCount(), 2);
+    EXPECT_EQ(archive->GetRecord(0).meta.tag, 1);
+    EXPECT_TRUE(
+        std::ranges::equal(archive->GetRecord(0).bytes, *msgs[0].ToBytes()));
+    EXPECT_EQ(archive->GetRecord(1).meta.tag, 3);
+    EXPECT_TRUE(
+        std::ranges::equal(archive->GetRecord(1).bytes, *msgs[2].ToBytes()));
+
+    // A crash during the first write leaves only part of the file header.
+    std::filesystem::resize_file(path, 3);
+    {
+        const auto torn {MessageArchive::Open(path)};
+        ASSERT_TRUE(torn.has_value());
+        EXPECT_EQ(torn->GetCount(), 0);
+        EXPECT_EQ(torn->GetTornSize(), 3);
+    }
+
+    {
+        auto writer {ArchiveWriter::Open(path)};
+        ASSERT_TRUE(writer.has_value());
+        EXPECT_TRUE(writer->Append(msgs[0], {.tag = 1}).has_value());
+    }
+
+    const auto recovered {MessageArchive::Open(path)};
+    ASSERT_TRUE(recovered.has_value());
+    EXPECT_EQ(recovered->GetTornSize(), 0);
+    ASSERT_EQ(recovered->GetCount(), 1);
+    EXPECT_TRUE(std::ranges::equal(recovered->GetRecord(0).bytes,
+                                   *msgs[0].ToBytes()));
+
+    std::filesystem::remove(path);
+}
+
+TEST(Secs2MessageArchive, OpenInvalidFiles) {
+    const auto path {std::filesystem::temp_directory_path()
+                     / std::format("secs2_invalid_{}.s2ar", ::getpid())};
+    std::filesystem::remove(path);
+    EXPECT_EQ(MessageArchive::Open(path).error().first,
+              std::errc::no_such_file_or_directory);
+
+    {
+        auto writer {ArchiveWriter::Open(path)};
+        ASSERT_TRUE(writer.has_value());
+        EXPECT_TRUE(writer->Append(Message {U1 {1, 2, 3}}).has_value());
+    }
+
+    // A record is cut off.
+    const auto size {std::filesystem::file_size(path)};
+    std::filesystem::resize_file(path, size - 1);
+    {
+        const auto archive {MessageArchive::Open(path)};
+        ASSERT_TRUE(archive.has_value());
+        EXPECT_EQ(archive->GetCount(), 0);
+        EXPECT_EQ(archive->GetTornSize(), size - 1 - file_header_size);
+    }
+
+    {
+        std::ofstream file {path, std::ios::binary | std::ios::trunc};
+        file << "S2";
+        file.put(0);
+    }
+
+    EXPECT_EQ(MessageArchive::Open(path).error().first,
+              std::errc::argument_out_of_domain);
+    EXPECT_EQ(ArchiveWriter::Open(path).error().first,
+              std::errc::argument_out_of_domain);
+
+    std::filesystem::remove(path);
+}
+#endif
+
+TEST(Secs2MessageView, BuildFromBytes) {
+    {
+        const auto view {MessageView::BuildFromBytes({})};
+        EXPECT_FALSE(view.has_value());
+        EXPECT_EQ(view.error().first, std::errc::message_size);
+    }
+    {
+        static_assert(static_cast<std::uint8_t>(Type::U2) == 0b101010);
+
+        const std::vector<std::byte> bytes {static_cast<std::byte>(0b101010'01),
+                                            static_cast<std::byte>(3),
+                                            static_cast<std::byte>(0),
+                                            static_cast<std::byte>(1),
+                                            static_cast<std::byte>(2)};
+        const auto view {MessageView::BuildFromBytes(bytes)};
+        EXPECT_FALSE(view.has_value());
+        EXPECT_EQ(view.error().first, std::errc::message_size);
+    }
+    {
+        static_assert(static_cast<std::uint8_t>(Type::List) == 0b000000);
+
+        const std::vector<std::byte> bytes {
+            static_cast<std::byte>(0b000000'01), static_cast<std::byte>(2),
+            static_cast<std::byte>(0b000000'00)};
+        const auto view {MessageView::BuildFromBytes(bytes)};
+        EXPECT_FALSE(view.has_value());
+        EXPECT_EQ(view.error().first, std::errc::argument_out_of_domain);
+    }
+    {
+        List list;
+        list.push_back(U1 {1, 2});
+        list.push_back(list);
+        list.push_back(ASCII {"msg"});
+
+        auto bytes {
+            Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+        const auto size {bytes.size()};
+        bytes.insert(bytes.end(), 10, static_cast<std::byte>(0xFF));
+        const auto view {MessageView::BuildFromBytes(bytes)};
+        EXPECT_TRUE(view.has_value());
+        EXPECT_EQ(view->GetByteSize(), size);
+        EXPECT_EQ(view->ToMessage(), Message {list});
+    }
+}
+
+TEST(Secs2MessageView, GetElem) {
+    const U2 nums {1, 0x0203};
+    const ASCII str {"msg"};
+    const Binary bins {static_cast<std::byte>(1), static_cast<std::byte>(2)};
+
+    List sub_list;
+    sub_list.push_back(bins);
+    sub_list.push_back(Boolean {true, false});
+
+    List list;
+    list.push_back(nums);
+    list.push_back(sub_list);
+    list.push_back(str);
+
+    const auto bytes {
+        Message {list}.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto view {MessageView::BuildFromBytes(bytes)};
+    ASSERT_TRUE(view.has_value());
+    EXPECT_EQ(view->GetType(), Type::List);
+    EXPECT_EQ(view->GetSize(), list.size());
+
+    const auto& root {view->GetRoot()};
+    EXPECT_EQ(std::ranges::distance(root), list.size());
+    EXPECT_FALSE(root.GetElem(list.size()).has_value());
+    EXPECT_FALSE(root.GetElemValue<U2>(0).has_value());
+
+    const auto first {root.GetElem(0)};
+    ASSERT_TRUE(first.has_value());
+    EXPECT_EQ(first->GetType(), Type::U2);
+    EXPECT_EQ(first->GetSize(), nums.size());
+    EXPECT_EQ(first->GetElemValue<U2>(0), 1);
+    EXPECT_EQ(first->GetElemValue<U2>(1), 0x0203);
+    EXPECT_FALSE(first->GetElemValue<U2>(2).has_value());
+    EXPECT_FALSE(first->GetElemValue<I2>(0).has_value());
+    EXPECT_EQ(first->GetValue<U2>(), nums);
+    EXPECT_FALSE(first->GetElem(0).has_value());
+    EXPECT_EQ(first->begin(), first->end());
+
+    const auto second {root.GetElem(1)};
+    ASSERT_TRUE(second.has_value());
+    EXPECT_EQ(second->GetType(), Type::List);
+    EXPECT_EQ(second->GetValue<List>(), sub_list);
+    EXPECT_EQ(second->GetElem(0)->GetBinary()->size(), bins.size());
+    EXPECT_EQ(second->GetElem(1)->GetElemValue<Boolean>(0), true);
+    EXPECT_EQ(second->GetElem(1)->GetElemValue<Boolean>(1), false);
+
+    const auto third {root.GetElem(2)};
+    ASSERT_TRUE(third.has_value());
+    EXPECT_EQ(third->GetASCII(), str);
+    EXPECT_FALSE(third->GetBinary().has_value());
+    EXPECT_EQ(third->ToMessage(), Message {str});
+
+    std::vector<Type> types;
+    for (const auto& elem : root) {
+        types.push_back(elem.GetType());
+    }
+    EXPECT_EQ(types, (std::vector {Type::U2, Type::List, Type::ASCII}));
+}
+
+TEST(Secs2LazyList, Next) {
+    List nested;
+    nested.push_back(ASCII {"nested"});
+    List list;
+    list.push_back(U1 {1});
+    list.push_back(nested);
+    list.push_back(F4 {1.5F});
+    const auto bytes {Message {list}.ToBytes()};
+    ASSERT_TRUE(bytes.has_value());
+
+    auto lazy {LazyList::BuildFromBytes(*bytes)};
+    ASSERT_TRUE(lazy.has_value());
+    EXPECT_EQ(lazy->GetSize(), list.size());
+
+    List elems;
+    for (auto& elem : *lazy) {
+        ASSERT_TRUE(elem.has_value());
+        elems.push_back(std::move(*elem));
+    }
+
+    EXPECT_EQ(elems, list);
+    EXPECT_EQ(lazy->GetByteSize(), bytes->size());
+    EXPECT_FALSE(lazy->Next().has_value());
+
+    // Iteration can stop without reading the remaining elements.
+    auto partial {LazyList::BuildFromBytes(*bytes)};
+    ASSERT_TRUE(partial.has_value());
+    const auto first {partial->Next()};
+    ASSERT_TRUE(first.has_value() && first->has_value());
+    EXPECT_EQ(**first, ListElem {U1 {1}});
+    EXPECT_EQ(partial->GetByteSize(), 2 + 3);
+}
+
+TEST(Secs2LazyList, NextInvalidElems) {
+    EXPECT_EQ(LazyList::BuildFromBytes(*Message {U1 {1}}.ToBytes())
+                  .error()
+                  .first,
+              std::errc::invalid_argument);
+
+    List list;
+    list.push_back(U1 {1});
+    list.push_back(U2 {2});
+    const auto bytes {Message {list}.ToBytes()};
+    ASSERT_TRUE(bytes.has_value());
+
+    // The second element is cut off.
+    auto lazy {LazyList::BuildFromBytes(std::span {*bytes}.first(
+        bytes->size() - 1))};
+    ASSERT_TRUE(lazy.has_value());
+    std::vector<LazyList::Elem> elems;
+    for (auto& elem : *lazy) {
+        elems.push_back(std::move(elem));
+    }
+
+    ASSERT_EQ(elems.size(), 2);
+    EXPECT_EQ(elems[0], ListElem {U1 {1}});
+    ASSERT_FALSE(elems[1].has_value());
+    EXPECT_EQ(elems[1].error().first, std::errc::message_size);
+
+    EXPECT_EQ(LazyList::BuildFromBytes(*bytes, {.max_depth = 0}).error().first,
+              std::errc::value_too_large);
+}
+
+#ifdef SECS2_INSTRUMENTATION
+TEST(Secs2Instrument, Metrics) {
+    instrument::Metrics metrics;
+    const auto prev_hooks {instrument::SetHooks(&metrics)};
+
+    List list;
+    list.push_back(U4 {1, 2});
+    list.push_back(List {});
+    const Message msg {list};
+    const auto bytes {msg.ToBytes()};
+    ASSERT_TRUE(bytes.has_value());
+    EXPECT_TRUE(BuildMsgFromBytes(*bytes).has_value());
+    EXPECT_FALSE(BuildMsgFromBytes(std::span {*bytes}.first(1)).has_value());
+    // A `U4` item with 3 bytes.
+    const std::array unaligned {std::byte {0xB1}, std::byte {3}, std::byte {0},
+                                std::byte {0}, std::byte {0}};
+    EXPECT_FALSE(BuildMsgFromBytes(unaligned).has_value());
+    EXPECT_FALSE(msg.ToSml().empty());
+    EXPECT_EQ(instrument::SetHooks(prev_hooks), &metrics);
+
+    EXPECT_EQ(metrics.GetEncoded(Type::U4).count, 1);
+    EXPECT_EQ(metrics.GetEncoded(Type::U4).byte_size, 2 + 8);
+    EXPECT_EQ(metrics.GetEncoded(Type::List).count, 2);
+    EXPECT_EQ(metrics.GetEncoded(Type::List).byte_size, bytes->size() + 2);
+    EXPECT_EQ(metrics.GetDecoded(Type::U4).count, 1);
+    EXPECT_EQ(metrics.GetDecoded(Type::List).count, 2);
+    EXPECT_EQ(metrics.GetDecodeAllocs(Type::U4).byte_size, 8);
+    EXPECT_EQ(metrics.GetMaxEncodeDepth(), 1);
+    EXPECT_EQ(metrics.GetMaxDecodeDepth(), 1);
+
+    EXPECT_EQ(metrics.GetLatency(instrument::Operation::ToBytes).count, 1);
+    EXPECT_EQ(metrics.GetLatency(instrument::Operation::BuildFromBytes).count,
+              3);
+    EXPECT_EQ(metrics.GetLatency(instrument::Operation::ToSml).count, 1);
+
+    // Errors sharing a portable condition are counted separately.
+    EXPECT_EQ(metrics.GetErrorCount(instrument::Operation::BuildFromBytes,
+                                    instrument::ErrorKind::IncompleteData),
+              1);
+    EXPECT_EQ(metrics.GetErrorCount(instrument::Operation::BuildFromBytes,
+                                    instrument::ErrorKind::UnalignedLength),
+              1);
+
+    const auto text {metrics.ToPrometheus()};
+    EXPECT_TRUE(text.contains("secs2_encoded_elements_total{type=\"U4\"} 1\n"));
+    EXPECT_TRUE(text.contains(
+        "secs2_operation_duration_seconds_bucket{op=\"BuildFromBytes\","
+        "le=\"+Inf\"} 3\n"));
+    EXPECT_TRUE(text.contains(
+        "secs2_operation_duration_seconds_count{op=\"BuildFromBytes\"} 3\n"));
+    for (const auto kind : {instrument::ErrorKind::IncompleteData,
+                            instrument::ErrorKind::UnalignedLength}) {
+        EXPECT_TRUE(text.contains(
+            std::format("secs2_operation_errors_total{{op=\"BuildFromBytes\","
+                        "kind=\"{}\"}} 1\n",
+                        instrument::to_string(kind))));
+    }
+
+    metrics.Reset();
+    EXPECT_EQ(metrics.GetEncoded(Type::U4).count, 0);
+    EXPECT_EQ(metrics.GetLatency(instrument::Operation::ToBytes).count, 0);
+}
+#endif
+
+TEST(Secs2MessageDecoder, Feed) {
+    List sub_list;
+    sub_list.push_back(U4 {1, 2, 3});
+    sub_list.push_back(List {});
+    sub_list.push_back(ASCII {});
+
+    List list;
+    list.push_back(U2(300, 0x0102));
+    list.push_back(sub_list);
+    list.push_back(ASCII {"msg"});
+    list.push_back(Boolean {true, false});
+    const Message target {list};
+    const auto bytes {target.ToBytes().value_or(std::vector<std::byte> {})};
+
+    for (const std::size_t chunk_size : {1, 2, 3, 7, 64, 1000}) {
+        MessageDecoder decoder;
+        std::size_t offset {0};
+        while (!decoder.HasMessage()) {
+            ASSERT_LT(offset, bytes.size());
+            const auto chunk {std::span {bytes}.subspan(
+                offset, std::min(chunk_size, bytes.size() - offset))};
+            const auto size {decoder.Feed(chunk)};
+            ASSERT_TRUE(size.has_value());
+            EXPECT_EQ(*size, chunk.size());
+            offset += *size;
+        }
+
+        EXPECT_EQ(offset, bytes.size());
+        const auto loaded {decoder.TakeMessage()};
+        ASSERT_TRUE(loaded.has_value());
+        EXPECT_EQ(loaded->first, target);
+        EXPECT_EQ(loaded->second, bytes.size());
+        EXPECT_FALSE(decoder.HasMessage());
+        EXPECT_FALSE(decoder.TakeMessage().has_value());
+    }
+}
+
+TEST(Secs2MessageDecoder, FeedMultipleMessages) {
+    const Message first {U1 {1, 2}};
+    const Message second {ASCII {"msg"}};
+    auto bytes {first.ToBytes().value_or(std::vector<std::byte> {})};
+    const auto first_size {bytes.size()};
+    const auto second_bytes {
+        second.ToBytes().value_or(std::vector<std::byte> {})};
+    bytes.insert(bytes.end(), second_bytes.begin(), second_bytes.end());
+
+    MessageDecoder decoder;
+    const auto size {decoder.Feed(bytes)};
+    ASSERT_TRUE(size.has_value());
+    EXPECT_EQ(*size, first_size);
+    EXPECT_EQ(decoder.Feed(std::span {bytes}.subspan(*size)), 0);
+    EXPECT_EQ(decoder.TakeMessage()->first, first);
+
+    EXPECT_EQ(decoder.Feed(std::span {bytes}.subspan(*size)),
+              second_bytes.size());
+    EXPECT_EQ(decoder.TakeMessage()->first, second);
+}
+
+TEST(Secs2MessageDecoder, FeedInvalidBytes) {
+    {
+        static_assert(static_cast<std::uint8_t>(Type::U2) == 0b101010);
+
+        MessageDecoder decoder;
+        const std::vector<std::byte> bytes {static_cast<std::byte>(0b101010'01),
+                                            static_cast<std::byte>(4),
+                                            static_cast<std::byte>(0)};
+        EXPECT_EQ(decoder.Feed(bytes), bytes.size());
+        EXPECT_FALSE(decoder.HasMessage());
+        EXPECT_FALSE(decoder.HasError());
+        EXPECT_EQ(decoder.GetByteSize(), bytes.size());
+    }
+    {
+        static_assert(static_cast<std::uint8_t>(Type::U2) == 0b101010);
+
+        MessageDecoder decoder;
+        const std::vector<std::byte> bytes {static_cast<std::byte>(0b101010'01),
+                                            static_cast<std::byte>(3)};
+        const auto size {decoder.Feed(bytes)};
+        EXPECT_FALSE(size.has_value());
+        EXPECT_EQ(size.error().first, std::errc::message_size);
+    }
+    {
+        static_assert(static_cast<std::uint8_t>(Type::Unknown) == 0b111111);
+
+        MessageDecoder decoder;
+        const std::vector<std::byte> bytes {static_cast<std::byte>(0b111111'01),
+                                            static_cast<std::byte>(0)};
+        const auto size {decoder.Feed(bytes)};
+        EXPECT_FALSE(size.has_value());
+        EXPECT_EQ(size.error().first, std::errc::argument_out_of_domain);
+        EXPECT_TRUE(decoder.HasError());
+        EXPECT_FALSE(decoder.Feed(bytes).has_value());
+
+        decoder.Reset();
+        EXPECT_FALSE(decoder.HasError());
+        const auto msg_bytes {
+            Message {U1 {1}}.ToBytes().value_or(std::vector<std::byte> {})};
+        EXPECT_EQ(decoder.Feed(msg_bytes), msg_bytes.size());
+        EXPECT_EQ(decoder.TakeMessage()->first, Message {U1 {1}});
+    }
+}